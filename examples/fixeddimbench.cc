@@ -0,0 +1,77 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Iterations per second of the dynamic CMAStrategy and of FixedCMAStrategy,
+ * on a cheap ellipsoid, for a few small dimensions.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc elli = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += std::pow(1e3,static_cast<double>(i)/std::max(1,N-1)) * x[i]*x[i];
+  return val;
+};
+
+template <class TStrategy>
+double iter_per_sec(const int &dim)
+{
+  long niter = 0;
+  double elapsed = 0.0;
+  for (int run=0;elapsed<1.0;run++)
+    {
+      std::vector<double> x0(dim,1.0);
+      CMAParameters<> cmaparams(x0,0.5,-1,run+1);
+      cmaparams.set_quiet(true);
+      cmaparams.set_max_iter(2000);
+      ESOptimizer<TStrategy,CMAParameters<>> optim(elli,cmaparams);
+      std::chrono::time_point<std::chrono::steady_clock> tstart = std::chrono::steady_clock::now();
+      optim.optimize();
+      elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now()-tstart).count();
+      niter += optim.get_solutions().niter();
+    }
+  return niter / elapsed;
+}
+
+template <int Dim>
+void bench()
+{
+  double dyn = iter_per_sec<CMAStrategy<CovarianceUpdate>>(Dim);
+  double fix = iter_per_sec<FixedCMAStrategy<Dim>>(Dim);
+  std::cout << "dim=" << Dim << " / dynamic=" << dyn << " it/s / fixed=" << fix << " it/s / speedup=" << fix/dyn << std::endl;
+}
+
+int main()
+{
+  bench<2>();
+  bench<5>();
+  bench<10>();
+  bench<20>();
+  return 0;
+}
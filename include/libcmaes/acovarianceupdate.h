@@ -42,6 +42,24 @@ namespace libcmaes
     static void update(const CMAParameters<TGenoPheno> &parameters,
 		       Eigen::EigenMultivariateNormal<double> &esolver,
 		       CMASolutions &solutions);
+
+    /**
+     * \brief largest eigenvalue of ZZ^T, obtained from the smaller of ZZ^T and Z^TZ
+     *        since both share their non-zero eigenvalues. With Z of size n x mu
+     *        this costs O(n mu^2 + mu^3) instead of an n x n eigendecomposition.
+     * @param zs matrix Z
+     * @return largest eigenvalue of ZZ^T
+     */
+    static double max_eigenvalue(const dMat &zs);
+
+    /**
+     * \brief largest eigenvalue of ZZ^T, through the Gram matrix and eigensolver
+     *        of a workspace, so that repeated calls do not allocate.
+     * @param zs matrix Z
+     * @param ws workspace
+     * @return largest eigenvalue of ZZ^T
+     */
+    static double max_eigenvalue(const dMat &zs, CMAWorkspace &ws);
   };
   
 }
@@ -0,0 +1,152 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASYNCCMASTRATEGY_H
+#define ASYNCCMASTRATEGY_H
+
+#include <libcmaes/cmastrategy.h>
+
+namespace libcmaes
+{
+  /**
+   * \brief Asynchronous steady-state flavor of CMA-ES, for objective functions
+   *        whose evaluation time varies among candidates.
+   *        Candidates are issued one at a time to a set of workers as they free up,
+   *        and their results are collected as they complete, so that no worker
+   *        waits for the slowest evaluation of a generation. The distribution is
+   *        updated, with the regular tell(), as soon as lambda results are in.
+   *        Results from a distribution older than the current one are rejected,
+   *        since the update is computed against the current mean and step-size.
+   *        A positive max_age keeps results up to max_age updates old instead,
+   *        at the price of a bias of the update toward the older distributions.
+   *        To keep rejections low, a distribution issues a bounded number of
+   *        candidates beyond lambda, see set_overdraw().
+   *        Gradient injection, two-point adaptation, uncertainty handling and elitism
+   *        require generations, and run the regular synchronous loop instead.
+   */
+  template <class TCovarianceUpdate, class TGenoPheno>
+    class CMAES_EXPORT AsyncCMAStrategy : public CMAStrategy<TCovarianceUpdate, TGenoPheno>
+  {
+  public:
+    /**
+     * \brief constructor.
+     * @param func objective function to minimize
+     * @param parameters stochastic search parameters, the number of workers is that
+     *        of the parallel evaluations, see Parameters::set_feval_threads
+     */
+    AsyncCMAStrategy(FitFunc &func,
+		     CMAParameters<TGenoPheno> &parameters);
+
+    /**
+     * \brief constructor for starting from an existing solution.
+     * @param func objective function to minimize
+     * @param parameters stochastic search parameters
+     * @param solutions solution object to start from
+     */
+    AsyncCMAStrategy(FitFunc &func,
+		     CMAParameters<TGenoPheno> &parameters,
+		     const CMASolutions &solutions);
+
+    ~AsyncCMAStrategy();
+
+    /**
+     * \brief Finds the minimum of the objective function, with asynchronous
+     *        evaluations, until one of the termination criteria triggers.
+     * @return success or error code, as defined in opti_err.h
+     * Note: the termination criteria code is held by _solutions._run_status
+     */
+    int optimize();
+
+    /**
+     * \brief whether the search runs asynchronously with the current parameters.
+     * @return true if asynchronous
+     */
+    bool asynchronous() const;
+
+    /**
+     * \brief sets the maximum age of a result, in number of updates of the
+     *        distribution since the candidate was drawn. Older results are rejected.
+     *        Results that are kept are told against the current mean and step-size,
+     *        which biases the update for any age above 0.
+     * @param a maximum age, 0 by default
+     */
+    void set_max_age(const int &a) { _max_age = a; }
+
+    /**
+     * \brief returns the maximum age of a result.
+     * @return maximum age
+     */
+    int get_max_age() const { return _max_age; }
+
+    /**
+     * \brief sets the number of candidates that are issued to workers ahead of
+     *        the results, so that workers never wait for an update.
+     * @param o number of outstanding candidates, 0 for twice the number of workers
+     */
+    void set_outstanding(const int &o) { _outstanding = o; }
+
+    /**
+     * \brief sets the number of candidates a distribution issues beyond lambda,
+     *        so that workers keep busy while its last results come in. Those
+     *        still in flight at the update are rejected when max_age is 0.
+     * @param o number of extra candidates, -1 for automatic, i.e. lambda/5 and
+     *        at least 1 when max_age is 0, unbounded otherwise
+     */
+    void set_overdraw(const int &o) { _overdraw = o; }
+
+    /**
+     * \brief returns the number of workers of the last run.
+     * @return number of workers
+     */
+    int nworkers() const { return _nworkers; }
+
+    /**
+     * \brief returns the fraction of the last run's wall time that the workers
+     *        spent evaluating candidates whose results were used in an update.
+     * @return worker utilization, in [0,1]
+     */
+    double utilization() const { return _utilization; }
+
+    /**
+     * \brief returns the fraction of the last run's wall time that the workers
+     *        spent evaluating the objective function, rejected results included.
+     * @return worker busy time, in [0,1]
+     */
+    double busy_utilization() const { return _busy_utilization; }
+
+    /**
+     * \brief returns the number of results that were rejected as too old.
+     * @return number of rejected results
+     */
+    int rejected() const { return _rejected; }
+
+  protected:
+    int _max_age = 0; /**< maximum number of updates between a draw and the use of its result. */
+    int _outstanding = 0; /**< number of candidates issued ahead of results, 0 for automatic. */
+    int _overdraw = -1; /**< number of candidates issued per distribution beyond lambda, -1 for automatic. */
+    int _nworkers = 0; /**< number of workers of the last run. */
+    double _utilization = 0.0; /**< fraction of wall time the workers spent on results that were used, last run. */
+    double _busy_utilization = 0.0; /**< fraction of wall time the workers spent evaluating, last run. */
+    int _rejected = 0; /**< number of results rejected as too old, last run. */
+  };
+}
+
+#endif
@@ -83,8 +83,12 @@ namespace libcmaes
      */
     int optimize()
     {
+      if (this->compressed_population()) // candidates are evaluated by chunks, when asked.
+	return optimize([](const dMat&, const dMat&){},
+			population_askfunc(std::bind(&BIPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::ask_eval_chunks,this)),
+			std::bind(&BIPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::tell,this));
       return optimize(std::bind(&BIPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::eval,this,std::placeholders::_1,std::placeholders::_2),
-		      std::bind(&BIPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::ask,this),
+		      population_askfunc(std::bind(&BIPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::ask,this)),
 		      std::bind(&BIPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::tell,this));
     }
     
@@ -24,11 +24,16 @@
 
 #include <libcmaes/eo_matrix.h>
 #include <libcmaes/cmaparameters.h>
+#include <new>
 
 namespace libcmaes
 {
   /**
    * \brief candidate solution point, in function parameter space.
+   *        A candidate either owns its parameter vector, or is a lightweight view
+   *        onto a column of the population matrix held by CMASolutions.
+   *        Copies always own their vector, so that histories remain valid, while
+   *        moves carry the view along, so that ranking does not touch parameter vectors.
    */
   class Candidate
   {
@@ -37,7 +42,7 @@ namespace libcmaes
      * \brief empty constructor.
      */
   Candidate():
-    _fvalue(std::numeric_limits<double>::quiet_NaN()) {}
+    _fvalue(std::numeric_limits<double>::quiet_NaN()),_x(nullptr,0) {}
     
     /**
      * \brief constructor.
@@ -46,10 +51,65 @@ namespace libcmaes
      */
   Candidate(const double &fvalue,
 	    const dVec &x)
-    :_fvalue(fvalue),_x(x)
+    :_fvalue(fvalue),_xv(x),_x(_xv.data(),_xv.size())
     {}
 
-  ~Candidate() {}
+  Candidate(const Candidate &c)
+    :_fvalue(c._fvalue),_xv(c.x()),_x(_xv.data(),_xv.size()),_id(c._id),_r(c._r)
+    {}
+
+  Candidate(Candidate &&c)
+    :_fvalue(c._fvalue),_xv(std::move(c._xv)),_x(nullptr,0),_id(c._id),_r(c._r),_view(c._view)
+    {
+      if (_view)
+	new (&_x) Eigen::Map<dVec>(c._x.data(),c._x.size());
+      else new (&_x) Eigen::Map<dVec>(_xv.data(),_xv.size());
+      c.own_x();
+    }
+
+  Candidate& operator=(const Candidate &c)
+    {
+      if (this != &c)
+	{
+	  _fvalue = c._fvalue;
+	  _xv = c.x();
+	  own_x();
+	  _id = c._id;
+	  _r = c._r;
+	}
+      return *this;
+    }
+
+  Candidate& operator=(Candidate &&c)
+    {
+      if (this != &c)
+	{
+	  _fvalue = c._fvalue;
+	  _xv.swap(c._xv); // the storage given away is reused by c, if any.
+	  if (c._view)
+	    {
+	      new (&_x) Eigen::Map<dVec>(c._x.data(),c._x.size());
+	      _view = true;
+	    }
+	  else own_x();
+	  c.own_x();
+	  _id = c._id;
+	  _r = c._r;
+	}
+      return *this;
+    }
+
+  /**
+   * \brief makes this candidate a view onto external storage, typically
+   *        a column of the population matrix. The storage must outlive the view.
+   * @param x pointer to the parameter vector storage
+   * @param n parameter vector size
+   */
+  inline void bind_x(double *x, const int &n)
+  {
+    new (&_x) Eigen::Map<dVec>(x,n);
+    _view = true;
+  }
 
   /**
    * \brief set candidate's function value.
@@ -67,26 +127,52 @@ namespace libcmaes
    * \brief sets parameter vector of this candidate.
    * @param x parameter vector
    */
-  inline void set_x(const dVec &x) { _x = x; }
+  inline void set_x(const dVec &x) { assign_x(x); }
+
+  /**
+   * \brief sets parameter vector of this candidate from an Eigen expression,
+   *        e.g. a column of the candidates matrix, without a temporary. The
+   *        vector is written in place when the size does not change.
+   * @param x parameter vector expression
+   */
+  template<class Derived>
+    inline void set_x(const Eigen::MatrixBase<Derived> &x) { assign_x(x); }
   
   /**
    * \brief get parameter vector of this candidate in Eigen vector format.
    * @return parameter vector in Eigen vector format
    */
-  inline dVec get_x_dvec() const { return _x; }
+  inline dVec get_x_dvec() const { return x(); }
 
   /**
    * \brief get reference parameter vector of this candidate in Eigen vector format.
+   *        A view first copies its parameter vector, and owns it from then on.
    * @return reference to parameter vector in Eigen vector format
+   * @see get_x_map
    */
-  inline dVec& get_x_dvec_ref() { return _x; }
+  inline dVec& get_x_dvec_ref()
+  {
+    if (_view)
+      {
+	_xv = _x;
+	own_x();
+      }
+    return _xv;
+  }
+
+  /**
+   * \brief get parameter vector of this candidate, without a copy, as a map that
+   *        may point to a column of the population matrix.
+   * @return reference to the parameter vector map
+   */
+  inline const Eigen::Map<dVec>& get_x_map() const { return x(); }
   
   /**
    * \brief get parameter vector pointer of this candidate as array. 
    *        DO NOT USE from temporary candidate object.
    * @return parameter vector pointer
    */
-  inline const double* get_x_ptr() const { return _x.data(); }
+  inline const double* get_x_ptr() const { return x().data(); }
   
   /**
    * \brief get parameter vector copy for this candidate.
@@ -94,16 +180,16 @@ namespace libcmaes
    */
   inline std::vector<double> get_x() const
   {
-    std::vector<double> x;
-    x.assign(_x.data(),_x.data()+_x.size());
-    return x;
+    std::vector<double> xc;
+    xc.assign(x().data(),x().data()+x().size());
+    return xc;
   }
 
   /**
    * \brief get x vector size
    * @return x vector size
    */
-  inline unsigned int get_x_size() const { return _x.size(); }
+  inline unsigned int get_x_size() const { return x().size(); }
   
   /**
    * \brief get pheno transform of parameter vector of this candidate in Eigen vector format.
@@ -112,7 +198,7 @@ namespace libcmaes
   template<class TGenoPheno>
     dVec get_x_pheno_dvec(const CMAParameters<TGenoPheno> &p) const
     {
-      dVec gx = p.get_gp().pheno(_x);
+      dVec gx = p.get_gp().pheno(get_x_dvec());
       return gx;
     }
   
@@ -140,11 +226,52 @@ namespace libcmaes
    */
   inline int get_rank() const { return _r; }
 
+  /**
+   * \brief whether this candidate is a view onto external storage.
+   * @return true if the parameter vector is not owned by the candidate
+   */
+  inline bool is_view() const { return _view; }
+
   protected:
+  /**
+   * \brief points the parameter vector at the candidate's own storage.
+   */
+  inline void own_x()
+  {
+    new (&_x) Eigen::Map<dVec>(_xv.data(),_xv.size());
+    _view = false;
+  }
+
+  /**
+   * \brief parameter vector, pointed back at the candidate's own storage in case
+   *        it was reallocated through get_x_dvec_ref.
+   * @return parameter vector map
+   */
+  inline const Eigen::Map<dVec>& x() const
+  {
+    if (!_view && (_x.data() != _xv.data() || _x.size() != _xv.size()))
+      new (&_x) Eigen::Map<dVec>(const_cast<double*>(_xv.data()),_xv.size());
+    return _x;
+  }
+
+  template<class Derived>
+    inline void assign_x(const Eigen::MatrixBase<Derived> &x)
+    {
+      if (this->x().size() == x.size())
+	_x = x;
+      else
+	{
+	  _xv = x;
+	  own_x();
+	}
+    }
+  
    double _fvalue; /**< function value. */
-   dVec _x; /**< function parameter vector. */
+   dVec _xv; /**< owned parameter vector storage, unused by views. */
+   mutable Eigen::Map<dVec> _x; /**< function parameter vector, either _xv or external storage. */
    int _id = -1; /**< candidate id, used for identification after ranking, when needed. */
    int _r = -1; /**< candidate rank. */
+   bool _view = false; /**< whether _x points to external storage. */
   };
 
   class CMAES_EXPORT RankedCandidate : public Candidate
@@ -155,7 +282,6 @@ namespace libcmaes
 		    const int &idx)
       :Candidate(c.get_fvalue(),dVec()),_idx(idx),_fvalue_mut(fvalue_mut)
     {}
-    ~RankedCandidate() {}
 
     int _idx = -1;
     double _fvalue_mut;
@@ -0,0 +1,73 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHOLESKYCOVARIANCEUPDATE_H
+#define CHOLESKYCOVARIANCEUPDATE_H
+
+#include <libcmaes/cmaparameters.h>
+#include <libcmaes/cmasolutions.h>
+#include <libcmaes/eigenmvn.h>
+
+namespace libcmaes
+{
+
+  /**
+   * \brief Cholesky-CMA update, that maintains a factor A of the covariance
+   *        matrix C=AA^T along with its inverse, through a series of rank-one
+   *        updates in O(mu n^2). Sampling and the step-size path use A and A^-1
+   *        directly, so that no eigendecomposition is required for sampling.
+   *        The spectrum of C, read by termination criteria, is obtained from the
+   *        singular values of A, and refreshed at the pace of lazy updates.
+   *        This implementation closely follows:
+   *        T. Suttorp, N. Hansen, C. Igel, "Efficient covariance matrix update for
+   *        variable metric evolution strategies", Machine Learning 75, 2009.
+   */
+  class CMAES_EXPORT CholeskyCovarianceUpdate
+  {
+  public:
+    /**
+     * \brief update the covariance matrix factors.
+     * @param parameters current set of parameters
+     * @param esolver Eigen eigenvalue solver (unused)
+     * @param solutions currrent set of solutions.
+     */
+    template <class TGenoPheno>
+    static void update(const CMAParameters<TGenoPheno> &parameters,
+		       Eigen::EigenMultivariateNormal<double> &esolver,
+		       CMASolutions &solutions);
+
+    /**
+     * \brief rank-one update of factor A and of its inverse, such that
+     *        A'A'^T = AA^T + beta vv^T.
+     * @param beta rank-one update coefficient
+     * @param v update vector
+     * @param A covariance factor
+     * @param Ainv inverse of the covariance factor
+     */
+    static void rank_one_update(const double &beta,
+				const dVec &v,
+				dMat &A,
+				dMat &Ainv);
+  };
+  
+}
+
+#endif
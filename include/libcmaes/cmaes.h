@@ -26,6 +26,12 @@
 #include <libcmaes/cmastrategy.h>
 #include <libcmaes/ipopcmastrategy.h>
 #include <libcmaes/bipopcmastrategy.h>
+#include <libcmaes/asynccmastrategy.h>
+#include <libcmaes/optimizergroup.h>
+#include <libcmaes/lockstepcma.h>
+#include <libcmaes/fixedcmastrategy.h>
+#include <type_traits>
+#include <utility>
 
 namespace cma = libcmaes;
 
@@ -362,10 +368,163 @@ namespace libcmaes
 	  bipop.optimize();
 	  return bipop.get_solutions();
 	}
+	case CHOL_CMAES:
+	{
+	  if (!parameters.is_chol())
+	    parameters.set_chol();
+	  ESOptimizer<CMAStrategy<CholeskyCovarianceUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> cholcma(func,parameters);
+	  if (gfunc != nullptr)
+	    cholcma.set_gradient_func(gfunc);
+	  cholcma.set_progress_func(pfunc);
+	  cholcma.set_plot_func(pffunc);
+	  cholcma.optimize();
+	  return cholcma.get_solutions();
+	}
+	case CHOL_IPOP_CMAES:
+	{
+	  if (!parameters.is_chol())
+	    parameters.set_chol();
+	  ESOptimizer<IPOPCMAStrategy<CholeskyCovarianceUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> ipop(func,parameters);
+	  if (gfunc != nullptr)
+	    ipop.set_gradient_func(gfunc);
+	  ipop.set_progress_func(pfunc);
+	  ipop.set_plot_func(pffunc);
+	  ipop.optimize();
+	  return ipop.get_solutions();
+	}
+	case CHOL_BIPOP_CMAES:
+	{
+	  if (!parameters.is_chol())
+	    parameters.set_chol();
+	  ESOptimizer<BIPOPCMAStrategy<CholeskyCovarianceUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> bipop(func,parameters);
+	  if (gfunc != nullptr)
+	    bipop.set_gradient_func(gfunc);
+	  bipop.set_progress_func(pfunc);
+	  bipop.set_plot_func(pffunc);
+	  bipop.optimize();
+	  return bipop.get_solutions();
+	}
+	case LM_CMAES:
+	{
+	  if (!parameters.is_lm())
+	    parameters.set_lm();
+	  ESOptimizer<CMAStrategy<LMCMAUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> lmcma(func,parameters);
+	  if (gfunc != nullptr)
+	    lmcma.set_gradient_func(gfunc);
+	  lmcma.set_progress_func(pfunc);
+	  lmcma.set_plot_func(pffunc);
+	  lmcma.optimize();
+	  return lmcma.get_solutions();
+	}
+	case LM_IPOP_CMAES:
+	{
+	  if (!parameters.is_lm())
+	    parameters.set_lm();
+	  ESOptimizer<IPOPCMAStrategy<LMCMAUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> ipop(func,parameters);
+	  if (gfunc != nullptr)
+	    ipop.set_gradient_func(gfunc);
+	  ipop.set_progress_func(pfunc);
+	  ipop.set_plot_func(pffunc);
+	  ipop.optimize();
+	  return ipop.get_solutions();
+	}
+	case LM_BIPOP_CMAES:
+	{
+	  if (!parameters.is_lm())
+	    parameters.set_lm();
+	  ESOptimizer<BIPOPCMAStrategy<LMCMAUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> bipop(func,parameters);
+	  if (gfunc != nullptr)
+	    bipop.set_gradient_func(gfunc);
+	  bipop.set_progress_func(pfunc);
+	  bipop.set_plot_func(pffunc);
+	  bipop.optimize();
+	  return bipop.get_solutions();
+	}
+	case VKD_CMAES:
+	{
+	  if (!parameters.is_vkd())
+	    parameters.set_vkd();
+	  ESOptimizer<CMAStrategy<VkDCMAUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> vkdcma(func,parameters);
+	  if (gfunc != nullptr)
+	    vkdcma.set_gradient_func(gfunc);
+	  vkdcma.set_progress_func(pfunc);
+	  vkdcma.set_plot_func(pffunc);
+	  vkdcma.optimize();
+	  return vkdcma.get_solutions();
+	}
+	case VKD_IPOP_CMAES:
+	{
+	  if (!parameters.is_vkd())
+	    parameters.set_vkd();
+	  ESOptimizer<IPOPCMAStrategy<VkDCMAUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> ipop(func,parameters);
+	  if (gfunc != nullptr)
+	    ipop.set_gradient_func(gfunc);
+	  ipop.set_progress_func(pfunc);
+	  ipop.set_plot_func(pffunc);
+	  ipop.optimize();
+	  return ipop.get_solutions();
+	}
+	case VKD_BIPOP_CMAES:
+	{
+	  if (!parameters.is_vkd())
+	    parameters.set_vkd();
+	  ESOptimizer<BIPOPCMAStrategy<VkDCMAUpdate,TGenoPheno>,CMAParameters<TGenoPheno>> bipop(func,parameters);
+	  if (gfunc != nullptr)
+	    bipop.set_gradient_func(gfunc);
+	  bipop.set_progress_func(pfunc);
+	  bipop.set_plot_func(pffunc);
+	  bipop.optimize();
+	  return bipop.get_solutions();
+	}
 	default:
 	return CMASolutions();
 	}
     }
+
+  /**
+   * \brief runs the selected algorithm on a batch objective function, that
+   *        evaluates a whole set of candidates, one per column, at once.
+   *        Strategies built from a FitFunc returned by batch_fitfunc() behave the same.
+   * @see batch_fitfunc
+   */
+  template <class TGenoPheno=GenoPheno<NoBoundStrategy>>
+  CMASolutions cmaes(BatchFitFunc &bfunc,
+		     CMAParameters<TGenoPheno> &parameters,
+		     ProgressFunc<CMAParameters<TGenoPheno>,CMASolutions> &pfunc=CMAStrategy<CovarianceUpdate,TGenoPheno>::_defaultPFunc,
+		     GradFunc gfunc=nullptr,
+		     const CMASolutions &solutions=CMASolutions(),
+		     PlotFunc<CMAParameters<TGenoPheno>,CMASolutions> &pffunc=CMAStrategy<CovarianceUpdate,TGenoPheno>::_defaultFPFunc)
+    {
+      FitFunc func = batch_fitfunc(bfunc);
+      return cmaes<TGenoPheno>(func,parameters,pfunc,gfunc,solutions,pffunc);
+    }
+
+  /**
+   * \brief optimizes an objective function of any callable type, e.g. a lambda or
+   *        a functor, whose calls the compiler can inline, see inline_fitfunc().
+   *        With parallel evaluations, or a custom evaluator, the objective function
+   *        is called through a FitFunc instead.
+   * @param func objective function, callable as double(const double*, int)
+   * @param parameters optimization parameters
+   * @param pfunc progress function
+   * @param gfunc gradient function
+   * @param solutions solution object to start from
+   * @param pffunc plot function
+   * @return optimization solutions
+   */
+  template <class TGenoPheno=GenoPheno<NoBoundStrategy>,class TFunc,
+    typename std::enable_if<!std::is_same<TFunc,FitFunc>::value
+    && std::is_convertible<decltype(std::declval<TFunc&>()(static_cast<const double*>(nullptr),0)),double>::value,int>::type=0>
+  CMASolutions cmaes(const TFunc &func,
+		     CMAParameters<TGenoPheno> &parameters,
+		     ProgressFunc<CMAParameters<TGenoPheno>,CMASolutions> &pfunc=CMAStrategy<CovarianceUpdate,TGenoPheno>::_defaultPFunc,
+		     GradFunc gfunc=nullptr,
+		     const CMASolutions &solutions=CMASolutions(),
+		     PlotFunc<CMAParameters<TGenoPheno>,CMASolutions> &pffunc=CMAStrategy<CovarianceUpdate,TGenoPheno>::_defaultFPFunc)
+    {
+      FitFunc ffunc = parameters.get_mt_feval() || parameters.get_evaluator() ? FitFunc(func) : inline_fitfunc(func);
+      return cmaes<TGenoPheno>(ffunc,parameters,pfunc,gfunc,solutions,pffunc);
+    }
 }
 
 #endif
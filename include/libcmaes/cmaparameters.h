@@ -41,10 +41,16 @@ namespace libcmaes
       template <class U> friend class CMAStopCriteria;
       template <class U, class V> friend class IPOPCMAStrategy;
       template <class U, class V> friend class BIPOPCMAStrategy;
+      template <class U, class V> friend class AsyncCMAStrategy;
+      template <class U> friend class LockstepCMA;
+      template <int D, class U> friend class FixedCMAStrategy;
       friend class CovarianceUpdate;
       friend class ACovarianceUpdate;
       template <class U> friend class errstats;
       friend class VDCMAUpdate;
+      friend class CholeskyCovarianceUpdate;
+      friend class LMCMAUpdate;
+      friend class VkDCMAUpdate;
       
     public:
       CMAParameters() {} //TODO: var init even if this constructor is not supposed to be used for now.
@@ -113,7 +119,12 @@ namespace libcmaes
       /**
        * \brief sets the optimization algorithm.
        *        Note: overrides Parameters::set_algo
-       * @param algo from CMAES_DEFAULT, IPOP_CMAES, BIPOP_CMAES, aCMAES, aIPOP_CMAES, aBIPOP_CMAES, sepCMAES, sepIPOP_CMAES, sepBIPOP_CMAES, sepaCMAES, sepaIPOP_CMAES, sepaBIPOP_CMAES, VD_CMAES, VD_IPOP_CMAES, VD_BIPOP_CMAES 
+       *        LM_CMAES (18), LM_IPOP_CMAES (19) and LM_BIPOP_CMAES (20) replace the covariance
+       *        matrix with m=4+3ln(n) direction vectors, in linear memory, see set_lm.
+       *        VKD_CMAES (21), VKD_IPOP_CMAES (22) and VKD_BIPOP_CMAES (23) restrict the covariance
+       *        matrix to D(I+VSV^T)D with k direction vectors, see set_vkd. k is fixed for the
+       *        whole run, floor(sqrt(n)) unless set with set_vkd_k, and is not adapted online.
+       * @param algo from CMAES_DEFAULT, IPOP_CMAES, BIPOP_CMAES, aCMAES, aIPOP_CMAES, aBIPOP_CMAES, sepCMAES, sepIPOP_CMAES, sepBIPOP_CMAES, sepaCMAES, sepaIPOP_CMAES, sepaBIPOP_CMAES, VD_CMAES, VD_IPOP_CMAES, VD_BIPOP_CMAES, CHOL_CMAES, CHOL_IPOP_CMAES, CHOL_BIPOP_CMAES, LM_CMAES, LM_IPOP_CMAES, LM_BIPOP_CMAES, VKD_CMAES, VKD_IPOP_CMAES, VKD_BIPOP_CMAES
        */
       void set_algo(const int &algo)
       {
@@ -133,7 +144,7 @@ namespace libcmaes
 
       /**
        * \brief sets the optimization algorithm.
-       * @param algo as string from cmaes,ipop,bipop,acmaes,aipop,abipop,sepcmaes,sepipop,sepbipop,sepacmaes,sepaipop,sepabipop,vdcma,vdipopcma,vdbipopcma
+       * @param algo as string from cmaes,ipop,bipop,acmaes,aipop,abipop,sepcmaes,sepipop,sepbipop,sepacmaes,sepaipop,sepabipop,vdcma,vdipopcma,vdbipopcma,cholcmaes,cholipop,cholbipop,lmcma,lmipopcma,lmbipopcma,vkdcma,vkdipopcma,vkdbipopcma
        */
       void set_str_algo(const std::string &algo)
       {
@@ -145,6 +156,12 @@ namespace libcmaes
 	  set_sep();
 	if (algo.find("vd")!=std::string::npos)
 	  set_vd();
+	if (algo.find("chol")!=std::string::npos)
+	  set_chol();
+	if (algo.find("lm")!=std::string::npos)
+	  set_lm();
+	if (algo.find("vkd")!=std::string::npos)
+	  set_vkd();
       }
 
       /**
@@ -190,6 +207,63 @@ namespace libcmaes
        * @return vd status
        */
       bool is_vd() const { return _vd; }
+
+      /**
+       * \brief activates the Cholesky factor update of the covariance matrix.
+       */
+      void set_chol();
+
+      /**
+       * \brief whether algorithm uses the Cholesky factor update.
+       * @return Cholesky update status
+       */
+      bool is_chol() const { return _chol; }
+
+      /**
+       * \brief activates the limited-memory update, with m=4+3ln(n) direction vectors.
+       */
+      void set_lm();
+
+      /**
+       * \brief whether algorithm uses the limited-memory update.
+       * @return limited-memory update status
+       */
+      bool is_lm() const { return _lm; }
+
+      /**
+       * \brief activates the VkD update, with k direction vectors.
+       */
+      void set_vkd();
+
+      /**
+       * \brief whether algorithm uses the VkD update.
+       * @return VkD update status
+       */
+      bool is_vkd() const { return _vkd; }
+
+      /**
+       * \brief sets the number k of direction vectors of the VkD update,
+       *        to be called before the optimizer is created.
+       * @param k number of direction vectors, default is floor(sqrt(n)) when k <= 0
+       */
+      void set_vkd_k(const int &k)
+      {
+	_vkd_k = k;
+	if (_vkd)
+	  set_vkd();
+      }
+
+      /**
+       * \brief returns the number of direction vectors of the VkD update.
+       * @return number of direction vectors
+       */
+      int get_vkd_k() const { return _vkd_k; }
+
+      /**
+       * \brief returns mu, number of candidates used to update the distribution.
+       * @return mu
+       */
+      inline int mu() const { return _mu; }
       
       /**
        * \brief freezes a parameter to a given value in genotype during optimization.
@@ -217,6 +291,21 @@ namespace libcmaes
        */
       inline int get_restarts() const { return _nrestarts; }
 
+      /**
+       * \brief sets the number of restarts that run concurrently (applies to IPOP and BIPOP).
+       *        Concurrent runs share the budget of function evaluations, and a run that
+       *        reaches the target f-value stops the others. The objective function
+       *        must then be thread-safe.
+       * @param n number of concurrent runs, 1 for sequential restarts, 0 for the number of cores
+       */
+      inline void set_restart_threads(const int &n) { _restart_threads = n; }
+
+      /**
+       * \brief get the number of restarts that run concurrently (applies to IPOP and BIPOP).
+       * @return number of concurrent runs
+       */
+      inline int get_restart_threads() const { return _restart_threads; }
+
       /**
        * \brief sets the lazy update (i.e. updates the eigenvalues every few steps).
        * @param lz whether to activate the lazy update
@@ -229,6 +318,45 @@ namespace libcmaes
        */
       inline bool get_lazy_update() { return _lazy_update; }
 
+      /**
+       * \brief get lazy update trigger, i.e. the number of iterations an
+       *        eigendecomposition may lag behind the covariance matrix.
+       * @return lazy update trigger
+       */
+      inline double get_lazy_value() const { return _lazy_value; }
+
+      /**
+       * \brief sets the asynchronous eigendecomposition, that runs in the background
+       *        against the evaluation of the current generation. Sampling then uses the
+       *        last finished decomposition, within the lazy update staleness bound.
+       * @param ae whether to activate the asynchronous eigendecomposition
+       */
+      inline void set_async_eigen(const bool &ae) { _async_eigen = ae; }
+
+      /**
+       * \brief get asynchronous eigendecomposition status.
+       * @return whether asynchronous eigendecomposition is activated
+       */
+      inline bool get_async_eigen() const { return _async_eigen; }
+
+      /**
+       * \brief sets the compressed population mode, for very large populations:
+       *        candidates are sampled and evaluated by chunks of at most c candidates,
+       *        each candidate is then stored as its position in the random stream,
+       *        and only the selected candidates are regenerated for the update.
+       *        Memory then remains O((mu+c)*dim), whatever lambda. Only applies to the
+       *        optimize() loop, and is not used with gradient, TPA, uncertainty
+       *        handling nor elitism.
+       * @param c maximum number of candidates per chunk, 0 deactivates the mode
+       */
+      inline void set_pop_chunk(const int &c) { _pop_chunk = c; }
+
+      /**
+       * \brief get the chunk size of the compressed population mode.
+       * @return maximum number of candidates per chunk, 0 if deactivated
+       */
+      inline int get_pop_chunk() const { return _pop_chunk; }
+
       /**
        * \brief sets elitism:
        *        0 -> no elitism
@@ -302,8 +430,11 @@ namespace libcmaes
       double _sigma_init; /**< initial sigma value. */
       
       int _nrestarts = 9; /**< maximum number of restart, when applicable. */
+      int _restart_threads = 1; /**< number of restarts that run concurrently, when applicable. */
       bool _lazy_update; /**< covariance lazy update. */
       double _lazy_value; /**< reference trigger for lazy update. */
+      bool _async_eigen = false; /**< eigendecomposition in background of the evaluation. */
+      int _pop_chunk = 0; /**< chunk size when the population is stored compressed, 0 otherwise. */
       
       // active cma.
       double _cm; /**< learning rate for the mean. */
@@ -316,6 +447,12 @@ namespace libcmaes
       // sep cma (diagonal cov).
       bool _sep = false; /**< whether to use diagonal covariance matrix. */
       bool _vd = false;
+      bool _chol = false; /**< whether to update a Cholesky factor of the covariance matrix instead of decomposing it. */
+      bool _lm = false; /**< whether to replace the covariance matrix with a limited set of direction vectors. */
+      dVec _lm_cd; /**< learning rates of the limited-memory transform, one per direction vector (LM-CMA only). */
+      dVec _lm_cc; /**< learning rates of the direction vectors (LM-CMA only). */
+      bool _vkd = false; /**< whether to restrict the covariance matrix to D(I+VSV^T)D with k direction vectors. */
+      int _vkd_k = 0; /**< number of direction vectors (VkD-CMA only). */
       
       bool _elitist = false; /**< re-inject the best-ever seen solution. */
       bool _initial_elitist = false; /**< re-inject x0. */
@@ -326,7 +463,7 @@ namespace libcmaes
     };
 
   template<class TGenoPheno>
-    std::map<std::string,int> Parameters<TGenoPheno>::_algos = {{"cmaes",0},{"ipop",1},{"bipop",2},{"acmaes",3},{"aipop",4},{"abipop",5},{"sepcmaes",6},{"sepipop",7},{"sepbipop",8},{"sepacmaes",9},{"sepaipop",10},{"sepabipop",11},{"vdcma",12},{"vdipopcma",13},{"vdbipopcma",14}};
+    std::map<std::string,int> Parameters<TGenoPheno>::_algos = {{"cmaes",0},{"ipop",1},{"bipop",2},{"acmaes",3},{"aipop",4},{"abipop",5},{"sepcmaes",6},{"sepipop",7},{"sepbipop",8},{"sepacmaes",9},{"sepaipop",10},{"sepabipop",11},{"vdcma",12},{"vdipopcma",13},{"vdbipopcma",14},{"cholcmaes",15},{"cholipop",16},{"cholbipop",17},{"lmcma",18},{"lmipopcma",19},{"lmbipopcma",20},{"vkdcma",21},{"vkdipopcma",22},{"vkdbipopcma",23}};
 }
 
 #endif
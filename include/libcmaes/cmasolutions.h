@@ -28,6 +28,8 @@
 #include <libcmaes/cmaparameters.h>
 #include <libcmaes/cmastopcriteria.h>
 #include <libcmaes/pli.h>
+#include <libcmaes/cmaworkspace.h>
+#include <libcmaes/ringbuffer.h>
 #include <vector>
 #include <algorithm>
 
@@ -46,6 +48,10 @@ namespace libcmaes
     template <class U> friend class CMAStopCriteria;
     template <class U, class V> friend class IPOPCMAStrategy;
     template <class U, class V> friend class BIPOPCMAStrategy;
+    template <class U, class V> friend class AsyncCMAStrategy;
+    template <class U, class V, class W> friend class OptimizerGroup;
+    template <class U> friend class LockstepCMA;
+    template <int D, class U> friend class FixedCMAStrategy;
     friend class CovarianceUpdate;
     friend class ACovarianceUpdate;
     template <class U> friend class errstats;
@@ -54,6 +60,9 @@ namespace libcmaes
     template <template <class X,class Y> class U, class V, class W> friend class ACMSurrogateStrategy;
 #endif
     friend class VDCMAUpdate;
+    friend class CholeskyCovarianceUpdate;
+    friend class LMCMAUpdate;
+    friend class VkDCMAUpdate;
     
   public:
     /**
@@ -71,13 +80,31 @@ namespace libcmaes
     ~CMASolutions();
 
     /**
-     * \brief sorts the current internal set of solution candidates.
+     * \brief sorts the current internal set of solution candidates,
+     *        NaN f-values rank worst.
      */
-    void sort_candidates()
-    {
-      std::stable_sort(_candidates.begin(),_candidates.end(),
-		[](Candidate const &c1, Candidate const &c2){return c1.get_fvalue() < c2.get_fvalue();});
-    }
+    void sort_candidates();
+
+    /**
+     * \brief ranks the candidates only as far as needed, through partial selection
+     *        over an index permutation. On return, the ntop best and nbottom worst
+     *        candidates are sorted, and the given ranks hold their exact candidate,
+     *        as do the worst, median and k-th best ranks used by the history.
+     *        Other candidates are only partitioned. As with sort_candidates,
+     *        NaN f-values rank worst, and ties keep their order.
+     * @param ntop number of best candidates to sort
+     * @param nbottom number of worst candidates to sort
+     * @param ranks additional ranks to place exactly
+     */
+    void select_candidates(const int &ntop, const int &nbottom=0,
+			   const std::vector<int> &ranks=std::vector<int>());
+
+    /**
+     * \brief makes candidate i a view onto column i of the population matrix,
+     *        e.g. before the candidates are evaluated. Parameter vectors then live
+     *        in a single contiguous matrix, and ranking only moves the views.
+     */
+    void bind_population();
 
     /**
      * \brief updates the history of best candidates, as well as other meaningful
@@ -102,13 +129,25 @@ namespace libcmaes
      */
     inline Candidate best_candidate() const
     {
-      if (_best_candidates_hist.empty()) // iter = 0
+      if (!_best_candidate.get_x_size()) // iter = 0
 	{
 	  if (_initial_candidate.get_x_size())
 	    return _initial_candidate;
 	  else return Candidate(std::numeric_limits<double>::quiet_NaN(),_xmean);
 	}
-      return _best_candidates_hist.back();
+      return _best_candidate;
+    }
+
+    /**
+     * \brief returns the best candidates of the last iterations, oldest first.
+     *        Only kept when required by parameters, the termination criteria
+     *        only need the objective function values.
+     * @return history of best candidates, empty unless enabled
+     * @see Parameters::set_full_hist
+     */
+    inline const RingBuffer<Candidate>& best_candidates_hist() const
+    {
+      return _best_candidates_hist;
     }
 
     /**
@@ -150,6 +189,17 @@ namespace libcmaes
     {
       return _candidates;
     }
+
+    /**
+     * \brief get the population matrix, one candidate parameter vector per column,
+     *        in evaluation order. Candidate ids index its columns. With a compressed
+     *        population, it only holds the regenerated candidates, in rank order.
+     * @return population matrix
+     */
+    inline const dMat& population() const
+    {
+      return _pop_x;
+    }
     
     /**
      * \brief number of candidate solutions.
@@ -275,6 +325,16 @@ namespace libcmaes
       return _csqinv;
     }
 
+    /**
+     * \brief returns the factor A of the covariance matrix such that C=AA^T,
+     *        only applicable to Cholesky-CMA-ES algorithms.
+     * @return covariance matrix factor
+     */
+    inline dMat csqrt() const
+    {
+      return _csqrt;
+    }
+
     /**
      * \brief returns inverse root square of separable covariance diagonal matrix, only applicable to sep-CMA-ES algorithms.
      * @return square root of error covariance diagonal matrix
@@ -296,9 +356,9 @@ namespace libcmaes
     {
       dVec phen_xmean = cmaparams.get_gp().pheno(_xmean);
       dVec stds;
-      if (!cmaparams.is_sep() && !cmaparams.is_vd())
+      if (!cmaparams.is_sep() && !cmaparams.is_vd() && !cmaparams.is_lm() && !cmaparams.is_vkd())
 	stds = _cov.diagonal().cwiseSqrt();
-      else if (cmaparams.is_sep())
+      else if (cmaparams.is_sep() || cmaparams.is_lm() || cmaparams.is_vkd()) // lm and vkd hold the diagonal of their covariance
 	stds = _sepcov.cwiseSqrt();
       else if (cmaparams.is_vd())
 	stds = (dVec::Constant(cmaparams.dim(),1.0)+_v.cwiseProduct(_v)).cwiseSqrt().cwiseProduct(_sepcov);
@@ -380,7 +440,8 @@ namespace libcmaes
      */
     inline std::string status_msg() const
       {
-	return CMAStopCriteria<>::_scriterias[_run_status];
+	auto it = CMAStopCriteria<>::_scriterias.find(_run_status); // no insertion, the map is shared by all threads.
+	return it != CMAStopCriteria<>::_scriterias.end() ? it->second : std::string();
       }
 
     /**
@@ -446,6 +507,16 @@ namespace libcmaes
       return _updated_eigen;
     }
 
+    /**
+     * \brief returns the iteration of the covariance matrix the sampler last
+     *        decomposed, with lazy updates or asynchronous eigendecomposition
+     * @return iteration of the last eigendecomposition
+     */
+    inline int eigeniter() const
+    {
+      return _eigeniter;
+    }
+
     /**
      * \brief returns current number of objective function evaluations
      * @return number of objective function evaluations
@@ -455,6 +526,26 @@ namespace libcmaes
       return _nevals;
     }
 
+    /**
+     * \brief returns the number of objective function values found in the cache,
+     *        when active, see Parameters::set_fcache
+     * @return number of cache hits
+     */
+    inline long fcache_hits() const
+    {
+      return _fcache_hits;
+    }
+
+    /**
+     * \brief returns the number of objective function values not found in the cache,
+     *        i.e. the number of actual objective function calls through the cache
+     * @return number of cache misses
+     */
+    inline long fcache_misses() const
+    {
+      return _fcache_misses;
+    }
+
     /**
      * \brief returns last computed eigenvalues
      * @return last computed eigenvalues
@@ -484,8 +575,19 @@ namespace libcmaes
 			const TGenoPheno &gp=TGenoPheno()) const;
 
   private:
+    /**
+     * \brief strict ranking order over candidate indices, NaN f-values rank worst.
+     */
+    bool ranks_before(const int &i, const int &j) const;
+
+    /**
+     * \brief moves the candidates along the ranking permutation of the workspace.
+     */
+    void permute_candidates();
+    
     dMat _cov; /**< covariance matrix. */
     dMat _csqinv; /** inverse root square of covariance matrix. */
+    dMat _csqrt; /**< factor A of the covariance matrix C=AA^T, Cholesky update only (_csqinv then holds A^-1). */
     dMat _sepcov;
     dMat _sepcsqinv;
     dVec _xmean; /**< distribution mean. */
@@ -494,19 +596,30 @@ namespace libcmaes
     short _hsig = 1; /**< 0 or 1. */
     double _sigma; /**< step size. */
     std::vector<Candidate> _candidates; /**< current set of candidate solutions. */
-    std::vector<Candidate> _best_candidates_hist; /**< history of best candidate solutions. */
+    dMat _pop_x; /**< parameter vectors of the population, one per column, viewed by the candidates. */
+    Candidate _best_candidate; /**< best candidate of the last iteration. */
+    RingBuffer<double> _best_fvalues_hist; /**< best function values of the last iterations, for termination criteria. */
+    WindowExtrema _best_fvalues_range; /**< range of the best function values over the window of termination criteria. */
+    int _nequal_fvalues = 0; /**< number of iterations in history whose best and k-th best function values are equal, for termination criteria. */
+    RingBuffer<Candidate> _best_candidates_hist; /**< history of best candidate solutions, only when requested by parameters. */
     int _max_hist = -1; /**< max size of the history, keeps memory requirements fixed. */
     
     double _max_eigenv = 0.0; /**< max eigenvalue, for termination criteria. */
     double _min_eigenv = 0.0; /**< min eigenvalue, for termination criteria. */
     dVec _leigenvalues; /**< last computed eigenvalues, for termination criteria. */
     dMat _leigenvectors; /**< last computed eigenvectors, for termination criteria. */
+    dVec _leigenvectors_max; /**< largest coordinate of the last computed eigenvectors, per row, for termination criteria. */
+    dVec _leigenvectors_min; /**< smallest coordinate of the last computed eigenvectors, per row, for termination criteria. */
     int _niter = 0; /**< number of iterations to reach this solution, for termination criteria. */
     int _nevals = 0; /**< number of function calls to reach the current solution. */
+    long _fcache_hits = 0; /**< number of objective function values found in the cache. */
+    long _fcache_misses = 0; /**< number of objective function values not found in the cache. */
     int _kcand = 1;
-    std::vector<Candidate> _k_best_candidates_hist; /**< k-th best candidate history, for termination criteria, k is kcand=1+floor(0.1+lambda/4). */
-    std::vector<double> _bfvalues; /**< best function values over the past 20 steps, for termination criteria. */
-    std::vector<double> _median_fvalues; /**< median function values of some steps, in the past, for termination criteria. */
+    RingBuffer<double> _k_best_fvalues_hist; /**< k-th best function value history, for termination criteria, k is kcand=1+floor(0.1+lambda/4). */
+    RingBuffer<double> _bfvalues = RingBuffer<double>(20); /**< best function values over the past 20 steps, for termination criteria. */
+    RingBuffer<double> _median_fvalues; /**< median function values of some steps, in the past, for termination criteria. */
+    SortedWindow _sorted_bfvalues = SortedWindow(20); /**< best function values over the past 20 steps, sorted. */
+    SortedWindow _oldest_median_fvalues = SortedWindow(20); /**< oldest 20 median function values in history, sorted. */
     
     int _eigeniter = 0; /**< eigenvalues computation last step, lazy-update only. */
     bool _updated_eigen = true; /**< last update is not lazy. */
@@ -532,6 +645,14 @@ namespace libcmaes
     
     dVec _v; /**< complementary vector for use in vdcma. */
 
+    dMat _lmvecs; /**< direction vectors of the limited-memory update, one per column. */
+    dVec _lmcd; /**< learning rates of the limited-memory transform, one per direction vector. */
+    int _lmk = 0; /**< number of direction vectors in use by the limited-memory transform. */
+
+    dMat _vkdv; /**< orthonormal direction vectors of the VkD model, one per column. */
+    dVec _vkds; /**< scalings of the VkD direction vectors. */
+    dVec _vkdd; /**< diagonal scaling D of the VkD model. */
+
     std::vector<RankedCandidate> _candidates_uh; /**< temporary set of candidates used by uncertainty handling scheme. */
     int _lambda_reev; /**< number of reevaluated solutions at current step. */
     double _suh; /**< uncertainty level computed by uncertainty handling procedure. */
@@ -542,6 +663,8 @@ namespace libcmaes
     dVec _tpa_x1;
     dVec _tpa_x2;
     dVec _xmean_prev; /**< previous step's mean vector. */
+
+    CMAWorkspace _ws; /**< buffers reused across generations by ask, eval and tell. */
   };
 
   CMAES_EXPORT std::ostream& operator<<(std::ostream &out,const CMASolutions &cmas);
@@ -23,8 +23,10 @@
 #define CMASTOPCRITERIA_H
 
 #include <libcmaes/cmaparameters.h>
+#include <bitset>
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace libcmaes
 {
@@ -51,6 +53,8 @@ namespace libcmaes
     FTARGET = 10 // success
   };
 
+  typedef std::bitset<32> StopCriteriaMask; /**< active criteria of a set, one bit per criterion. */
+
   template <class TGenoPheno=NoBoundStrategy>
   class StopCriteria
   {
@@ -58,14 +62,26 @@ namespace libcmaes
     StopCriteria(const StopCriteriaFunc<TGenoPheno> &sfunc)
       :_sfunc(sfunc)
     {}
+    StopCriteria(const int &code,
+		 const StopCriteriaFunc<TGenoPheno> &sfunc)
+      :_code(code),_sfunc(sfunc)
+    {}
     ~StopCriteria() {}
 
-    inline bool active() const { return _active; }
-  
-    void set_active(const bool &a) { _active = a; }
-  
+    inline bool active() const { return _mask ? (*_mask)[_bit] : _active; }
+
+    void set_active(const bool &a)
+    {
+      if (_mask)
+	(*_mask)[_bit] = a;
+      else _active = a;
+    }
+
+    int _code = CONT; /**< criterion, as in CMAStopCritType. */
     StopCriteriaFunc<TGenoPheno> _sfunc;
-    bool _active = true;
+    bool _active = true; /**< whether active, when not part of a set. */
+    StopCriteriaMask *_mask = nullptr; /**< active criteria of the set the criterion is part of. */
+    size_t _bit = 0; /**< bit of the criterion in _mask. */
   };
   
   /**
@@ -82,8 +98,11 @@ namespace libcmaes
      *        tests, see reference paper in cmastrategy.h
      */
     CMAStopCriteria();
+    CMAStopCriteria(const CMAStopCriteria &sc);
     ~CMAStopCriteria();
 
+    CMAStopCriteria& operator=(const CMAStopCriteria &sc);
+
     /**
      * \brief Termination criteria evaluation: the function iterates and 
      *        evaluates the predefined criteria.
@@ -101,7 +120,10 @@ namespace libcmaes
     int set_criteria_active(const int &c, const bool &active);
   
   private:
-    std::map<int,StopCriteria<TGenoPheno> > _scriteria; /**< the set of predefined criteria, with priorities. */
+    void bind_criteria();
+
+    std::vector<StopCriteria<TGenoPheno> > _scriteria; /**< the set of predefined criteria, in priority order. */
+    StopCriteriaMask _active_criteria; /**< active criteria, bit i for criterion i in _scriteria. */
     bool _active; /**< whether these termination criteria are active. */
     static std::map<int,std::string> _scriterias;
   };
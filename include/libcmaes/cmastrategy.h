@@ -29,8 +29,12 @@
 #include <libcmaes/covarianceupdate.h>
 #include <libcmaes/acovarianceupdate.h>
 #include <libcmaes/vdcmaupdate.h>
+#include <libcmaes/choleskycovarianceupdate.h>
+#include <libcmaes/lmcmaupdate.h>
+#include <libcmaes/vkdcmaupdate.h>
 #include <libcmaes/eigenmvn.h>
 #include <fstream>
+#include <future>
 
 namespace libcmaes
 {
@@ -73,9 +77,26 @@ namespace libcmaes
       /**
        * \brief generates nsols new candidate solutions, sampled from a 
        *        multivariate normal distribution.
+       *        Candidates are written into a buffer of the solutions object,
+       *        so that the returned reference remains valid until the next call.
        * return A matrix whose rows contain the candidate points.
        */
-      dMat ask();
+      const dMat& ask();
+
+      /**
+       * \brief samples and evaluates the population by chunks, in compressed population
+       *        mode: candidates only keep their f-value, and their id, that locates their
+       *        draw in the random stream.
+       * @return an empty matrix, candidates are already evaluated
+       * @see CMAParameters::set_pop_chunk
+       */
+      const dMat& ask_eval_chunks();
+
+      /**
+       * \brief whether the optimize() loop runs with a compressed population.
+       * @see CMAParameters::set_pop_chunk
+       */
+      bool compressed_population() const;
 
       /**
        * \brief Updates the covariance matrix and prepares for the next iteration.
@@ -109,8 +130,12 @@ namespace libcmaes
        */
     int optimize()
     {
+      if (compressed_population()) // candidates are evaluated by chunks, when asked.
+	return optimize([](const dMat&, const dMat&){},
+			population_askfunc(std::bind(&CMAStrategy<TCovarianceUpdate,TGenoPheno>::ask_eval_chunks,this)),
+			std::bind(&CMAStrategy<TCovarianceUpdate,TGenoPheno>::tell,this));
       return optimize(std::bind(&ESOStrategy<CMAParameters<TGenoPheno>,CMASolutions,CMAStopCriteria<TGenoPheno>>::eval,this,std::placeholders::_1,std::placeholders::_2),
-		      std::bind(&CMAStrategy<TCovarianceUpdate,TGenoPheno>::ask,this),
+		      population_askfunc(std::bind(&CMAStrategy<TCovarianceUpdate,TGenoPheno>::ask,this)),
 		      std::bind(&CMAStrategy<TCovarianceUpdate,TGenoPheno>::tell,this));
     }
 
@@ -121,9 +146,41 @@ namespace libcmaes
       void plot();
     
     protected:
+      /**
+       * \brief brings the sampler up to date with the search distribution, i.e.
+       *        decomposition, transform and mean, before candidates are drawn.
+       */
+      void update_sampler();
+
+      /**
+       * \brief maps standard normal vectors, one per column, to candidates in place.
+       * @param pop standard normal vectors, then candidates
+       */
+      void transform_candidates(dMat &pop);
+
+      /**
+       * \brief draws candidate r of a compressed population, alone, so that drawing
+       *        it again is exact.
+       * @param r candidate index in the population
+       * @param x candidate output
+       */
+      void sample_candidate(const int &r, dMat &x);
+
+      /**
+       * \brief regenerates the parameter vectors that the update and history read,
+       *        after ranking a compressed population.
+       * @param ntop number of best candidates read by the update
+       * @param nbottom number of worst candidates read by the update
+       */
+      void regenerate_selected(const int &ntop, const int &nbottom);
+      
       Eigen::EigenMultivariateNormal<double> _esolver;  /**< multivariate normal distribution sampler, and eigendecomposition solver. */
       CMAStopCriteria<TGenoPheno> _stopcriteria; /**< holds the set of termination criteria, see reference paper. */
       std::ofstream *_fplotstream = nullptr; /**< plotting file stream, not in parameters because of copy-constructor hell. */
+      std::future<Eigen::SelfAdjointEigenSolver<dMat>> _async_esolver; /**< eigendecomposition running in background, async eigen only. */
+      int _async_eigeniter = 0; /**< iteration of the covariance matrix under background decomposition. */
+      uint64_t _pop_counter = 0; /**< generator counter of the population draw, when compressed. */
+      bool _compressed_pop = false; /**< whether the current population is stored compressed. */
     
     public:
     static ProgressFunc<CMAParameters<TGenoPheno>,CMASolutions> _defaultPFunc; /**< the default progress function. */
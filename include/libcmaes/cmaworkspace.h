@@ -0,0 +1,79 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CMAWORKSPACE_H
+#define CMAWORKSPACE_H
+
+#include <libcmaes/eo_matrix.h>
+#include <vector>
+
+namespace libcmaes
+{
+  /**
+   * \brief Buffers that the ask / eval / tell steps write into instead of
+   *        temporaries, so that once sized by the first generation, a
+   *        generation performs no heap allocation. Buffers are only resized
+   *        when the problem size changes, e.g. on a restart with a larger
+   *        population.
+   */
+  class CMAWorkspace
+  {
+  public:
+    CMAWorkspace() {}
+
+    /**
+     * \brief sizes all buffers, only reallocates those whose size changes.
+     * @param dim problem dimension
+     * @param lambda population size
+     * @param mu number of selected candidates
+     */
+    void resize(const int &dim, const int &lambda, const int &mu)
+    {
+      _pop.resize(dim,lambda);
+      _phenopop.resize(dim,lambda);
+      _xmean.resize(dim);
+      _diffxmean.resize(dim);
+      _ys.resize(dim,mu);
+      _sepplus.resize(dim);
+      _perm.resize(lambda);
+      _fvalues.resize(lambda);
+    }
+
+    dMat _pop; /**< candidates as returned by ask(), one per column. */
+    dMat _phenopop; /**< pheno transform of the candidates. */
+    dVec _xmean; /**< new mean. */
+    dVec _diffxmean; /**< mean shift scaled by the step-size. */
+    dMat _ys; /**< weighted selected steps, one per column. */
+    dVec _sepplus; /**< weighted squared selected steps, the rank-mu diagonal of sep updates. */
+    dMat _ysminus; /**< weighted worst steps, one per column, for the negative update of active CMA. */
+    dVec _sepminus; /**< weighted squared worst steps, the negative diagonal of sep active CMA. */
+    dMat _zs; /**< worst steps in the coordinates of the inverse square root of the covariance. */
+    dMat _gram; /**< Gram matrix of _zs, whose largest eigenvalue bounds the negative update. */
+    Eigen::SelfAdjointEigenSolver<dMat> _gsolver; /**< eigenvalues of _gram. */
+    dMat _nn; /**< n x n intermediate, e.g. for the inverse square root of the covariance. */
+    dMat _col; /**< single candidate, e.g. regenerated from a compressed population. */
+    dVec _fvalues; /**< objective function values of a batch of candidates. */
+    std::vector<int> _perm; /**< candidate ranking permutation. */
+    std::vector<int> _sel; /**< single ranks to place by partial selection. */
+  };
+}
+
+#endif
@@ -35,6 +35,10 @@
 
 #include <Eigen/Dense>
 #include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 
 /*
@@ -43,63 +47,300 @@
   it needs mutable state.  The standard Eigen function 
   Random() just calls rand(), which changes a global
   variable.
+
+  Variates are produced by a counter-based Philox4x32-10 generator
+  followed by a Box-Muller transform: the i-th pair of variates of
+  a stream only depends on (seed,stream,i), so that every instance owns
+  its own generator, and a bulk draw can be split into blocks that are
+  generated independently, e.g. across threads, with the exact same
+  result. Blocks are laid out as plain arrays of lanes, and the
+  transform uses branch-free approximations of log, sin and cos,
+  so that the compiler vectorizes both stages.
 */
 namespace Eigen {
   namespace internal {
     template<typename Scalar>
       class scalar_normal_dist_op
       {
-private:
-    void swap(scalar_normal_dist_op &other) {
-      std::swap(rng, other.rng);
-      std::swap(norm, other.norm);
-    }
-public:
-	static std::mt19937 rng;                        // The uniform pseudo-random algorithm
-	mutable std::normal_distribution<Scalar> norm; // gaussian combinator
-	
-	//EIGEN_EMPTY_STRUCT_CTOR(scalar_normal_dist_op)
-  scalar_normal_dist_op() = default;
-  scalar_normal_dist_op(const scalar_normal_dist_op& other) 
-  : norm{other.norm}
-  {
-    rng = other.rng;
-  };
-  scalar_normal_dist_op &operator=(const scalar_normal_dist_op &other) {
-    if(this != &other)
-    {
-      scalar_normal_dist_op temp(other);
-      swap(temp);
-    }
-    return *this;
-  };
-    
-    scalar_normal_dist_op &operator=(scalar_normal_dist_op &&other) 
-    {
-        if (this != &other) {
-            swap(other);
-        }
-        return *this;
-    }
-    
-    scalar_normal_dist_op(scalar_normal_dist_op &&other) {
-        *this = std::move(other);
-    }
+      public:
+	static const int block = 64; // number of Philox counters, i.e. 2*block variates, per bulk block.
+
+	scalar_normal_dist_op(const uint64_t &s=5489u, const uint64_t &stream=0)
+	{
+	  seed(s,stream);
+	}
 
 	template<typename Index>
-	inline const Scalar operator() (Index, Index = 0) const { return norm(rng); }
-	inline void seed(const uint64_t &s) { rng.seed(s); }
+	inline const Scalar operator() (Index, Index = 0) const
+	{
+	  if (_cached)
+	    {
+	      _cached = false;
+	      return _cache;
+	    }
+	  Scalar z[2];
+	  fill(z,2);
+	  _cache = z[1];
+	  _cached = true;
+	  return z[0];
+	}
+
+	/**
+	 * \brief resets the generator to the beginning of a stream.
+	 * @param s seed, used as the Philox key
+	 * @param stream stream index, streams with the same seed are independent
+	 */
+	inline void seed(const uint64_t &s, const uint64_t &stream=0)
+	{
+	  _key[0] = static_cast<uint32_t>(s);
+	  _key[1] = static_cast<uint32_t>(s >> 32);
+	  _stream = stream;
+	  _counter = 0;
+	  _cached = false;
+	}
+
+	/**
+	 * \brief fills n consecutive values with N(0,1) variates, in bulk.
+	 * @param out output array
+	 * @param n number of variates
+	 */
+	void fill(Scalar *out, const long &n) const
+	{
+	  const uint64_t ncounters = (static_cast<uint64_t>(n)+1)/2;
+	  const uint64_t base = _counter;
+	  _counter += ncounters;
+	  const long nblocks = static_cast<long>((ncounters + block - 1) / block);
+#pragma omp parallel for if (nblocks >= 64)
+	  for (long b=0;b<nblocks;b++)
+	    {
+	      double z[2*block];
+	      const long offset = 2*block*b;
+	      const long len = std::min(static_cast<long>(2*block),n-offset);
+	      normal_block(base + static_cast<uint64_t>(b)*block,static_cast<int>((len+1)/2),z);
+	      for (long j=0;j<len;j++)
+		out[offset+j] = static_cast<Scalar>(z[j]);
+	    }
+	}
+
+	/**
+	 * \brief fills out with the n variates starting at index first of a bulk draw
+	 *        made from counter base, i.e. regenerates part of an earlier fill().
+	 * @param base counter of the bulk draw, as returned by counter() before it
+	 * @param first index of the first variate within the bulk draw
+	 * @param out output array
+	 * @param n number of variates
+	 */
+	void fill_at(const uint64_t &base, const uint64_t &first, Scalar *out, const long &n) const
+	{
+	  uint64_t c = base + first/2;
+	  long skip = static_cast<long>(first % 2);
+	  long done = 0;
+	  double z[2*block];
+	  while (done < n)
+	    {
+	      const long len = std::min(static_cast<long>(2*block)-skip,n-done);
+	      normal_block(c,static_cast<int>((skip+len+1)/2),z);
+	      for (long j=0;j<len;j++)
+		out[done+j] = static_cast<Scalar>(z[skip+j]);
+	      done += len;
+	      c += block;
+	      skip = 0;
+	    }
+	}
+
+	/**
+	 * \brief index of the next Philox counter in the stream.
+	 */
+	inline uint64_t counter() const { return _counter; }
+
+	/**
+	 * \brief advances the stream as fill() of n variates would, without drawing them.
+	 * @param n number of variates
+	 */
+	inline void skip(const long &n) const
+	{
+	  _counter += (static_cast<uint64_t>(n)+1)/2;
+	  _cached = false;
+	}
+
+      private:
+	/**
+	 * \brief Philox4x32-10 applied to counters (base+l,stream), l in [0,nc), nc <= block.
+	 */
+	void philox_block(const uint64_t &base, const int &nc, uint32_t r[4][block]) const
+	{
+	  for (int l=0;l<nc;l++)
+	    {
+	      const uint64_t c = base + l;
+	      r[0][l] = static_cast<uint32_t>(c);
+	      r[1][l] = static_cast<uint32_t>(c >> 32);
+	      r[2][l] = static_cast<uint32_t>(_stream);
+	      r[3][l] = static_cast<uint32_t>(_stream >> 32);
+	    }
+	  uint32_t k0 = _key[0], k1 = _key[1];
+	  for (int round=0;round<10;round++)
+	    {
+	      for (int l=0;l<nc;l++)
+		{
+		  const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * r[0][l];
+		  const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * r[2][l];
+		  const uint32_t c1 = r[1][l], c3 = r[3][l];
+		  r[0][l] = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+		  r[1][l] = static_cast<uint32_t>(p1);
+		  r[2][l] = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+		  r[3][l] = static_cast<uint32_t>(p0);
+		}
+	      k0 += 0x9E3779B9u;
+	      k1 += 0xBB67AE85u;
+	    }
+	}
+
+	/**
+	 * \brief log(u) for u in (0,1), branch-free so that it vectorizes.
+	 *        Cephes rational approximation, with an absolute error of about 1e-16.
+	 */
+	static inline double log_unit(const double u)
+	{
+	  uint64_t bits;
+	  std::memcpy(&bits,&u,sizeof(double));
+	  const uint64_t ebits = (bits >> 52) | 0x4330000000000000ull; // 2^52 + biased exponent, as a double
+	  const uint64_t mbits = (bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull; // mantissa in [1,2)
+	  double e, m;
+	  std::memcpy(&e,&ebits,sizeof(double));
+	  std::memcpy(&m,&mbits,sizeof(double));
+	  // u = (m/sqrt(2)) 2^(e+1/2), with m/sqrt(2) in [sqrt(2)/2,sqrt(2)) where the approximation holds,
+	  // rather than the usual branch on m.
+	  e = (e - (4503599627370496.0 + 1023.0)) + 0.5;
+	  const double x = m*0.70710678118654752440 - 1.0;
+	  const double z = x*x;
+	  const double p = ((((1.01875663804580931796E-4*x + 4.97494994976747001425E-1)*x + 4.70579119878881725854E0)*x
+			     + 1.44989225341610930846E1)*x + 1.79368678507819816313E1)*x + 7.70838733755885391666E0;
+	  const double q = ((((x + 1.12873587189167450590E1)*x + 4.52279145837532221105E1)*x
+			     + 8.29875266912776603211E1)*x + 7.11544750618563894466E1)*x + 2.31251620126765340583E1;
+	  double y = x*(z*p/q) - e*2.121944400546905827679E-4 - 0.5*z;
+	  return x + y + e*0.693359375;
+	}
+
+	/**
+	 * \brief sin(2 pi u) and cos(2 pi u) for u in [0,1), branch-free so that it vectorizes.
+	 *        The reduction to [0,pi/4] is exact in u, and Cephes polynomials do the rest.
+	 */
+	static inline void sincos_unit(const double u, double &s, double &c)
+	{
+	  static const double pio2 = 1.57079632679489661923;
+	  static const double pio4 = 0.78539816339744830962;
+	  const double t = 4.0*u;
+	  const int quadrant = static_cast<int>(t);
+	  const double xq = (t - quadrant)*pio2; // in [0,pi/2)
+	  const double upper = xq > pio4 ? 1.0 : 0.0; // selects are blends, since the compiler does not if-convert floating-point operations.
+	  const double x = xq + upper*(pio2 - 2.0*xq); // in [0,pi/4]
+	  const double z = x*x;
+	  const double sx = x + x*z*(((((1.58962301576546568060E-10*z - 2.50507477628578072866E-8)*z + 2.75573136213857245213E-6)*z
+				      - 1.98412698295895385996E-4)*z + 8.33333333332211858878E-3)*z - 1.66666666666666307295E-1);
+	  const double cx = 1.0 - 0.5*z + z*z*(((((-1.13585365213876817300E-11*z + 2.08757008419747316778E-9)*z - 2.75573141792967388112E-7)*z
+						 + 2.48015872888517045348E-5)*z - 1.38888888888730564116E-3)*z + 4.16666666666665929218E-2);
+	  const double swap = (quadrant & 1) ? 1.0 - upper : upper; // a quarter turn swaps sin and cos.
+	  s = (sx + swap*(cx - sx)) * static_cast<double>(1 - (quadrant & 2));
+	  c = (cx + swap*(sx - cx)) * static_cast<double>(1 - ((quadrant + 1) & 2));
+	}
+
+	/**
+	 * \brief 2*nc N(0,1) variates from counters [base,base+nc), nc <= block, by Box-Muller.
+	 */
+	void normal_block(const uint64_t &base, const int &nc, double *z) const
+	{
+	  uint32_t r[4][block];
+	  philox_block(base,nc,r);
+	  static const double two26 = 67108864.0;
+	  static const double two53inv = 1.0/9007199254740992.0;
+	  double rad[block], sn[block], cs[block];
+	  for (int l=0;l<nc;l++)
+	    {
+	      // 53-bit uniforms, u1 in (0,1) so that the log is always finite, u2 in [0,1),
+	      // assembled from 27 and 26 bit halves that convert as signed 32-bit integers.
+	      const double u1 = (static_cast<int32_t>(r[0][l] >> 5) * two26 + static_cast<int32_t>(r[1][l] >> 6) + 0.5) * two53inv;
+	      const double u2 = (static_cast<int32_t>(r[2][l] >> 5) * two26 + static_cast<int32_t>(r[3][l] >> 6)) * two53inv;
+	      rad[l] = -2.0*log_unit(u1);
+	      sincos_unit(u2,sn[l],cs[l]);
+	    }
+	  for (int l=0;l<nc;l++) // kept apart, since sqrt may set errno and would prevent vectorization above.
+	    rad[l] = std::sqrt(rad[l]);
+	  for (int l=0;l<nc;l++)
+	    {
+	      z[2*l] = rad[l] * cs[l];
+	      z[2*l+1] = rad[l] * sn[l];
+	    }
+	}
+
+	uint32_t _key[2];
+	uint64_t _stream = 0;
+	mutable uint64_t _counter = 0; /**< index of the next Philox counter in the stream. */
+	mutable Scalar _cache = 0.0; /**< second variate of the last pair drawn by operator(). */
+	mutable bool _cached = false;
       };
 
-    template<typename Scalar>
-      std::mt19937 scalar_normal_dist_op<Scalar>::rng;
-      
     template<typename Scalar>
       struct functor_traits<scalar_normal_dist_op<Scalar> >
       { enum { Cost = 50 * NumTraits<Scalar>::MulCost, PacketAccess = false, IsRepeatable = false }; };
     
   } // end namespace internal
 
+  /*
+  Symmetric eigensolver that keeps the Householder workspace used to
+  extract the eigenvectors, so that decomposing matrices of unchanged
+  size performs no heap allocation, whereas SelfAdjointEigenSolver::compute()
+  allocates it on every call. It follows the same steps as compute() and
+  otherwise is a SelfAdjointEigenSolver.
+  */
+  template<typename MatrixType>
+    class ReusableEigenSolver : public SelfAdjointEigenSolver<MatrixType>
+  {
+    typedef SelfAdjointEigenSolver<MatrixType> Base;
+    typedef typename Tridiagonalization<MatrixType>::HouseholderSequenceType HouseholderSequenceType;
+
+  public:
+    ReusableEigenSolver() {}
+
+    ReusableEigenSolver& operator=(const Base &solver)
+    {
+      Base::operator=(solver);
+      return *this;
+    }
+
+    ReusableEigenSolver& compute(const MatrixType &matrix)
+    {
+      Index n = matrix.cols();
+      if (n < 2)
+	{
+	  Base::compute(matrix);
+	  return *this;
+	}
+      MatrixType &mat = this->m_eivec;
+      this->m_eivalues.resize(n);
+      this->m_subdiag.resize(n-1);
+      this->m_hcoeffs.resize(n-1);
+
+      // map the matrix coefficients to [-1:1] to avoid over- and underflow.
+      mat = matrix.template triangularView<Lower>();
+      typename MatrixType::RealScalar scale = mat.cwiseAbs().maxCoeff();
+      if (scale == 0)
+	scale = 1;
+      mat.template triangularView<Lower>() /= scale;
+      internal::tridiagonalization_inplace(mat,this->m_hcoeffs);
+      this->m_eivalues = mat.diagonal().real();
+      this->m_subdiag = mat.template diagonal<-1>().real();
+      HouseholderSequenceType(mat,this->m_hcoeffs.conjugate()).setLength(n-1).setShift(1).evalTo(mat,_hworkspace);
+      this->m_info = internal::computeFromTridiagonal_impl(this->m_eivalues,this->m_subdiag,Base::m_maxIterations,true,mat);
+      this->m_eivalues *= scale;
+      this->m_isInitialized = true;
+      this->m_eigenvectorsOk = true;
+      return *this;
+    }
+
+  private:
+    Matrix<typename MatrixType::Scalar,Dynamic,1> _hworkspace; // Householder workspace, reused across decompositions.
+  };
+
   /**
     Find the eigen-decomposition of the covariance matrix
     and then store it for sampling from a multi-variate normal 
@@ -118,22 +359,25 @@ public:
   private:
     Matrix<Scalar,Dynamic,Dynamic> _covar;
     Matrix<Scalar,Dynamic,Dynamic> _transform;
+    Matrix<Scalar,Dynamic,Dynamic> _z; // standard normal draws, reused across samples() calls.
     
   public:
-    SelfAdjointEigenSolver<Matrix<Scalar,Dynamic,Dynamic> > _eigenSolver; // drawback: this creates a useless eigenSolver when using Cholesky decomposition, but it yields access to eigenvalues and vectors
+    ReusableEigenSolver<Matrix<Scalar,Dynamic,Dynamic> > _eigenSolver; // drawback: this creates a useless eigenSolver when using Cholesky decomposition, but it yields access to eigenvalues and vectors
     
   public:
     EigenMultivariateNormal(const bool &use_cholesky=false,
-			    const uint64_t &seed=std::mt19937::default_seed)
+			    const uint64_t &seed=std::mt19937::default_seed,
+			    const uint64_t &stream=0)
       :_use_cholesky(use_cholesky)
       {
-	randN.seed(seed);
+	randN.seed(seed,stream);
       }
   EigenMultivariateNormal(const Matrix<Scalar,Dynamic,1>& mean,const Matrix<Scalar,Dynamic,Dynamic>& covar,
-			  const bool &use_cholesky=false,const uint64_t &seed=std::mt19937::default_seed)
+			  const bool &use_cholesky=false,const uint64_t &seed=std::mt19937::default_seed,
+			  const uint64_t &stream=0)
       :_use_cholesky(use_cholesky)
     {
-      randN.seed(seed);
+      randN.seed(seed,stream);
       setMean(mean);
       setCovar(covar);
     }
@@ -166,21 +410,31 @@ public:
 	}
       else
 	{
-	  _eigenSolver = SelfAdjointEigenSolver<Matrix<Scalar,Dynamic,Dynamic> >(_covar);
+	  _eigenSolver.compute(_covar); // reuses the solver storage.
 	  _transform = _eigenSolver.eigenvectors()*_eigenSolver.eigenvalues().cwiseMax(0).cwiseSqrt().asDiagonal();
 	}
     }
 
+    /// Install a precomputed eigendecomposition of the covariance matrix,
+    /// e.g. one that was computed in the background.
+    void set_eigensolver(const SelfAdjointEigenSolver<Matrix<Scalar,Dynamic,Dynamic> > &eigenSolver)
+    {
+      _eigenSolver = eigenSolver;
+      _transform = _eigenSolver.eigenvectors()*_eigenSolver.eigenvalues().cwiseMax(0).cwiseSqrt().asDiagonal();
+    }
+
     /// Draw nn samples from the gaussian and return them
     /// as columns in a Dynamic by nn matrix
     Matrix<Scalar,Dynamic,-1> samples(int nn, double factor)
       {
-	return ((_transform * Matrix<Scalar,Dynamic,-1>::NullaryExpr(_covar.rows(),nn,randN))*factor).colwise() + _mean;
+	Matrix<Scalar,Dynamic,-1> z(_transform.cols(),nn);
+	randN.fill(z.data(),z.size());
+	return ((_transform * z)*factor).colwise() + _mean;
       }
 
     Matrix<Scalar,Dynamic,-1> samples_ind(int nn, double factor)
       {
-	dMat pop = (Matrix<Scalar,Dynamic,-1>::NullaryExpr(_covar.rows(),nn,randN))*factor;
+	Matrix<Scalar,Dynamic,-1> pop = samples_ind(nn)*factor;
 	for (int i=0;i<pop.cols();i++)
 	  {
 	    pop.col(i) = pop.col(i).cwiseProduct(_transform) + _mean;
@@ -188,9 +442,54 @@ public:
 	return pop;
       }
 
+    /// Draw nn standard normal vectors, in bulk.
     Matrix<Scalar,Dynamic,-1> samples_ind(int nn)
       {
-	return (Matrix<Scalar,Dynamic,-1>::NullaryExpr(_covar.rows(),nn,randN));
+	Matrix<Scalar,Dynamic,-1> pop(_covar.rows(),nn);
+	randN.fill(pop.data(),pop.size());
+	return pop;
+      }
+
+    /// Same as samples(), into pop, that is only reallocated when its size changes.
+    void samples(int nn, double factor, Matrix<Scalar,Dynamic,-1> &pop)
+      {
+	_z.resize(_transform.cols(),nn);
+	randN.fill(_z.data(),_z.size());
+	pop.resize(_transform.rows(),nn);
+	pop.noalias() = _transform * _z;
+	pop *= factor;
+	pop.colwise() += _mean;
+      }
+
+    /// Maps standard normal vectors, one per column of pop, to samples in place,
+    /// with the same operations as samples().
+    void transform(Matrix<Scalar,Dynamic,-1> &pop, double factor)
+      {
+	_z.resize(_transform.rows(),pop.cols());
+	_z.noalias() = _transform * pop;
+	_z *= factor;
+	_z.colwise() += _mean;
+	pop.swap(_z);
+      }
+
+    /// Counter of the normal generator, that identifies the next bulk draw.
+    uint64_t counter() const { return randN.counter(); }
+
+    /// Advances the normal generator past a bulk draw of n variates.
+    void skip(const long &n) { randN.skip(n); }
+
+    /// Regenerates n variates of the bulk draw made from counter base, from index first.
+    void normals_at(const uint64_t &base, const uint64_t &first, Scalar *out, const long &n) const
+      {
+	randN.fill_at(base,first,out,n);
+      }
+    
+    /// Same as samples_ind(), into pop, that is only reallocated when its size changes.
+    /// Vectors have the dimension of the mean, so that only the mean needs to be set.
+    void samples_ind(int nn, Matrix<Scalar,Dynamic,-1> &pop)
+      {
+	pop.resize(_mean.rows(),nn);
+	randN.fill(pop.data(),pop.size());
       }
     
   }; // end class EigenMultivariateNormal
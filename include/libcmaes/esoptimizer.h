@@ -59,7 +59,25 @@ enum {
   /* VD-IPOP-CMA-ES */
   VD_IPOP_CMAES = 13,
   /* VD-BIPOP-CMA-ES */
-  VD_BIPOP_CMAES = 14
+  VD_BIPOP_CMAES = 14,
+  /* Cholesky-CMA-ES */
+  CHOL_CMAES = 15,
+  /* Cholesky-IPOP-CMA-ES */
+  CHOL_IPOP_CMAES = 16,
+  /* Cholesky-BIPOP-CMA-ES */
+  CHOL_BIPOP_CMAES = 17,
+  /* LM-CMA-ES */
+  LM_CMAES = 18,
+  /* LM-IPOP-CMA-ES */
+  LM_IPOP_CMAES = 19,
+  /* LM-BIPOP-CMA-ES */
+  LM_BIPOP_CMAES = 20,
+  /* VkD-CMA-ES */
+  VKD_CMAES = 21,
+  /* VkD-IPOP-CMA-ES */
+  VKD_IPOP_CMAES = 22,
+  /* VkD-BIPOP-CMA-ES */
+  VKD_BIPOP_CMAES = 23
 };
 
 namespace libcmaes
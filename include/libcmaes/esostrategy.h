@@ -25,17 +25,106 @@
 #include <libcmaes/eo_matrix.h> // to include Eigen everywhere.
 #include <libcmaes/candidate.h>
 #include <libcmaes/eigenmvn.h>
+#include <libcmaes/evaluator.h>
 #include <random>
 
 namespace libcmaes
 {
   typedef std::function<double (const double*, const int &n)> FitFunc;
+  typedef std::function<void (const dMat &phenocandidates, dVec &fvalues)> BatchFitFunc;
   typedef std::function<dVec (const double*, const int &n)> GradFunc;
 
   typedef std::function<void(const dMat&, const dMat&)> EvalFunc;
   typedef std::function<dMat(void)> AskFunc;
   typedef std::function<void(void)> TellFunc;
+
+  /**
+   * \brief Ask function that returns candidates held by the strategy, e.g. the
+   *        population of its workspace. An AskFunc that holds one is recognized
+   *        by optimize(), that then evaluates the candidates in place instead of
+   *        a copy. This is how the strategies pass their own ask() through the
+   *        AskFunc interface.
+   */
+  class PopulationAskFunc
+  {
+  public:
+    PopulationAskFunc(const std::function<const dMat&(void)> &askf)
+      :_askf(askf) {}
+
+    dMat operator()() const
+    {
+      return _askf();
+    }
+
+    std::function<const dMat&(void)> _askf; /**< returns the candidates, that must outlive their evaluation. */
+  };
+
+  /**
+   * \brief wraps an ask function that returns candidates held by the strategy,
+   *        that optimize() then evaluates without a copy.
+   * @param askf ask function, returning a reference that remains valid until the next call
+   * @return ask function
+   */
+  inline AskFunc population_askfunc(const std::function<const dMat&(void)> &askf)
+  {
+    return PopulationAskFunc(askf);
+  }
   
+  /**
+   * \brief Single-point objective function that forwards to a batch objective
+   *        function. A FitFunc that holds one is recognized by the strategies,
+   *        that then evaluate whole sets of candidates with a single batch call.
+   *        This is how batch objective functions are passed through the interfaces
+   *        that take a FitFunc.
+   */
+  class BatchPointFunc
+  {
+  public:
+    BatchPointFunc(const BatchFitFunc &bfunc)
+      :_bfunc(bfunc) {}
+
+    double operator()(const double *x, const int &n) const
+    {
+      dVec fvalue(1);
+      _bfunc(Eigen::Map<const dMat>(x,n,1),fvalue);
+      return fvalue(0);
+    }
+
+    BatchFitFunc _bfunc; /**< the batch objective function. */
+  };
+
+  /**
+   * \brief wraps a batch objective function into a single-point one, that strategies
+   *        still evaluate by batches.
+   * @param bfunc batch objective function, that fills fvalues with one value per column
+   * @return single-point objective function
+   */
+  inline FitFunc batch_fitfunc(const BatchFitFunc &bfunc)
+  {
+    return BatchPointFunc(bfunc);
+  }
+
+  /**
+   * \brief wraps an objective function of any callable type, e.g. a lambda or a
+   *        functor, into a single-point one that strategies evaluate by batches,
+   *        each batch as a loop over the callable itself, instead of a FitFunc
+   *        call per candidate. The compiler can then inline the objective function
+   *        into the loop. Batches run in the calling thread.
+   * @param func objective function, callable as double(const double*, int)
+   * @return single-point objective function
+   */
+  template <class TFunc>
+    FitFunc inline_fitfunc(TFunc func)
+  {
+    return batch_fitfunc([func](const dMat &x, dVec &fvalues) mutable
+			 {
+			   const int n = x.rows();
+			   fvalues.resize(x.cols());
+			   for (int c=0;c<x.cols();c++)
+			     fvalues(c) = func(x.col(c).data(),n);
+			 });
+  }
+
   template<class TParameters,class TSolutions>
     using ProgressFunc = std::function<int (const TParameters&, const TSolutions&)>; // template aliasing.
 
@@ -84,7 +173,7 @@ namespace libcmaes
      * \brief Generates a set of candidate points.
      * @return A matrix whose rows contain the candidate points.
      */
-    dMat ask();
+    const dMat& ask();
 
     /**
      * \brief Evaluates a set of candidates against the objective function.
@@ -206,6 +295,15 @@ namespace libcmaes
      */
     double fitfunc(const double *x, const int N) { return _func(x,N); }
 
+    /**
+     * \brief evaluates a set of points, one per column, with the batch objective
+     *        function if any, or with the objective function on every point,
+     *        through the evaluator.
+     * @param x points at which to execute the function, one per column
+     * @param fvalues objective function values, one per column
+     */
+    void fitfunc_batch(const dMat &x, dVec &fvalues);
+
     /**
      * \brief uncertainty handling scheme that computes and uncertainty
      *        level based on a dual candidate ranking.
@@ -245,6 +343,20 @@ namespace libcmaes
     void set_initial_elitist(const bool &e) { _initial_elitist = e; }
     
   protected:
+    /**
+     * \brief returns the evaluator that runs objective function calls: the custom
+     *        one if set, the shared thread pool with parallel evaluations, or
+     *        a sequential one otherwise.
+     * @return evaluator
+     */
+    Evaluator& evaluator();
+
+    /**
+     * \brief puts the cache of objective function values, if active, in front of
+     *        the objective function.
+     */
+    void init_fcache();
+
     FitFunc _func; /**< the objective function. */
     int _nevals;  /**< number of function evaluations. */
     int _niter;  /**< number of iterations. */
@@ -254,7 +366,11 @@ namespace libcmaes
     GradFunc _gfunc = nullptr; /**< gradient function, when available. */
     PlotFunc<TParameters,TSolutions> _pffunc; /**< possibly custom stream data to file function. */
     FitFunc _funcaux;
+    BatchFitFunc _bfunc = nullptr; /**< batch objective function, when the objective function wraps one. */
     bool _initial_elitist = false; /**< restarts from and re-injects best seen solution if not the final one. */
+    std::shared_ptr<Evaluator> _pool; /**< built-in thread pool, for parallel evaluations. */
+    long _fcache_hits0 = 0; /**< cache hits before this optimizer's first evaluation. */
+    long _fcache_misses0 = 0; /**< cache misses before this optimizer's first evaluation. */
 
   private:
     std::mt19937 _uhgen; /**< random device used for uncertainty handling operations. */
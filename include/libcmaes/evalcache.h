@@ -0,0 +1,187 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVALCACHE_H
+#define EVALCACHE_H
+
+#include <libcmaes/eo_matrix.h>
+#include <libcmaes/cmaes_export.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace libcmaes
+{
+  /**
+   * \brief Bounded cache of objective function values, keyed on the point in
+   *        parameter space (phenotype), for objective functions that are costly
+   *        enough that re-evaluating a point is worth avoiding, e.g. with
+   *        fixed or discretized parameters, or points folded onto the same
+   *        phenotype by the bounds.
+   *        Points are either matched exactly, or after rounding every coordinate
+   *        to a multiple of a quantum. Least recently used values are evicted.
+   *        The cache is split into stripes with their own lock, so that
+   *        concurrent evaluations rarely contend.
+   */
+  class CMAES_EXPORT EvalCache
+  {
+  public:
+    /**
+     * \brief constructor.
+     * @param capacity maximum number of cached values
+     * @param quantum coordinates are rounded to a multiple of quantum before matching, 0 for exact matching
+     * @param nstripes number of independently locked stripes
+     */
+    EvalCache(const int &capacity,
+	      const double &quantum=0.0,
+	      const int &nstripes=16);
+
+    ~EvalCache() {}
+
+    /**
+     * \brief looks up the value of a point.
+     * @param x point
+     * @param n dimension
+     * @param fvalue the value if found
+     * @return true on hit
+     */
+    bool lookup(const double *x, const int &n, double &fvalue);
+
+    /**
+     * \brief stores the value of a point, possibly evicting the least recently used value.
+     * @param x point
+     * @param n dimension
+     * @param fvalue objective function value
+     */
+    void insert(const double *x, const int &n, const double &fvalue);
+
+    /**
+     * \brief value of a point, from the cache or else from the objective function.
+     * @param func objective function
+     * @param x point
+     * @param n dimension
+     * @return objective function value
+     */
+    template <class TFunc>
+      double eval(const TFunc &func, const double *x, const int &n)
+      {
+	double fvalue;
+	if (lookup(x,n,fvalue))
+	  return fvalue;
+	fvalue = func(x,n);
+	insert(x,n,fvalue);
+	return fvalue;
+      }
+
+    /**
+     * \brief values of a set of points, the ones that are not in the cache
+     *        are evaluated with a single call to the batch objective function.
+     * @param bfunc batch objective function
+     * @param x points, one per column
+     * @param fvalues values, one per column of x
+     */
+    template <class TBatchFunc>
+      void eval_batch(const TBatchFunc &bfunc, const dMat &x, dVec &fvalues)
+      {
+	fvalues.resize(x.cols());
+	std::vector<int> misses;
+	for (int c=0;c<x.cols();c++)
+	  if (!lookup(x.col(c).data(),x.rows(),fvalues(c)))
+	    misses.push_back(c);
+	if (misses.empty())
+	  return;
+	if ((int)misses.size() == x.cols())
+	  bfunc(x,fvalues);
+	else
+	  {
+	    dMat xm(x.rows(),misses.size());
+	    for (size_t m=0;m<misses.size();m++)
+	      xm.col(m) = x.col(misses[m]);
+	    dVec fm(misses.size());
+	    bfunc(xm,fm);
+	    for (size_t m=0;m<misses.size();m++)
+	      fvalues(misses[m]) = fm(m);
+	  }
+	for (int c: misses)
+	  insert(x.col(c).data(),x.rows(),fvalues(c));
+      }
+
+    /**
+     * \brief removes all cached values, counters are kept.
+     */
+    void clear();
+
+    /**
+     * \brief number of cached values.
+     * @return size
+     */
+    int size() const;
+
+    /**
+     * \brief maximum number of cached values.
+     * @return capacity
+     */
+    int capacity() const { return _capacity; }
+
+    /**
+     * \brief number of lookups that found a value.
+     * @return hits
+     */
+    long hits() const { return _hits; }
+
+    /**
+     * \brief number of lookups that did not find a value.
+     * @return misses
+     */
+    long misses() const { return _misses; }
+
+  private:
+    typedef std::vector<double> Key;
+
+    struct KeyHash
+    {
+      size_t operator()(const Key &k) const;
+    };
+
+    struct Stripe
+    {
+      std::mutex _mtx;
+      std::list<std::pair<Key,double>> _lru; /**< values, most recently used first. */
+      std::unordered_map<Key,std::list<std::pair<Key,double>>::iterator,KeyHash> _index;
+    };
+
+    void make_key(const double *x, const int &n, Key &k) const;
+    Stripe& stripe(const Key &k);
+
+    int _capacity; /**< maximum number of values. */
+    int _stripe_capacity; /**< maximum number of values per stripe. */
+    double _quantum; /**< rounding of coordinates, 0 for exact matching. */
+    std::vector<std::unique_ptr<Stripe>> _stripes;
+    std::atomic<long> _hits{0};
+    std::atomic<long> _misses{0};
+  };
+
+}
+
+#endif
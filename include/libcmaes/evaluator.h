@@ -0,0 +1,154 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <libcmaes/cmaes_export.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace libcmaes
+{
+  /**
+   * \brief Non-owning reference to a task, i.e. a callable of a task index.
+   *        Unlike std::function it never allocates, so that batches do not
+   *        touch the heap. The referenced callable must outlive the batch.
+   */
+  class EvalTask
+  {
+  public:
+    template<class F,
+      class = typename std::enable_if<!std::is_same<typename std::decay<F>::type,EvalTask>::value>::type>
+      EvalTask(const F &f)
+      :_obj(&f),_call([](const void *obj, const int &i){ (*static_cast<const F*>(obj))(i); })
+      {}
+
+    void operator()(const int &i) const { _call(_obj,i); }
+
+  private:
+    const void *_obj; /**< the callable. */
+    void (*_call)(const void*, const int&); /**< calls the callable with a task index. */
+  };
+
+  /**
+   * \brief Runs a batch of independent tasks, e.g. objective function calls.
+   *        The base evaluator runs them in order in the calling thread, derive
+   *        from it in order to plug a custom parallel scheme into the search.
+   */
+  class CMAES_EXPORT Evaluator
+  {
+  public:
+    Evaluator() {}
+    virtual ~Evaluator() {}
+
+    /**
+     * \brief runs task(i) for every i in [0,n), and returns when all are done.
+     *        Tasks must be independent from each other. The first exception thrown
+     *        by a task is rethrown to the caller.
+     * @param n number of tasks
+     * @param task the task, called with its index
+     */
+    virtual void parallel_for(const int &n, const EvalTask &task);
+
+    /**
+     * \brief number of tasks this evaluator runs at once.
+     * @return number of threads
+     */
+    virtual int nthreads() const { return 1; }
+  };
+
+  /**
+   * \brief Evaluator with a persistent pool of threads, with work stealing.
+   *        Every task is scheduled on its own: each thread pops tasks from the
+   *        front of its own queue, then steals from the back of the others, so that
+   *        slow objective function calls do not leave threads idle.
+   *        The calling thread runs tasks as well. Calls from within a task run
+   *        in the calling thread.
+   */
+  class CMAES_EXPORT ThreadPool : public Evaluator
+  {
+  public:
+    /**
+     * \brief constructor.
+     * @param nthreads number of threads, including the calling thread. With 0,
+     *        the hardware concurrency divided by Eigen's number of threads, so that
+     *        the pool and Eigen's parallel products do not oversubscribe the cores.
+     */
+    ThreadPool(const int &nthreads=0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void parallel_for(const int &n, const EvalTask &task) override;
+
+    int nthreads() const override { return static_cast<int>(_queues.size()); }
+
+    /**
+     * \brief default number of threads, see constructor.
+     * @return number of threads
+     */
+    static int default_nthreads();
+
+    /**
+     * \brief returns a process-wide pool, that persists across optimizations.
+     * @param nthreads number of threads, 0 for the default
+     * @return shared pool with nthreads threads
+     */
+    static std::shared_ptr<ThreadPool> shared(const int &nthreads=0);
+
+  private:
+    struct TaskQueue
+    {
+      std::mutex _mtx;
+      std::deque<int> _tasks;
+    };
+
+    void worker(const int &w);
+    bool next_task(const int &w, int &i);
+    void run_tasks(const int &w);
+
+    std::vector<std::thread> _workers; /**< pool threads, queue 0 belongs to the calling thread. */
+    std::vector<std::unique_ptr<TaskQueue>> _queues; /**< one task queue per thread. */
+    std::mutex _mtx; /**< guards the batch epoch and the termination flag. */
+    std::condition_variable _start_cv;
+    std::condition_variable _done_cv;
+    std::mutex _call_mtx; /**< serializes batches submitted from different threads. */
+    const EvalTask *_task = nullptr; /**< task of the current batch. */
+    unsigned long _epoch = 0; /**< current batch number. */
+    std::atomic<int> _remaining; /**< tasks of the current batch that are not done yet. */
+    std::exception_ptr _error; /**< first exception thrown by the current batch. */
+    std::mutex _error_mtx;
+    bool _stop = false;
+  };
+
+}
+
+#endif
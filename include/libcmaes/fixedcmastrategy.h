@@ -0,0 +1,216 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FIXEDCMASTRATEGY_H
+#define FIXEDCMASTRATEGY_H
+
+#include <libcmaes/cmastrategy.h>
+#include <functional>
+
+namespace libcmaes
+{
+  /**
+   * \brief CMA-ES for a dimension known at compile time, e.g. a fit of a few
+   *        parameters. The decomposition, the sampling transform and the
+   *        covariance update run on fixed-size Eigen types, whose temporaries
+   *        live on the stack and whose loops are unrolled, while the search
+   *        state remains in the regular CMASolutions and CMAParameters.
+   *        It follows the default CMA-ES, i.e. CMAStrategy<CovarianceUpdate>,
+   *        and hands over to it whenever the parameters require what the
+   *        fixed-size path does not implement, i.e. a dimension other than Dim,
+   *        other covariance flavors, two-point adaptation, gradient,
+   *        uncertainty handling, fixed parameters, asynchronous decomposition
+   *        or compressed population.
+   *        Use it through ESOptimizer, e.g.
+   *        ESOptimizer<FixedCMAStrategy<5>,CMAParameters<>> optim(func,cmaparams);
+   */
+  template <int Dim,class TGenoPheno=GenoPheno<NoBoundStrategy>>
+    class FixedCMAStrategy : public CMAStrategy<CovarianceUpdate,TGenoPheno>
+    {
+      static_assert(Dim > 0 && Dim <= 32,"FixedCMAStrategy is for dimensions 1 to 32");
+
+    public:
+      typedef Eigen::Matrix<double,Dim,Dim> dMatN; /**< fixed-size matrix. */
+      typedef Eigen::Matrix<double,Dim,1> dVecN; /**< fixed-size vector. */
+
+      /**
+       * \brief dummy constructor
+       */
+      FixedCMAStrategy()
+	:CMAStrategy<CovarianceUpdate,TGenoPheno>()
+	{
+	}
+
+      /**
+       * \brief constructor.
+       * @param func objective function to minimize
+       * @param parameters stochastic search parameters
+       */
+      FixedCMAStrategy(FitFunc &func,
+		       CMAParameters<TGenoPheno> &parameters)
+	:CMAStrategy<CovarianceUpdate,TGenoPheno>(func,parameters)
+	{
+	}
+
+      /**
+       * \brief constructor for starting from an existing solution.
+       * @param func objective function to minimize
+       * @param parameters stochastic search parameters
+       * @param cmasols solution object to start from
+       */
+      FixedCMAStrategy(FitFunc &func,
+		       CMAParameters<TGenoPheno> &parameters,
+		       const CMASolutions &cmasols)
+	:CMAStrategy<CovarianceUpdate,TGenoPheno>(func,parameters,cmasols)
+	{
+	}
+
+      ~FixedCMAStrategy() {}
+
+      /**
+       * \brief whether the search runs on the fixed-size path.
+       * @return true unless parameters require the dynamic CMAStrategy
+       */
+      bool fixed_dim() const
+      {
+	const CMAParameters<TGenoPheno> &p = this->_parameters;
+	return p._dim == Dim && !p._sep && !p._vd && !p._chol && !p._lm && !p._vkd
+	  && p._tpa < 2 && !p._with_gradient && !p._uh && p._fixed_p.empty()
+	  && !p._async_eigen && !this->compressed_population();
+      }
+
+      /**
+       * \brief generates the population, see CMAStrategy::ask().
+       * @return candidates, one per column
+       */
+      const dMat& ask()
+      {
+	if (!fixed_dim())
+	  return CMAStrategy<CovarianceUpdate,TGenoPheno>::ask();
+	CMASolutions &sols = this->_solutions;
+	const CMAParameters<TGenoPheno> &p = this->_parameters;
+
+	// eigendecomposition, on the lazy update schedule.
+	sols._updated_eigen = false;
+	if (this->_niter == 0 || !p._lazy_update || this->_niter - sols._eigeniter > p._lazy_value)
+	  {
+	    sols._eigeniter = this->_niter;
+	    _eig.compute(Eigen::Map<const dMatN>(sols._cov.data()));
+	    _bd = _eig.eigenvectors() * _eig.eigenvalues().cwiseMax(0).cwiseSqrt().asDiagonal();
+	    sols._updated_eigen = true;
+	  }
+
+	// Eq (1), on the same draws as CMAStrategy::ask().
+	dMat &pop = sols._ws._pop;
+	this->_esolver.setMean(sols._xmean);
+	this->_esolver.samples_ind(p._lambda,pop);
+	Eigen::Map<const dVecN> xmean(sols._xmean.data());
+	for (int r=0;r<p._lambda;r++)
+	  {
+	    Eigen::Map<dVecN> x(pop.col(r).data());
+	    dVecN y = _bd * x;
+	    x = xmean + sols._sigma * y;
+	  }
+	this->_compressed_pop = false;
+	return pop;
+      }
+
+      /**
+       * \brief ranks the population and updates the search distribution, see CMAStrategy::tell().
+       */
+      void tell()
+      {
+	if (!fixed_dim())
+	  return CMAStrategy<CovarianceUpdate,TGenoPheno>::tell();
+	CMASolutions &sols = this->_solutions;
+	const CMAParameters<TGenoPheno> &p = this->_parameters;
+	sols.select_candidates(p._mu);
+	sols.update_best_candidates();
+
+	// compute mean, Eq. (2)
+	Eigen::Map<dVecN> oxmean(sols._xmean.data());
+	dVecN xmean = dVecN::Zero();
+	for (int i=0;i<p._mu;i++)
+	  xmean += p._weights[i] * Eigen::Map<const dVecN>(sols._candidates[i].get_x_ptr());
+	dVecN diffxmean = (xmean - oxmean) / sols._sigma;
+	sols._csqinv.resize(Dim,Dim);
+	Eigen::Map<dMatN> csqinv(sols._csqinv.data());
+	if (sols._updated_eigen)
+	  csqinv = _eig.operatorInverseSqrt();
+
+	// update psigma, Eq. (3)
+	Eigen::Map<dVecN> psigma(sols._psigma.data());
+	psigma = (1.0-p._csigma) * psigma + p._fact_ps * (csqinv * diffxmean);
+	double norm_ps = psigma.norm();
+
+	// update pc, Eq. (4)
+	double val_for_hsig = sqrt(1.0-pow(1.0-p._csigma,2.0*(sols._niter+1)))*(1.4+2.0/(p._dim+1))*p._chi;
+	sols._hsig = norm_ps < val_for_hsig ? 1 : 0;
+	Eigen::Map<dVecN> pc(sols._pc.data());
+	pc = (1.0-p._cc) * pc + (sols._hsig * p._fact_pc) * diffxmean;
+
+	// covariance update, Eq (5).
+	Eigen::Map<dMatN> cov(sols._cov.data());
+	double alphacov = 1-p._c1-p._cmu+(1-sols._hsig)*p._c1*p._cc*(2.0-p._cc);
+	dMatN rankmu = dMatN::Zero();
+	for (int i=0;i<p._mu;i++)
+	  {
+	    dVecN y = (Eigen::Map<const dVecN>(sols._candidates[i].get_x_ptr()) - oxmean) / sols._sigma;
+	    rankmu.noalias() += p._weights[i] * y * y.transpose();
+	  }
+	cov = alphacov * cov + p._c1 * pc * pc.transpose() + p._cmu * rankmu;
+
+	// sigma update, Eq. (6)
+	sols._sigma *= std::exp((p._csigma / p._dsigma) * (norm_ps / p._chi - 1.0));
+
+	// set mean.
+	if (p._tpa)
+	  sols._xmean_prev = sols._xmean;
+	oxmean = xmean;
+
+	if (sols._updated_eigen)
+	  sols.update_eigenv(_eig.eigenvalues(),_eig.eigenvectors());
+      }
+
+      /**
+       * \brief Finds the minimum of the objective function, see CMAStrategy::optimize().
+       * @return success or error code, as defined in opti_err.h
+       */
+      int optimize()
+      {
+	if (!fixed_dim())
+	  return CMAStrategy<CovarianceUpdate,TGenoPheno>::optimize();
+	return CMAStrategy<CovarianceUpdate,TGenoPheno>::optimize(std::bind(&ESOStrategy<CMAParameters<TGenoPheno>,CMASolutions,CMAStopCriteria<TGenoPheno>>::eval,this,std::placeholders::_1,std::placeholders::_2),
+								   population_askfunc(std::bind(&FixedCMAStrategy<Dim,TGenoPheno>::ask,this)),
+								   std::bind(&FixedCMAStrategy<Dim,TGenoPheno>::tell,this));
+      }
+
+    private:
+      Eigen::SelfAdjointEigenSolver<dMatN> _eig; /**< fixed-size eigendecomposition of the covariance matrix. */
+      dMatN _bd; /**< sampling transform, eigenvectors scaled by the square roots of the eigenvalues. */
+
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+
+}
+
+#endif
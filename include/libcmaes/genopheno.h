@@ -95,21 +95,17 @@ namespace libcmaes
     ~GenoPheno() {}
 
     private:
-    dMat pheno_candidates(const dMat &candidates) const
+    /**
+     * \brief bounds and scaling of a candidate, in place, where strategies
+     *        that are identity, e.g. NoBoundStrategy and NoScalingStrategy,
+     *        compile to nothing.
+     * @param x candidate, after the custom pheno function
+     */
+    void to_f_inplace(Eigen::Ref<dVec> x) const
     {
-      if (!_id)
-	{
-	  dMat ncandidates = dMat(candidates.rows(),candidates.cols());
-#pragma omp parallel for if (candidates.cols() >= 100)
-	  for (int i=0;i<candidates.cols();i++)
-	    {
-	      dVec ext = dVec(candidates.rows());
-	      _phenof(candidates.col(i).data(),ext.data(),candidates.rows());
-	      ncandidates.col(i) = ext;
-	    }
-	  return ncandidates;
-	}
-      return candidates;
+      _boundstrategy.to_f_representation(x);
+      if (!_scalingstrategy._id)
+	_scalingstrategy.scale_to_f(x);
     }
 
     dMat geno_candidates(const dMat &candidates) const
@@ -119,11 +115,7 @@ namespace libcmaes
 	  dMat ncandidates = dMat(candidates.rows(),candidates.cols());
 #pragma omp parallel for if (candidates.cols() >= 100)
 	  for (int i=0;i<candidates.cols();i++)
-	    {
-	      dVec in = dVec(candidates.rows());
-	      _genof(candidates.col(i).data(),in.data(),candidates.rows());
-	      ncandidates.col(i) = in;
-	    }
+	    _genof(candidates.col(i).data(),ncandidates.col(i).data(),candidates.rows());
 	  return ncandidates;
 	}
       return candidates;
@@ -132,28 +124,34 @@ namespace libcmaes
     public:
     dMat pheno(const dMat &candidates) const
     {
-      // apply custom pheno function.
-      dMat ncandidates = pheno_candidates(candidates);
+      dMat ncandidates;
+      if (&pheno(candidates,ncandidates) == &candidates)
+	return candidates;
+      return ncandidates;
+    }
 
-      // apply bounds.
-#pragma omp parallel for if (ncandidates.cols() >= 100)
-      for (int i=0;i<ncandidates.cols();i++)
-	{
-	  dVec ycoli;
-	  _boundstrategy.to_f_representation(ncandidates.col(i),ycoli);
-	  ncandidates.col(i) = ycoli;
-	}
-      
-      // apply scaling.
-      if (!_scalingstrategy._id)
+    /**
+     * \brief pheno transform of the candidates into ncandidates, that is only
+     *        reallocated when its size changes. The custom pheno function,
+     *        bounds and scaling apply in a single pass over each candidate.
+     * @param candidates candidates, one per column
+     * @param ncandidates pheno transformed candidates, untouched when the
+     *        whole transform is identity
+     * @return pheno transformed candidates, i.e. candidates themselves when
+     *         the whole transform is identity, ncandidates otherwise
+     */
+    const dMat& pheno(const dMat &candidates, dMat &ncandidates) const
+    {
+      if (_id && _boundstrategy.is_id() && _scalingstrategy.is_id())
+	return candidates;
+      ncandidates.resize(candidates.rows(),candidates.cols());
+#pragma omp parallel for if (candidates.cols() >= 100)
+      for (int i=0;i<candidates.cols();i++)
 	{
-#pragma omp parallel for if (ncandidates.cols() >= 100)
-	  for (int i=0;i<ncandidates.cols();i++)
-	    {
-	      dVec ycoli;
-	      _scalingstrategy.scale_to_f(ncandidates.col(i),ycoli);
-	      ncandidates.col(i) = ycoli;
-	    }
+	  if (_id)
+	    ncandidates.col(i) = candidates.col(i);
+	  else _phenof(candidates.col(i).data(),ncandidates.col(i).data(),candidates.rows());
+	  to_f_inplace(ncandidates.col(i));
 	}
       return ncandidates;
     }
@@ -173,14 +171,8 @@ namespace libcmaes
 	    }
 	}
       
-      // reverse bounds.
-#pragma omp parallel for if (ncandidates.cols() >= 100)
-      for (int i=0;i<ncandidates.cols();i++)
-	{
-	  dVec ycoli;
-	  _boundstrategy.to_internal_representation(ycoli,ncandidates.col(i));
-	  ncandidates.col(i) = ycoli;
-	}
+      // reverse bounds, in place.
+      _boundstrategy.to_internal_representation(ncandidates);
       
       // apply custom geno function.
       ncandidates = geno_candidates(ncandidates);
@@ -190,26 +182,17 @@ namespace libcmaes
     dVec pheno(const dVec &candidate) const
     {
       // apply custom pheno function.
-      dVec ncandidate;
-      if (!_id)
-	{
-	  ncandidate = dVec(candidate.rows());
-	  _phenof(candidate.data(),ncandidate.data(),candidate.rows());
-	}
-      
-      // apply bounds.
-      dVec phen = dVec::Zero(candidate.rows());
+      dVec phen;
       if (_id)
-	_boundstrategy.to_f_representation(candidate,phen);
-      else _boundstrategy.to_f_representation(ncandidate,phen);
-      
-      // apply scaling.
-      if (!_scalingstrategy._id)
+	phen = candidate;
+      else
 	{
-	  dVec sphen = dVec::Zero(phen.rows());
-	  _scalingstrategy.scale_to_f(phen,sphen);
-	  phen = sphen;
+	  phen.resize(candidate.rows());
+	  _phenof(candidate.data(),phen.data(),candidate.rows());
 	}
+      
+      // apply bounds and scaling, in place.
+      to_f_inplace(phen);
       return phen;
     }
     
@@ -261,23 +244,6 @@ namespace libcmaes
   };
 
   // specialization when no bound strategy nor scaling applies.
-  template<> inline dMat GenoPheno<NoBoundStrategy,NoScalingStrategy>::pheno(const dMat &candidates) const
-    {
-      if (_id)
-	return candidates;
-      else return pheno_candidates(candidates);
-    }
-  template<> inline dVec GenoPheno<NoBoundStrategy,NoScalingStrategy>::pheno(const dVec &candidate) const
-    {
-      if (_id)
-	return candidate;
-      else
-	{
-	  dVec ncandidate(candidate.rows());
-	  _phenof(candidate.data(),ncandidate.data(),candidate.rows());
-	  return ncandidate;
-	}
-    }
   template<> inline dVec GenoPheno<NoBoundStrategy,NoScalingStrategy>::geno(const dVec &candidate) const
     {
       if (_id)
@@ -290,18 +256,6 @@ namespace libcmaes
 	}
     }
 
-  template<> inline dVec GenoPheno<NoBoundStrategy,linScalingStrategy>::pheno(const dVec &candidate) const
-    {
-      dVec ncandidate(candidate.rows());
-      if (!_id)
-	_phenof(candidate.data(),ncandidate.data(),candidate.rows());
-      
-      dVec sphen;
-      if (!_id)
-	_scalingstrategy.scale_to_f(ncandidate,sphen);
-      else _scalingstrategy.scale_to_f(candidate,sphen);
-      return sphen;
-    }
   template<> inline dVec GenoPheno<NoBoundStrategy,linScalingStrategy>::geno(const dVec &candidate) const
     {
       dVec scand = dVec::Zero(candidate.rows());
@@ -315,23 +269,6 @@ namespace libcmaes
 	  return ncandidate;
 	}
     }
-  template<> inline dMat GenoPheno<NoBoundStrategy,linScalingStrategy>::pheno(const dMat &candidates) const
-    {
-      dMat ncandidates;
-      if (!_id)
-	ncandidates = pheno_candidates(candidates);
-      else ncandidates = candidates;
-      
-      // apply scaling.
-#pragma omp parallel for if (ncandidates.cols() >= 100)
-      for (int i=0;i<ncandidates.cols();i++)
-	{
-	  dVec ycoli;
-	  _scalingstrategy.scale_to_f(ncandidates.col(i),ycoli);
-	  ncandidates.col(i) = ycoli;
-	}
-      return ncandidates;
-    }
   
   template<> inline GenoPheno<NoBoundStrategy,linScalingStrategy>::GenoPheno(const dVec &scaling,
 									     const dVec &shift,
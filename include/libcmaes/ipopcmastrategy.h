@@ -23,6 +23,7 @@
 #define IPOPCMASTRATEGY_H
 
 #include <libcmaes/cmastrategy.h>
+#include <array>
 
 namespace libcmaes
 {
@@ -81,8 +82,12 @@ namespace libcmaes
      */
     int optimize()
     {
+      if (this->compressed_population()) // candidates are evaluated by chunks, when asked.
+	return optimize([](const dMat&, const dMat&){},
+			population_askfunc(std::bind(&IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::ask_eval_chunks,this)),
+			std::bind(&IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::tell,this));
       return optimize(std::bind(&IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::eval,this,std::placeholders::_1,std::placeholders::_2),
-		      std::bind(&IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::ask,this),
+		      population_askfunc(std::bind(&IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::ask,this)),
 		      std::bind(&IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::tell,this));
     }
     
@@ -90,6 +95,22 @@ namespace libcmaes
     void lambda_inc();
     void reset_search_state();
     void capture_best_solution(CMASolutions &best_run);
+
+    /**
+     * \brief runs restarts concurrently, each as an independent search that is
+     *        configured by next. Runs share the budget of function evaluations, and
+     *        one that reaches the target f-value stops the others. A run reserves
+     *        its cap of function evaluations for its regime from its launch, and
+     *        releases what it did not consume when it ends. Uncapped runs reserve
+     *        lambda times their maximum or automatic maximum number of iterations.
+     * @param next sets the parameters of the next run, and its regime (0 or 1) whose
+     *        budget the run consumes, returns false when there is no more run
+     * @return success or error code, as defined in opti_err.h
+     */
+    int optimize_parallel(const std::function<bool (CMAParameters<TGenoPheno>&, int&)> &next);
+
+    std::array<int,2> _budgets = {{0,0}}; /**< function evaluations consumed by each regime of restarts. */
+    std::array<int,2> _reserved = {{0,0}}; /**< function evaluations that runs in flight may still consume, by regime. */
   };
 }
 
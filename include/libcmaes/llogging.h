@@ -31,12 +31,17 @@
 
 namespace libcmaes
 {
-  static std::string INFO="INFO";
-  static std::string WARNING="WARNING";
-  static std::string ERROR="ERROR";
-  static std::string FATAL="FATAL";
+  static const std::string INFO="INFO";
+  static const std::string WARNING="WARNING";
+  static const std::string ERROR="ERROR";
+  static const std::string FATAL="FATAL";
 
-  static std::ostream nullstream(0);
+  // writes to a stream without buffer set its state, so that every thread gets its own.
+inline std::ostream& nullstream()
+{
+  static thread_local std::ostream ns(0);
+  return ns;
+}
 
 inline std::ostream& LOG(const std::string &severity,std::ostream &out=std::cout)
 {
@@ -48,7 +53,7 @@ inline std::ostream& LOG_IF(const std::string &severity,const bool &condition,st
 {
   if (condition)
     return LOG(severity,out);
-  else return nullstream;
+  else return nullstream();
 }
 }
 #endif
@@ -0,0 +1,106 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LMCMAUPDATE_H
+#define LMCMAUPDATE_H
+
+#include <libcmaes/cmaparameters.h>
+#include <libcmaes/cmasolutions.h>
+#include <libcmaes/eigenmvn.h>
+
+namespace libcmaes
+{
+
+  /**
+   * \brief Limited-memory CMA update, that replaces the covariance matrix with
+   *        m << n direction vectors M_j. Samples are obtained as d = T z with
+   *        T = T_k...T_1 and T_j = (1-c_d,j)I + c_d,j M_j M_j^T, so that the
+   *        sampling covariance is C = TT^T. Sampling and update are in O(m n),
+   *        and memory is linear in the dimension.
+   *        This implementation closely follows:
+   *        I. Loshchilov, T. Glasmachers, H.-G. Beyer, "Large Scale Black-box
+   *        Optimization by Limited-Memory Matrix Adaptation", IEEE Transactions
+   *        on Evolutionary Computation 23(2), 2019.
+   */
+  class CMAES_EXPORT LMCMAUpdate
+  {
+  public:
+    /**
+     * \brief update the direction vectors, the mean and the step-size.
+     * @param parameters current set of parameters
+     * @param esolver Eigen eigenvalue solver (unused)
+     * @param solutions currrent set of solutions.
+     */
+    template <class TGenoPheno>
+    static void update(const CMAParameters<TGenoPheno> &parameters,
+		       Eigen::EigenMultivariateNormal<double> &esolver,
+		       CMASolutions &solutions);
+
+    /**
+     * \brief applies the transform T, or its transpose, to every column of z in place.
+     * @param solutions current set of solutions that holds the direction vectors
+     * @param z vectors to be transformed, one per column
+     * @param transpose whether to apply T^T instead of T
+     */
+    static void transform(const CMASolutions &solutions,
+			  dMat &z,
+			  const bool &transpose=false);
+
+    /**
+     * \brief applies the inverse transform T^-1 to every column of y in place,
+     *        with each factor inverted through the Sherman-Morrison formula.
+     * @param solutions current set of solutions that holds the direction vectors
+     * @param y vectors to be transformed, one per column
+     */
+    static void inverse_transform(const CMASolutions &solutions,
+				  dMat &y);
+
+    /**
+     * \brief expresses T as alpha I + PQ^T with P and Q of size n x k,
+     *        in O(n k^2).
+     * @param solutions current set of solutions that holds the direction vectors
+     * @param alpha identity coefficient
+     * @param P left low-rank factor
+     * @param Q right low-rank factor
+     */
+    static void low_rank_form(const CMASolutions &solutions,
+			      double &alpha,
+			      dMat &P,
+			      dMat &Q);
+
+    /**
+     * \brief diagonal of the covariance matrix C = TT^T, in O(n k^2).
+     * @param solutions current set of solutions that holds the direction vectors
+     * @return diagonal of the covariance matrix
+     */
+    static dVec cov_diagonal(const CMASolutions &solutions);
+
+    /**
+     * \brief full covariance matrix C = TT^T, in O(n^2 k), to be used for inspection only.
+     * @param solutions current set of solutions that holds the direction vectors
+     * @return covariance matrix
+     */
+    static dMat full_cov(const CMASolutions &solutions);
+  };
+  
+}
+
+#endif
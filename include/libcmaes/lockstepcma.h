@@ -0,0 +1,123 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOCKSTEPCMA_H
+#define LOCKSTEPCMA_H
+
+#include <libcmaes/cmaparameters.h>
+#include <libcmaes/cmasolutions.h>
+#include <libcmaes/esostrategy.h>
+#include <vector>
+
+namespace libcmaes
+{
+  /**
+   * \brief Runs many independent CMA-ES instances of small dimension, e.g. a
+   *        few curve fitting parameters each, in lockstep.
+   *        Instances of the same dimension and population size advance one
+   *        generation at a time together, with their states laid out one
+   *        instance per lane, i.e. every coordinate of the mean, of the paths
+   *        and of the covariance matrix is a contiguous array over instances.
+   *        Sampling, the covariance update and the eigendecomposition, by cyclic
+   *        Jacobi rotations, then run as vector operations across instances,
+   *        and the per-generation cost of an instance no longer carries
+   *        allocations, stopping criteria lookups nor small matrix kernels.
+   *        Every instance keeps its own parameters, with CMAParameters defaults,
+   *        its own seed, and its results are returned as a regular CMASolutions.
+   *        Instances that require what the lockstep engine does not implement,
+   *        i.e. restarts, other covariance flavors, two-point adaptation, gradient,
+   *        uncertainty handling, elitism, fixed parameters, objective value cache
+   *        or plotting, run through cmaes() instead.
+   *        Progress functions are not called, and objective functions are
+   *        called in the calling thread.
+   */
+  template <class TGenoPheno=GenoPheno<NoBoundStrategy>>
+    class CMAES_EXPORT LockstepCMA
+  {
+  public:
+    /**
+     * \brief constructor.
+     * @param funcs objective functions, one per instance
+     * @param parameters stochastic search parameters, one per instance
+     */
+    LockstepCMA(const std::vector<FitFunc> &funcs,
+		const std::vector<CMAParameters<TGenoPheno>> &parameters);
+
+    ~LockstepCMA();
+
+    /**
+     * \brief runs all instances until each of them meets one of its termination criteria.
+     * @return OPTI_SUCCESS if every instance succeeded, OPTI_ERR_TERMINATION otherwise
+     */
+    int optimize();
+
+    /**
+     * \brief number of instances.
+     * @return number of instances
+     */
+    int size() const { return static_cast<int>(_funcs.size()); }
+
+    /**
+     * \brief whether an instance runs in lockstep, or through cmaes().
+     * @param k instance index
+     * @return true if in lockstep
+     */
+    bool lockstep(const int &k) const;
+
+    /**
+     * \brief solutions of an instance.
+     * @param k instance index
+     * @return solutions
+     */
+    CMASolutions& get_solutions(const int &k) { return _solutions.at(k); }
+
+    /**
+     * \brief parameters of an instance.
+     * @param k instance index
+     * @return parameters
+     */
+    CMAParameters<TGenoPheno>& get_parameters(const int &k) { return _parameters.at(k); }
+
+  private:
+    struct Lanes; /**< state of instances in lockstep, one lane per instance. */
+
+    /**
+     * \brief runs instances of the same dimension and population size in lockstep.
+     * @param ks instance indices
+     */
+    void run_lockstep(const std::vector<int> &ks);
+
+    /**
+     * \brief termination criterion of a lane, with the same tests and order as CMAStopCriteria.
+     * @param ls lanes
+     * @param a lane
+     * @return criterion, CONT if none
+     */
+    int stop_lane(const Lanes &ls, const int &a) const;
+
+    std::vector<FitFunc> _funcs; /**< objective functions. */
+    std::vector<CMAParameters<TGenoPheno>> _parameters; /**< instance parameters. */
+    std::vector<CMASolutions> _solutions; /**< instance solutions. */
+  };
+
+}
+
+#endif
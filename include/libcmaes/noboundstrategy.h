@@ -56,6 +56,21 @@ namespace libcmaes
       (void)y;
     }
 
+    void to_f_representation(Eigen::Ref<dVec> x) const
+    {
+      (void)x;
+    }
+
+    void to_f_representation(dMat &x) const
+    {
+      (void)x;
+    }
+
+    void to_internal_representation(dMat &x) const
+    {
+      (void)x;
+    }
+
     void remove_dimensions(const std::vector<int> &k)
     {
       (void)k;
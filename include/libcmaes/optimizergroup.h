@@ -0,0 +1,231 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPTIMIZERGROUP_H
+#define OPTIMIZERGROUP_H
+
+#include <libcmaes/esoptimizer.h>
+#include <libcmaes/cmastrategy.h>
+#include <libcmaes/evaluator.h>
+#include <libcmaes/opti_err.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace libcmaes
+{
+  /**
+   * \brief Runs many independent optimizations, e.g. thousands of small fits,
+   *        on a shared thread pool. Every optimization is driven through
+   *        ask / eval / tell / stop, a few generations at a time, and the
+   *        generations of all the running optimizations are interleaved on the
+   *        pool, so that threads remain busy until the last optimization ends.
+   *        Optimizations do not share any state, and with a group seed every
+   *        one of them gets its own seed derived from the group seed and its
+   *        index, so that results do not depend on scheduling nor on the number
+   *        of threads.
+   *        Objective functions run concurrently, and must be thread-safe when
+   *        they share data. Restart strategies, that have their own optimization
+   *        loop, are not supported, nor are the initial elitist and the final
+   *        EDM computation options.
+   */
+  template <class TESOStrategy=CMAStrategy<CovarianceUpdate>,class TParameters=CMAParameters<>,class TSolutions=CMASolutions>
+    class OptimizerGroup
+    {
+    public:
+      /**
+       * \brief constructor.
+       * @param nthreads number of threads of the shared pool, 0 for the default
+       * @param seed group seed from which job seeds are derived, 0 to keep the seeds of the jobs' parameters
+       */
+      OptimizerGroup(const int &nthreads=0,
+		     const uint64_t &seed=0)
+	:_pool(ThreadPool::shared(nthreads)),_seed(seed)
+	{
+	}
+
+      ~OptimizerGroup() {}
+
+      /**
+       * \brief adds an optimization to the group.
+       * @param func function to minimize
+       * @param parameters optimization parameters, copied
+       * @param pfunc progress function, when null the strategy default progress function is kept (it logs unless quiet)
+       * @return index of the optimization within the group
+       */
+      int add(FitFunc &func,
+	      const TParameters &parameters,
+	      ProgressFunc<TParameters,TSolutions> pfunc=nullptr)
+      {
+	int j = static_cast<int>(_jobs.size());
+	TParameters p = parameters;
+	if (_seed != 0)
+	  p.set_seed(job_seed(j));
+	std::unique_ptr<Job> job(new Job());
+	job->_optim.reset(new ESOptimizer<TESOStrategy,TParameters,TSolutions>(func,p));
+	if (pfunc)
+	  job->_optim->set_progress_func(pfunc);
+	_jobs.push_back(std::move(job));
+	return j;
+      }
+
+      /**
+       * \brief sets the number of generations an optimization runs each time it is scheduled.
+       *        Larger values lower the scheduling overhead, smaller values balance
+       *        the threads better towards the end.
+       * @param steps number of generations
+       */
+      void set_steps(const int &steps) { _steps = std::max(1,steps); }
+
+      /**
+       * \brief runs all the optimizations of the group to completion.
+       *        An exception thrown by an optimization ends that optimization only,
+       *        see error().
+       * @return OPTI_SUCCESS if every optimization succeeded, OPTI_ERR_TERMINATION otherwise
+       */
+      int optimize()
+      {
+	std::vector<int> active;
+	for (int j=0;j<size();j++)
+	  if (!_jobs[j]->_done)
+	    active.push_back(j);
+	while (!active.empty())
+	  {
+	    _pool->parallel_for(static_cast<int>(active.size()),[&](const int &a)
+	      {
+		run(*_jobs[active[a]]);
+	      });
+	    active.erase(std::remove_if(active.begin(),active.end(),
+					[this](const int &j){ return _jobs[j]->_done; }),active.end());
+	  }
+	for (int j=0;j<size();j++)
+	  if (_jobs[j]->_status != OPTI_SUCCESS)
+	    return OPTI_ERR_TERMINATION;
+	return OPTI_SUCCESS;
+      }
+
+      /**
+       * \brief number of optimizations in the group.
+       * @return size
+       */
+      int size() const { return static_cast<int>(_jobs.size()); }
+
+      /**
+       * \brief solutions of an optimization.
+       * @param j index of the optimization
+       * @return solutions
+       */
+      TSolutions& get_solutions(const int &j) { return _jobs.at(j)->_optim->get_solutions(); }
+
+      /**
+       * \brief parameters of an optimization, with its derived seed.
+       * @param j index of the optimization
+       * @return parameters
+       */
+      TParameters& get_parameters(const int &j) { return _jobs.at(j)->_optim->get_parameters(); }
+
+      /**
+       * \brief return code of an optimization, as returned by ESOptimizer::optimize().
+       * @param j index of the optimization
+       * @return OPTI_SUCCESS, OPTI_ERR_TERMINATION, or OPTI_ERR_UNKNOWN if the optimization threw
+       */
+      int status(const int &j) const { return _jobs.at(j)->_status; }
+
+      /**
+       * \brief exception thrown by an optimization, if any.
+       * @param j index of the optimization
+       * @return exception, null if none
+       */
+      std::exception_ptr error(const int &j) const { return _jobs.at(j)->_error; }
+
+      /**
+       * \brief seed of the j-th optimization, given the group seed.
+       * @param j index of the optimization
+       * @return seed
+       */
+      int job_seed(const int &j) const
+      {
+	// splitmix64 finalizer, so that neighbouring jobs get unrelated streams.
+	uint64_t z = _seed + 0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(j) + 1);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+	return static_cast<int>(z % 0x7FFFFFFFULL) + 1;
+      }
+
+    private:
+      struct Job
+      {
+	std::unique_ptr<ESOptimizer<TESOStrategy,TParameters,TSolutions>> _optim;
+	bool _done = false;
+	int _status = OPTI_SUCCESS;
+	std::exception_ptr _error;
+	dMat _phenocandidates; /**< pheno transformed candidates, reused across generations. */
+      };
+
+      /**
+       * \brief runs a few generations of an optimization.
+       * @param job the optimization
+       */
+      void run(Job &job)
+      {
+	ESOptimizer<TESOStrategy,TParameters,TSolutions> &optim = *job._optim;
+	TSolutions &sols = optim.get_solutions();
+	std::chrono::time_point<std::chrono::system_clock> tstart = std::chrono::system_clock::now();
+	try
+	  {
+	    for (int s=0;s<_steps;s++)
+	      {
+		if (optim.stop())
+		  {
+		    job._done = true;
+		    job._status = sols.run_status() >= 0 ? OPTI_SUCCESS : OPTI_ERR_TERMINATION;
+		    break;
+		  }
+		std::chrono::time_point<std::chrono::system_clock> tistart = std::chrono::system_clock::now();
+		const dMat &candidates = optim.ask();
+		optim.eval(candidates,optim.get_parameters().get_gp().pheno(candidates,job._phenocandidates));
+		optim.tell();
+		optim.inc_iter();
+		sols._elapsed_last_iter = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()-tistart).count();
+	      }
+	  }
+	catch (...)
+	  {
+	    job._done = true;
+	    job._status = OPTI_ERR_UNKNOWN;
+	    job._error = std::current_exception();
+	  }
+	// time spent on this optimization only, not waiting for the others.
+	sols._elapsed_time += std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()-tstart).count();
+      }
+
+      std::shared_ptr<ThreadPool> _pool; /**< threads shared by all the optimizations. */
+      uint64_t _seed = 0; /**< group seed, 0 when jobs keep their own seeds. */
+      int _steps = 1; /**< generations per scheduled run of an optimization. */
+      std::vector<std::unique_ptr<Job>> _jobs; /**< the optimizations. */
+    };
+
+}
+
+#endif
@@ -25,6 +25,8 @@
 #include <libcmaes/eo_matrix.h>
 #include <libcmaes/genopheno.h>
 #include <libcmaes/llogging.h>
+#include <libcmaes/evaluator.h>
+#include <libcmaes/evalcache.h>
 #include <string>
 #include <cmath>
 #include <limits>
@@ -46,10 +48,16 @@ namespace libcmaes
       template <class U> friend class CMAStopCriteria;
       template <class U, class V> friend class IPOPCMAStrategy;
       template <class U, class V> friend class BIPOPCMAStrategy;
+      template <class U, class V> friend class AsyncCMAStrategy;
+      template <class U> friend class LockstepCMA;
+      template <int D, class U> friend class FixedCMAStrategy;
       friend class CovarianceUpdate;
       friend class ACovarianceUpdate;
       template <class U> friend class errstats;
       friend class VDCMAUpdate;
+      friend class CholeskyCovarianceUpdate;
+      friend class LMCMAUpdate;
+      friend class VkDCMAUpdate;
       friend class Candidate;
 #ifdef HAVE_SURROG
       template <template <class X,class Y> class U, class V, class W> friend class SimpleSurrogateStrategy;
@@ -363,7 +371,7 @@ namespace libcmaes
       
       /**
        * \brief sets the optimization algorithm.
-       * @param algo from CMAES_DEFAULT, IPOP_CMAES, BIPOP_CMAES, aCMAES, aIPOP_CMAES, aBIPOP_CMAES, sepCMAES, sepIPOP_CMAES, sepBIPOP_CMAES, sepaCMAES, sepaIPOP_CMAES, sepaBIPOP_CMAES, VD_CMAES, VD_IPOP_CMAES, VD_BIPOP_CMAES 
+       * @param algo from CMAES_DEFAULT, IPOP_CMAES, BIPOP_CMAES, aCMAES, aIPOP_CMAES, aBIPOP_CMAES, sepCMAES, sepIPOP_CMAES, sepBIPOP_CMAES, sepaCMAES, sepaIPOP_CMAES, sepaBIPOP_CMAES, VD_CMAES, VD_IPOP_CMAES, VD_BIPOP_CMAES, CHOL_CMAES, CHOL_IPOP_CMAES, CHOL_BIPOP_CMAES, LM_CMAES, LM_IPOP_CMAES, LM_BIPOP_CMAES, VKD_CMAES, VKD_IPOP_CMAES, VKD_BIPOP_CMAES
        */
       void set_algo(const int &algo)
       {
@@ -480,6 +488,68 @@ namespace libcmaes
       {
 	return _mt_feval;
       }
+
+      /**
+       * \brief sets the number of threads of the parallel evaluation of objective function.
+       * @param n number of threads, 0 for the hardware concurrency divided by Eigen's number of threads
+       */
+      void set_feval_threads(const int &n)
+      {
+	_feval_threads = n;
+      }
+
+      /**
+       * \brief returns the number of threads of the parallel evaluation of objective function.
+       * @return number of threads, 0 when automatic
+       */
+      inline int get_feval_threads() const
+      {
+	return _feval_threads;
+      }
+
+      /**
+       * \brief sets a custom evaluator, that runs the objective function calls of a
+       *        generation, of numerical gradients and of uncertainty handling re-evaluations.
+       *        Evaluators may be shared among several optimizers.
+       * @param evaluator the evaluator, or nullptr for the built-in one
+       */
+      void set_evaluator(const std::shared_ptr<Evaluator> &evaluator)
+      {
+	_evaluator = evaluator;
+      }
+
+      /**
+       * \brief returns the custom evaluator, if any.
+       * @return evaluator, nullptr when built-in
+       */
+      inline std::shared_ptr<Evaluator> get_evaluator() const
+      {
+	return _evaluator;
+      }
+
+      /**
+       * \brief activates a cache of objective function values, keyed on the phenotype,
+       *        so that points that were already evaluated are not evaluated again.
+       *        The cache is shared by copies of the parameters, e.g. across restarts and
+       *        error estimation. Function evaluation counts still include cached values.
+       * @param capacity maximum number of cached values, 0 deactivates the cache
+       * @param quantum coordinates are rounded to a multiple of quantum before matching, 0 for exact matching
+       */
+      void set_fcache(const int &capacity, const double &quantum=0.0)
+      {
+	if (capacity > 0)
+	  _fcache = std::make_shared<EvalCache>(capacity,quantum);
+	else _fcache = nullptr;
+      }
+
+      /**
+       * \brief returns the cache of objective function values, if any.
+       * @return cache, nullptr when deactivated
+       */
+      inline std::shared_ptr<EvalCache> get_fcache() const
+      {
+	return _fcache;
+      }
       
       /**
        * \brief sets maximum history size, allows to keep memory requirements fixed.
@@ -490,6 +560,17 @@ namespace libcmaes
 	_max_hist = m;
       }
 
+      /**
+       * \brief keeps the best candidates of the history, with their parameter vectors,
+       *        instead of their objective function values only.
+       * @param b whether to keep the best candidates
+       * @see CMASolutions::best_candidates_hist
+       */
+      void set_full_hist(const bool &b)
+      {
+	_full_hist = b;
+      }
+
       /**
        * \brief active internal maximization scheme (simply returns -f instead of f)
        * @param maximize whether to maximize instead of minimizing
@@ -579,7 +660,11 @@ namespace libcmaes
       TGenoPheno _gp; /**< genotype / phenotype object. */
       
       bool _mt_feval = false; /**< whether to force multithreaded (i.e. parallel) function evaluations. */ 
+      int _feval_threads = 0; /**< number of threads of parallel function evaluations, 0 for automatic. */
+      std::shared_ptr<Evaluator> _evaluator; /**< custom evaluator, built-in thread pool when unset. */
+      std::shared_ptr<EvalCache> _fcache; /**< cache of objective function values, when active. */
       int _max_hist = -1; /**< max size of the history, keeps memory requirements fixed. */
+      bool _full_hist = false; /**< whether the history keeps the best candidates, and not only their values. */
 
       bool _maximize = false; /**< convenience option of maximizing -f instead of minimizing f. */
       static std::map<std::string,int> _algos; /**< of the form { {"cmaes",0}, {"ipop",1}, ...} */
@@ -0,0 +1,179 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROCESSPOOL_H
+#define PROCESSPOOL_H
+
+#include <libcmaes/esostrategy.h>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace libcmaes
+{
+  /**
+   * \brief Pool of local worker processes that evaluate the objective function,
+   *        for objective functions that are not thread-safe, leak or crash.
+   *        Candidates are written to slots of a memory region shared with the workers,
+   *        and a doorbell with the slot number is sent to a worker over a Unix socket.
+   *        Each worker owns a ring of slots, so that its next candidate is ready
+   *        when it completes one. A worker that dies is restarted, and its candidates
+   *        are issued again.
+   *        The pool evaluates whole populations, as a batch objective function:
+   *        \code
+   *        ProcessPool pool({"./objective"},8,dim);
+   *        BatchFitFunc bfunc = pool.batch_func();
+   *        CMASolutions cmasols = cmaes<>(bfunc,cmaparams);
+   *        \endcode
+   *        The objective binary runs the worker loop when started by the pool:
+   *        \code
+   *        int main(int argc, char *argv[])
+   *        {
+   *          if (ProcessPool::is_worker())
+   *            return ProcessPool::worker_main(objective);
+   *          ...
+   *        }
+   *        \endcode
+   *        Available on POSIX systems only.
+   */
+  class CMAES_EXPORT ProcessPool
+  {
+  public:
+    /**
+     * \brief constructor, with workers that execute a command.
+     * @param command worker program and its arguments, the program calls worker_main
+     * @param nworkers number of worker processes
+     * @param dim dimension of the candidates
+     * @param depth number of slots per worker
+     */
+    ProcessPool(const std::vector<std::string> &command,
+		const int &nworkers,
+		const int &dim,
+		const int &depth=2);
+
+    /**
+     * \brief constructor, with workers that are forks of this process and run
+     *        the worker loop on func.
+     *        A fork copies only the calling thread, and locks held by other threads
+     *        remain locked in the worker, so the process must be single-threaded
+     *        whenever a worker is started, including restarts. Use the constructor
+     *        with a worker command otherwise.
+     * @param func objective function
+     * @param nworkers number of worker processes
+     * @param dim dimension of the candidates
+     * @param depth number of slots per worker
+     * @throw std::runtime_error when the process runs more than one thread, on Linux
+     */
+    ProcessPool(FitFunc &func,
+		const int &nworkers,
+		const int &dim,
+		const int &depth=2);
+
+    /**
+     * \brief stops the workers, and waits for them to exit.
+     */
+    ~ProcessPool();
+
+    ProcessPool(const ProcessPool&) = delete;
+    ProcessPool& operator=(const ProcessPool&) = delete;
+
+    /**
+     * \brief evaluates candidates with the workers.
+     * @param x candidates, one per column
+     * @param fvalues objective function values, one per column of x
+     * @throw std::runtime_error when a candidate kills its worker more than the maximum number of retries,
+     *        or when a forked worker must be restarted in a multithreaded process
+     */
+    void eval(const dMat &x, dVec &fvalues);
+
+    /**
+     * \brief batch objective function that evaluates with the pool.
+     *        The pool must outlive it.
+     * @return batch objective function
+     */
+    BatchFitFunc batch_func();
+
+    /**
+     * \brief sets the number of times a candidate is issued again after its
+     *        worker died, before giving up.
+     * @param r maximum number of retries
+     */
+    void set_max_retries(const int &r) { _max_retries = r; }
+
+    /**
+     * \brief number of worker processes.
+     * @return number of workers
+     */
+    int nworkers() const { return static_cast<int>(_workers.size()); }
+
+    /**
+     * \brief number of worker restarts since the pool was created.
+     * @return number of restarts
+     */
+    int restarts() const { return _restarts; }
+
+    /**
+     * \brief whether this process was started by a pool, as a worker.
+     * @return true if worker
+     */
+    static bool is_worker();
+
+    /**
+     * \brief worker loop, evaluates the candidates the pool sends until it stops.
+     *        To be called from the worker program.
+     * @param func objective function
+     * @return exit code for the worker program
+     */
+    static int worker_main(FitFunc &func);
+
+  private:
+    struct Worker
+    {
+      int _pid = -1; /**< process id. */
+      int _sock = -1; /**< pool end of the doorbell socket. */
+      std::deque<int> _inflight; /**< candidates issued to the worker, in order. */
+      int _next_slot = 0; /**< next slot of the worker's ring. */
+    };
+
+    void init();
+    void spawn(const int &w);
+    void reap(const int &w);
+    void reset();
+    bool issue(const int &w, const int &c, const dMat &x);
+    double* slot(const int &w, const int &s) const;
+
+    std::vector<std::string> _command; /**< worker program, empty when workers are forks. */
+    FitFunc _func; /**< objective function of the forked workers. */
+    int _dim = 0;
+    int _depth = 2;
+    int _max_retries = 3;
+    int _restarts = 0;
+    int _shm = -1; /**< shared memory file. */
+    double *_slots = nullptr; /**< shared memory, depth slots of dim+1 values per worker. */
+    size_t _shm_size = 0;
+    std::vector<Worker> _workers;
+    std::mutex _mtx; /**< serializes batches. */
+  };
+
+}
+
+#endif
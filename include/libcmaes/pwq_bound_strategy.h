@@ -45,6 +45,37 @@ namespace libcmaes
 
     void shift_into_feasible(const dVec &x, dVec &x_s) const;
 
+    /**
+     * \brief pheno transform of a candidate, in place, with the same result
+     *        as to_f_representation into another vector.
+     * @param x candidate, transformed in place
+     */
+    void to_f_representation(Eigen::Ref<dVec> x) const;
+
+    /**
+     * \brief pheno transform of a population, in place, one candidate per
+     *        column. Candidates are shifted into the feasible domain and
+     *        transformed in a single pass, with the same result as
+     *        to_f_representation on every column.
+     * @param x candidates, transformed in place
+     */
+    void to_f_representation(dMat &x) const;
+
+    /**
+     * \brief geno transform of a population, in place, one candidate per
+     *        column, with the same result as to_internal_representation on
+     *        every column.
+     * @param x candidates, transformed in place
+     */
+    void to_internal_representation(dMat &x) const;
+
+    /**
+     * \brief shifts a population into the feasible domain, in place, one
+     *        candidate per column.
+     * @param x candidates, shifted in place
+     */
+    void shift_into_feasible(dMat &x) const;
+
     double getLBound(const int &k) const { return _lbounds[k]; }
     double getUBound(const int &k) const { return _ubounds[k]; }
     double getPhenoLBound(const int &k) const { return _phenolbounds[k]; }
@@ -61,6 +92,34 @@ namespace libcmaes
     }
     
   private:
+    /**
+     * \brief shifts a candidate into the feasible domain, in place, then
+     *        applies the pheno transform when requested.
+     * @param x candidate
+     * @param to_f whether to apply the pheno transform
+     */
+    void shift_col(Eigen::Ref<dVec> x, const bool &to_f) const;
+
+    /**
+     * \brief geno transform of a candidate, in place.
+     * @param x candidate
+     */
+    void to_internal_col(Eigen::Ref<dVec> x) const;
+
+    /**
+     * \brief branch-free kernels on the coordinates of a candidate from i,
+     *        by blocks of P, an Eigen packet or a double.
+     * @return index of the first coordinate left, short of a whole block
+     */
+    template <class P>
+      int far_blocks(const double *x, const int &n, int i, bool &far) const;
+    template <class P>
+      int mirror_blocks(double *x, const int &n, int i, bool &err) const;
+    template <class P>
+      int to_f_blocks(double *x, const int &n, int i) const;
+    template <class P>
+      int to_internal_blocks(double *x, const int &n, int i) const;
+    
     dVec _lbounds;
     dVec _ubounds;
     dVec _al;
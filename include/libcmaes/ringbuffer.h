@@ -0,0 +1,269 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace libcmaes
+{
+  /**
+   * \brief Fixed capacity history of values, oldest first. Once full, a new
+   *        value overwrites the oldest one in place, so that appending is O(1)
+   *        and performs no allocation. The capacity may change along a run,
+   *        e.g. grow with the number of iterations, its storage then only
+   *        reallocates when the capacity exceeds twice the previous storage.
+   */
+  template <class T>
+    class RingBuffer
+    {
+    public:
+      /**
+       * \brief constructor.
+       * @param capacity maximum number of values, none are kept when 0
+       */
+      RingBuffer(const int &capacity=0)
+      {
+	set_capacity(capacity);
+      }
+
+      /**
+       * \brief sets the maximum number of values, drops the oldest values beyond it.
+       * @param capacity maximum number of values
+       */
+      void set_capacity(const int &capacity)
+      {
+	while (_size > capacity)
+	  pop_front();
+	if (capacity > static_cast<int>(_buf.size()))
+	  {
+	    std::vector<T> buf(std::max(capacity,2*static_cast<int>(_buf.size())));
+	    for (int i=0;i<_size;i++)
+	      buf[i] = std::move((*this)[i]);
+	    _buf.swap(buf);
+	    _first = 0;
+	  }
+	_capacity = std::max(0,capacity);
+      }
+
+      /**
+       * \brief appends a value, drops the oldest one when full.
+       * @param v value
+       */
+      void push_back(const T &v)
+      {
+	if (_capacity == 0)
+	  return;
+	if (_size == _capacity)
+	  pop_front();
+	_buf[(_first+_size)%_buf.size()] = v;
+	++_size;
+      }
+
+      /**
+       * \brief drops the oldest value.
+       */
+      void pop_front()
+      {
+	_first = (_first+1)%_buf.size();
+	--_size;
+      }
+
+      /**
+       * \brief drops the newest value.
+       */
+      void pop_back()
+      {
+	--_size;
+      }
+
+      /**
+       * \brief value access, oldest first.
+       * @param i index, 0 is the oldest value
+       * @return value
+       */
+      inline const T& operator[](const int &i) const
+      {
+	return _buf[(_first+i)%_buf.size()];
+      }
+
+      inline T& operator[](const int &i)
+      {
+	return _buf[(_first+i)%_buf.size()];
+      }
+
+      inline const T& front() const { return (*this)[0]; }
+      inline const T& back() const { return (*this)[_size-1]; }
+      inline int size() const { return _size; }
+      inline bool empty() const { return _size == 0; }
+      inline int capacity() const { return _capacity; }
+
+      /**
+       * \brief drops all values, keeps the capacity and the storage.
+       */
+      void clear()
+      {
+	_first = _size = 0;
+      }
+
+    private:
+      std::vector<T> _buf; /**< storage, at least capacity long. */
+      int _first = 0; /**< index of the oldest value in storage. */
+      int _size = 0; /**< number of values. */
+      int _capacity = 0; /**< maximum number of values. */
+    };
+
+  /**
+   * \brief Minimum and maximum of the last values of a series, over a sliding
+   *        window, each kept by a monotonic queue of the values that may
+   *        still become the extremum, in amortized O(1) per value.
+   */
+  class WindowExtrema
+  {
+  public:
+    /**
+     * \brief constructor.
+     * @param window number of last values
+     */
+    WindowExtrema(const int &window=0)
+    {
+      set_window(window);
+    }
+
+    /**
+     * \brief sets the number of last values, drops all values.
+     * @param window number of last values
+     */
+    void set_window(const int &window)
+    {
+      _window = std::max(0,window);
+      _min.set_capacity(_window);
+      _max.set_capacity(_window);
+      clear();
+    }
+
+    /**
+     * \brief appends a value to the series.
+     * @param v value
+     */
+    void push_back(const double &v)
+    {
+      if (_window == 0)
+	return;
+      long t = _n++;
+      while (!_min.empty() && _min.front().first <= t-_window)
+	_min.pop_front();
+      while (!_max.empty() && _max.front().first <= t-_window)
+	_max.pop_front();
+      while (!_min.empty() && _min.back().second >= v)
+	_min.pop_back();
+      _min.push_back(std::make_pair(t,v));
+      while (!_max.empty() && _max.back().second <= v)
+	_max.pop_back();
+      _max.push_back(std::make_pair(t,v));
+    }
+
+    inline double min() const { return _min.front().second; }
+    inline double max() const { return _max.front().second; }
+    inline int window() const { return _window; }
+
+    /**
+     * \brief number of values in the window.
+     */
+    inline int size() const { return static_cast<int>(std::min(_n,static_cast<long>(_window))); }
+
+    void clear()
+    {
+      _min.clear();
+      _max.clear();
+      _n = 0;
+    }
+
+  private:
+    RingBuffer<std::pair<long,double>> _min; /**< increasing values, with their position in the series. */
+    RingBuffer<std::pair<long,double>> _max; /**< decreasing values, with their position in the series. */
+    int _window = 0; /**< number of last values. */
+    long _n = 0; /**< number of values in the series. */
+  };
+
+  /**
+   * \brief Values of a sliding window kept sorted, for a median in O(1), at
+   *        the cost of O(size) moves per insertion or removal, without
+   *        allocation once the window size has been reserved.
+   */
+  class SortedWindow
+  {
+  public:
+    /**
+     * \brief constructor.
+     * @param size number of values to reserve memory for
+     */
+    SortedWindow(const int &size=0)
+    {
+      _v.reserve(size);
+    }
+
+    /**
+     * \brief adds a value.
+     * @param v value
+     */
+    void insert(const double &v)
+    {
+      _v.insert(std::upper_bound(_v.begin(),_v.end(),v),v);
+    }
+
+    /**
+     * \brief removes a value, no-op if not found.
+     * @param v value
+     */
+    void erase(const double &v)
+    {
+      std::vector<double>::iterator vit = std::lower_bound(_v.begin(),_v.end(),v);
+      if (vit == _v.end() || !(*vit == v)) // e.g. NaN, that does not order.
+	vit = std::find_if(_v.begin(),_v.end(),[&v](const double &x){ return x == v || (x != x && v != v); });
+      if (vit != _v.end())
+	_v.erase(vit);
+    }
+
+    /**
+     * \brief median of the values, as the middle value or the mean of the two middle values.
+     * @return median
+     */
+    inline double median() const
+    {
+      size_t size = _v.size();
+      if (size % 2 == 0)
+	return (_v[size/2-1] + _v[size/2]) / 2;
+      else return _v[size/2];
+    }
+
+    inline int size() const { return static_cast<int>(_v.size()); }
+    inline void clear() { _v.clear(); }
+
+  private:
+    std::vector<double> _v; /**< values, in increasing order. */
+  };
+}
+
+#endif
@@ -65,6 +65,11 @@ namespace libcmaes
       y = x;
     }
 
+    void scale_to_f(Eigen::Ref<dVec> x) const
+    {
+      (void)x;
+    }
+
     void remove_dimensions(const std::vector<int> &k)
     {
       (void)k;
@@ -132,6 +137,15 @@ namespace libcmaes
       y = y.cwiseQuotient(_scaling);
     }
 
+    /**
+     * \brief scaling of a candidate, in place.
+     * @param x candidate, scaled in place
+     */
+    void scale_to_f(Eigen::Ref<dVec> x) const
+    {
+      x = (x - _shift).cwiseQuotient(_scaling);
+    }
+
     bool is_id() const { return _id; }
 
     void remove_dimensions(const std::vector<int> &k)
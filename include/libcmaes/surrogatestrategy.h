@@ -312,7 +312,7 @@ namespace libcmaes
      * 
      * @return A matrix whose rows contain the candidate points.
      */
-    dMat ask();
+    const dMat& ask();
 
     /**
      * \brief Evaluates a set of candiates against the objective function 
@@ -0,0 +1,83 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VKDCMAUPDATE_H
+#define VKDCMAUPDATE_H
+
+#include <libcmaes/cmaparameters.h>
+#include <libcmaes/cmasolutions.h>
+#include <libcmaes/eigenmvn.h>
+
+namespace libcmaes
+{
+
+  /**
+   * \brief VkD-CMA update, the rank-k generalization of VD-CMA, with covariance
+   *        matrix C = D(I+VSV^T)D where D is diagonal, V holds k orthonormal
+   *        columns and S k non-negative scalings. Sampling is in O(k n). The
+   *        update projects the regular rank-one and rank-mu update onto this
+   *        model in O((k+mu)^2 n), and the n x n matrix is never formed.
+   *        This implementation follows the projection principle of:
+   *        Y. Akimoto and N. Hansen, "Projection-Based Restricted Covariance
+   *        Matrix Adaptation for High Dimension", GECCO 2016.
+   */
+  class CMAES_EXPORT VkDCMAUpdate
+  {
+  public:
+    /**
+     * \brief update the restricted covariance model, the mean and the step-size.
+     * @param parameters current set of parameters
+     * @param esolver Eigen eigenvalue solver (unused)
+     * @param solutions currrent set of solutions.
+     */
+    template <class TGenoPheno>
+    static void update(const CMAParameters<TGenoPheno> &parameters,
+		       Eigen::EigenMultivariateNormal<double> &esolver,
+		       CMASolutions &solutions);
+
+    /**
+     * \brief applies (I+VSV^T)^1/2, or its inverse, to every column of z in place, in O(k n).
+     * @param solutions current set of solutions that holds V and S
+     * @param z vectors to be transformed, one per column
+     * @param inverse whether to apply (I+VSV^T)^-1/2 instead
+     */
+    static void sqrt_transform(const CMASolutions &solutions,
+			       dMat &z,
+			       const bool &inverse=false);
+
+    /**
+     * \brief diagonal of the covariance matrix, in O(k n).
+     * @param solutions current set of solutions that holds D, V and S
+     * @return diagonal of the covariance matrix
+     */
+    static dVec cov_diagonal(const CMASolutions &solutions);
+
+    /**
+     * \brief full covariance matrix, in O(k n^2), to be used for inspection only.
+     * @param solutions current set of solutions that holds D, V and S
+     * @return covariance matrix
+     */
+    static dMat full_cov(const CMASolutions &solutions);
+  };
+  
+}
+
+#endif
@@ -31,25 +31,32 @@ namespace libcmaes
 				 CMASolutions &solutions)
   {
     // compute mean, Eq. (2)
-    dVec xmean = dVec::Zero(parameters._dim);
+    dVec &xmean = solutions._ws._xmean;
+    xmean.setZero();
     for (int i=0;i<parameters._mu;i++)
-      xmean += parameters._weights[i] * (solutions._candidates.at(i).get_x_dvec() - solutions._xmean);
+      xmean += parameters._weights[i] * (solutions._candidates.at(i).get_x_map() - solutions._xmean);
     xmean *= parameters._cm;
     xmean += solutions._xmean;
   
      // reusable variables.
-    dVec diffxmean = 1.0/(solutions._sigma*parameters._cm) * (xmean-solutions._xmean); // (m^{t+1}-m^t)/(c_m*sigma^t)
+    dVec &diffxmean = solutions._ws._diffxmean;
+    diffxmean = 1.0/(solutions._sigma*parameters._cm) * (xmean-solutions._xmean); // (m^{t+1}-m^t)/(c_m*sigma^t)
     if (solutions._updated_eigen && !parameters._sep)
-      solutions._csqinv = esolver._eigenSolver.operatorInverseSqrt();
+      {
+	// C^{-1/2} = V.D^{-1}.V^T, through the workspace instead of operatorInverseSqrt() temporaries.
+	dMat &vd = solutions._ws._nn;
+	vd.resize(parameters._dim,parameters._dim);
+	vd.noalias() = esolver._eigenSolver.eigenvectors() * esolver._eigenSolver.eigenvalues().cwiseInverse().cwiseSqrt().asDiagonal();
+	solutions._csqinv.noalias() = vd * esolver._eigenSolver.eigenvectors().transpose();
+      }
     else if (parameters._sep)
       solutions._sepcsqinv = solutions._sepcov.cwiseInverse().cwiseSqrt();
     
     // update psigma, Eq. (3)
+    solutions._psigma *= (1.0-parameters._csigma);
     if (!parameters._sep)
-      solutions._psigma = (1.0-parameters._csigma)*solutions._psigma
-	+ parameters._fact_ps * solutions._csqinv * diffxmean;
-    else solutions._psigma = (1.0-parameters._csigma)*solutions._psigma
-	   + parameters._fact_ps * solutions._sepcsqinv.cwiseProduct(diffxmean);
+      solutions._psigma.noalias() += parameters._fact_ps * solutions._csqinv * diffxmean;
+    else solutions._psigma += parameters._fact_ps * solutions._sepcsqinv.cwiseProduct(diffxmean);
     double norm_ps = solutions._psigma.norm();
 
     // update pc, Eq. (4-5)
@@ -58,57 +65,59 @@ namespace libcmaes
     if (norm_ps < val_for_hsig)
       solutions._hsig = 1; //TODO: simplify equation instead.
     solutions._pc = (1.0-parameters._cc) * solutions._pc + solutions._hsig * parameters._fact_pc * diffxmean;
-    dMat spc;
-    if (!parameters._sep)
-      spc = solutions._pc * solutions._pc.transpose();
-    else spc = solutions._pc.cwiseProduct(solutions._pc);
     
-    // Cmu+, Eq. (6)
-    dMat cmuplus;
+    // weighted best (Cmu+, Eq. (6)) and worst (Cmu-, Eq. (7)) steps, one per column,
+    // or their weighted squares summed up when sep, as the diagonal is already O(mu n).
+    dMat &ysplus = solutions._ws._ys;
+    dMat &ysminus = solutions._ws._ysminus;
+    dVec &cmuplus = solutions._ws._sepplus;
+    dVec &cmuminus = solutions._ws._sepminus;
     if (!parameters._sep)
-      cmuplus = dMat::Zero(parameters._dim,parameters._dim);
-    else cmuplus = dMat::Zero(parameters._dim,1);
-    for (int i=0;i<parameters._mu;i++)
       {
-	dVec difftmp = solutions._candidates.at(i).get_x_dvec() - solutions._xmean;
-	if (!parameters._sep)
-	  cmuplus += parameters._weights[i] * (difftmp*difftmp.transpose());
-	else cmuplus += parameters._weights[i] * (difftmp.cwiseProduct(difftmp));
+	ysplus.resize(parameters._dim,parameters._mu);
+	ysminus.resize(parameters._dim,parameters._mu);
+	for (int i=0;i<parameters._mu;i++)
+	  {
+	    double sw = std::sqrt(parameters._weights[i])/solutions._sigma;
+	    ysplus.col(i) = sw * (solutions._candidates.at(i).get_x_map() - solutions._xmean);
+	    //dVec yl = (solutions._csqinv * (solutions._candidates.at(parameters._lambda-parameters._mu+i)._x-solutions._xmean)).norm() / (solutions._csqinv * ytmp).norm() * ytmp * 1.0/solutions._sigma;
+	    ysminus.col(i) = sw * (solutions._candidates.at(parameters._lambda-i-1).get_x_map() - solutions._xmean); // NH says this is a good enough value.
+	  }
       }
-    cmuplus *= 1.0/(solutions._sigma*solutions._sigma);
-        
-    // Cmu-, Eq. (7)
-    dMat cmuminus;
-    if (!parameters._sep)
-      cmuminus = dMat::Zero(parameters._dim,parameters._dim);
-    else cmuminus = dMat::Zero(parameters._dim,1);
-    for (int i=0;i<parameters._mu;i++)
+    else
       {
-	dVec ytmp = solutions._candidates.at(parameters._lambda-i-1).get_x_dvec()-solutions._xmean;
-	//dVec yl = (solutions._csqinv * (solutions._candidates.at(parameters._lambda-parameters._mu+i)._x-solutions._xmean)).norm() / (solutions._csqinv * ytmp).norm() * ytmp * 1.0/solutions._sigma;
-	dVec yl = ytmp * 1.0/solutions._sigma; // NH says this is a good enough value.
-	if (!parameters._sep)
-	  cmuminus += parameters._weights[i] * yl*yl.transpose();
-	else cmuminus += parameters._weights[i] * yl.cwiseProduct(yl);
+	cmuplus.setZero(parameters._dim);
+	cmuminus.setZero(parameters._dim);
+	for (int i=0;i<parameters._mu;i++)
+	  {
+	    cmuplus += parameters._weights[i] * (solutions._candidates.at(i).get_x_map() - solutions._xmean).cwiseAbs2();
+	    cmuminus += parameters._weights[i] * ((solutions._candidates.at(parameters._lambda-i-1).get_x_map() - solutions._xmean) / solutions._sigma).cwiseAbs2();
+	  }
+	cmuplus *= 1.0/(solutions._sigma*solutions._sigma);
       }
     
     // covariance update, Eq. (8)
-    dMat cminusdenom;
-    if (!parameters._sep)
-      cminusdenom = solutions._csqinv*cmuminus*solutions._csqinv;
-    else cminusdenom = solutions._sepcsqinv.cwiseProduct(cmuminus.cwiseProduct(solutions._sepcsqinv));
     double cminustmp = parameters._lambdamintarget;
     if (!parameters._sep)
       {
-	Eigen::SelfAdjointEigenSolver<dMat> tmpesolve(cminusdenom); // XXX: computing eigenvalues, could be avoid with an upper bound.
-	cminustmp = tmpesolve.eigenvalues().maxCoeff();
+	dMat &zsminus = solutions._ws._zs;
+	zsminus.resize(parameters._dim,parameters._mu);
+	zsminus.noalias() = solutions._csqinv * ysminus; // csqinv*cmuminus*csqinv = zsminus*zsminus^T
+	cminustmp = max_eigenvalue(zsminus,solutions._ws);
       }
-    else cminustmp = cminusdenom.maxCoeff();
+    else cminustmp = solutions._sepcsqinv.cwiseProduct(cmuminus.cwiseProduct(solutions._sepcsqinv)).maxCoeff();
     double cminusmin = parameters._alphaminusmin * (1.0-parameters._cmu)*(1.0-parameters._lambdamintarget) / cminustmp;
     double cminus = std::min(cminusmin,(1-parameters._cmu)*parameters._alphacov/8.0*(parameters._muw/(pow(parameters._dim+2.0,1.5)+2.0*parameters._muw)));
+    double alphacov = 1-parameters._c1-parameters._cmu + cminus*parameters._alphaminusold;
+    double cplus = parameters._cmu + cminus * (1.0-parameters._alphaminusold);
     if (!parameters._sep)
-      solutions._cov = (1-parameters._c1-parameters._cmu + cminus*parameters._alphaminusold)*solutions._cov + parameters._c1*spc + (parameters._cmu + cminus * (1.0-parameters._alphaminusold))*cmuplus - cminus * cmuminus;
-    else solutions._sepcov = (1-parameters._c1-parameters._cmu + cminus*parameters._alphaminusold)*solutions._sepcov + parameters._c1*spc + (parameters._cmu + cminus * (1.0-parameters._alphaminusold))*cmuplus - cminus * cmuminus;
+      {
+	solutions._cov *= alphacov;
+	solutions._cov.noalias() += parameters._c1 * solutions._pc * solutions._pc.transpose();
+	solutions._cov.noalias() += cplus * ysplus * ysplus.transpose();
+	solutions._cov.noalias() -= cminus * ysminus * ysminus.transpose();
+      }
+    else solutions._sepcov = alphacov*solutions._sepcov + parameters._c1*solutions._pc.cwiseProduct(solutions._pc) + cplus*cmuplus - cminus*cmuminus;
     
     // sigma update, Eq. (9)
     if (parameters._tpa < 2)
@@ -121,6 +130,29 @@ namespace libcmaes
     solutions._xmean = xmean;
   }
 
+  double ACovarianceUpdate::max_eigenvalue(const dMat &zs)
+  {
+    CMAWorkspace ws;
+    return max_eigenvalue(zs,ws);
+  }
+
+  double ACovarianceUpdate::max_eigenvalue(const dMat &zs, CMAWorkspace &ws)
+  {
+    dMat &gram = ws._gram;
+    if (zs.cols() < zs.rows())
+      {
+	gram.resize(zs.cols(),zs.cols());
+	gram.noalias() = zs.transpose() * zs;
+      }
+    else
+      {
+	gram.resize(zs.rows(),zs.rows());
+	gram.noalias() = zs * zs.transpose();
+      }
+    ws._gsolver.compute(gram,Eigen::EigenvaluesOnly);
+    return ws._gsolver.eigenvalues().maxCoeff();
+  }
+
   template CMAES_EXPORT void ACovarianceUpdate::update(const CMAParameters<GenoPheno<NoBoundStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
   template CMAES_EXPORT void ACovarianceUpdate::update(const CMAParameters<GenoPheno<pwqBoundStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
   template CMAES_EXPORT void ACovarianceUpdate::update(const CMAParameters<GenoPheno<NoBoundStrategy,linScalingStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
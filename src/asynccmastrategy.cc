@@ -0,0 +1,286 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/asynccmastrategy.h>
+#include <libcmaes/opti_err.h>
+#include <libcmaes/llogging.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <iostream>
+
+namespace libcmaes
+{
+  // a candidate, from its draw to its result.
+  struct AsyncJob
+  {
+    dVec _x; // in genotype.
+    dVec _phenox;
+    int _version = 0; // number of updates of the distribution it was drawn from.
+    double _fvalue = 0.0;
+    double _duration = 0.0; // evaluation time, in seconds.
+  };
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  AsyncCMAStrategy<TCovarianceUpdate,TGenoPheno>::AsyncCMAStrategy(FitFunc &func,
+								   CMAParameters<TGenoPheno> &parameters)
+    :CMAStrategy<TCovarianceUpdate,TGenoPheno>(func,parameters)
+  {
+  }
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  AsyncCMAStrategy<TCovarianceUpdate,TGenoPheno>::AsyncCMAStrategy(FitFunc &func,
+								   CMAParameters<TGenoPheno> &parameters,
+								   const CMASolutions &solutions)
+    :CMAStrategy<TCovarianceUpdate,TGenoPheno>(func,parameters,solutions)
+  {
+  }
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  AsyncCMAStrategy<TCovarianceUpdate,TGenoPheno>::~AsyncCMAStrategy()
+  {
+  }
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  bool AsyncCMAStrategy<TCovarianceUpdate,TGenoPheno>::asynchronous() const
+  {
+    const CMAParameters<TGenoPheno> &p = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters;
+    return !p._with_gradient && p._tpa < 2 && !p._uh
+      && !p._elitist && !p._initial_elitist && !p._initial_elitist_on_restart;
+  }
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  int AsyncCMAStrategy<TCovarianceUpdate,TGenoPheno>::optimize()
+  {
+    if (!asynchronous())
+      return CMAStrategy<TCovarianceUpdate,TGenoPheno>::optimize();
+
+    CMAParameters<TGenoPheno> &p = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters;
+    CMASolutions &sols = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_solutions;
+    _nworkers = p._feval_threads > 0 ? p._feval_threads : ThreadPool::default_nthreads();
+    int outstanding = _outstanding > 0 ? _outstanding : 2*_nworkers;
+    int overdraw = _overdraw >= 0 ? _overdraw
+      : _max_age == 0 ? std::max(1,p._lambda/5) : std::numeric_limits<int>::max()-p._lambda;
+    _rejected = 0;
+    _utilization = 0.0;
+    _busy_utilization = 0.0;
+
+    if (p._initial_fvalue)
+      {
+	sols._initial_candidate = Candidate(this->_func(p._gp.pheno(sols._xmean).data(),p._dim),sols._xmean);
+	sols._best_seen_candidate = sols._initial_candidate;
+	this->update_fevals(1);
+      }
+    if (this->stop())
+      return sols._run_status >= 0 ? OPTI_SUCCESS : OPTI_ERR_TERMINATION;
+
+    // workers take candidates from the job queue, and return them with their f-value.
+    std::mutex mtx;
+    std::condition_variable job_cv;
+    std::condition_variable result_cv;
+    std::deque<AsyncJob> jobs;
+    std::deque<AsyncJob> results;
+    std::exception_ptr error;
+    bool done = false;
+    std::vector<double> busy(_nworkers,0.0);
+    std::vector<std::thread> workers;
+    std::chrono::time_point<std::chrono::steady_clock> tstart = std::chrono::steady_clock::now();
+    for (int w=0;w<_nworkers;w++)
+      workers.emplace_back([&,w]()
+			   {
+			     while(true)
+			       {
+				 AsyncJob job;
+				 {
+				   std::unique_lock<std::mutex> lock(mtx);
+				   job_cv.wait(lock,[&]{ return done || !jobs.empty(); });
+				   if (done)
+				     return;
+				   job = std::move(jobs.front());
+				   jobs.pop_front();
+				 }
+				 std::chrono::time_point<std::chrono::steady_clock> tjob = std::chrono::steady_clock::now();
+				 try
+				   {
+				     job._fvalue = this->_func(job._phenox.data(),job._phenox.size());
+				   }
+				 catch (...)
+				   {
+				     std::lock_guard<std::mutex> lock(mtx);
+				     if (!error)
+				       error = std::current_exception();
+				   }
+				 job._duration = std::chrono::duration<double>(std::chrono::steady_clock::now()-tjob).count();
+				 busy[w] += job._duration;
+				 {
+				   std::lock_guard<std::mutex> lock(mtx);
+				   results.push_back(std::move(job));
+				 }
+				 result_cv.notify_one();
+			       }
+			   });
+
+    // candidates are drawn one at a time from the current distribution, as in a compressed population.
+    int version = 0;
+    int ndraws = 0;
+    int nissued = 0;
+    int nreceived = 0;
+    this->update_sampler();
+    CMAStrategy<TCovarianceUpdate,TGenoPheno>::_pop_counter = this->_esolver.counter();
+    auto issue = [&]()
+      {
+	AsyncJob job;
+	this->sample_candidate(ndraws++,sols._ws._col);
+	job._x = sols._ws._col;
+	job._phenox = p._gp.pheno(job._x);
+	job._version = version;
+	{
+	  std::lock_guard<std::mutex> lock(mtx);
+	  jobs.push_back(std::move(job));
+	}
+	job_cv.notify_one();
+	++nissued;
+      };
+
+    double accepted = 0.0; // evaluation time of the results that made it into an update.
+    std::vector<AsyncJob> pending, received;
+    std::chrono::time_point<std::chrono::system_clock> titer = std::chrono::system_clock::now();
+    bool stopped = false;
+    while (!stopped)
+      {
+	// a distribution issues at most lambda+overdraw candidates, so that workers keep
+	// busy while its last results come in, without too many of them getting stale.
+	while (nissued - nreceived < outstanding && ndraws < p._lambda + overdraw)
+	  issue();
+	{
+	  std::unique_lock<std::mutex> lock(mtx);
+	  result_cv.wait(lock,[&]{ return !results.empty(); });
+	  if (error)
+	    break;
+	  while (!results.empty())
+	    {
+	      received.push_back(std::move(results.front()));
+	      results.pop_front();
+	    }
+	}
+	nreceived += received.size();
+	this->update_fevals(received.size());
+	for (AsyncJob &job: received)
+	  {
+	    if (version - job._version > _max_age)
+	      ++_rejected;
+	    else pending.push_back(std::move(job));
+	  }
+	received.clear();
+
+	// update the distribution with lambda results, and move on to the new distribution.
+	while ((int)pending.size() >= p._lambda && !stopped)
+	  {
+	    sols._candidates.resize(p._lambda);
+	    sols.bind_population();
+	    for (int r=0;r<p._lambda;r++)
+	      {
+		sols._candidates.at(r).set_x(pending.at(r)._x);
+		sols._candidates.at(r).set_fvalue(pending.at(r)._fvalue);
+		sols._candidates.at(r).set_id(r);
+		accepted += pending.at(r)._duration;
+	      }
+	    pending.erase(pending.begin(),pending.begin()+p._lambda);
+	    this->tell();
+	    this->inc_iter();
+	    std::chrono::time_point<std::chrono::system_clock> tnow = std::chrono::system_clock::now();
+	    sols._elapsed_last_iter = std::chrono::duration_cast<std::chrono::milliseconds>(tnow-titer).count();
+	    titer = tnow;
+	    if ((stopped = this->stop()))
+	      break;
+	    this->_esolver.skip(static_cast<long>(ndraws)*p._dim);
+	    ++version;
+
+	    // results received before the update age with it.
+	    std::vector<AsyncJob>::iterator pit = std::remove_if(pending.begin(),pending.end(),
+								 [&](const AsyncJob &job){ return version - job._version > _max_age; });
+	    _rejected += std::distance(pit,pending.end());
+	    pending.erase(pit,pending.end());
+	    ndraws = 0;
+	    this->update_sampler();
+	    CMAStrategy<TCovarianceUpdate,TGenoPheno>::_pop_counter = this->_esolver.counter();
+	  }
+      }
+
+    // evaluations in flight complete, and count in the budget.
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      done = true;
+      jobs.clear();
+    }
+    job_cv.notify_all();
+    for (std::thread &t: workers)
+      t.join();
+    this->update_fevals(results.size());
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now()-tstart).count();
+    double busy_total = 0.0;
+    for (double b: busy)
+      busy_total += b;
+    if (wall > 0.0)
+      {
+	_utilization = accepted / (wall*_nworkers);
+	_busy_utilization = busy_total / (wall*_nworkers);
+      }
+    if (error)
+      std::rethrow_exception(error);
+    LOG_IF(INFO,!p._quiet) << "async CMA-ES / workers=" << _nworkers << " / utilization=" << _utilization << " / busy=" << _busy_utilization << " / rejected=" << _rejected << std::endl;
+
+    if (p._with_edm)
+      this->edm();
+    if (sols._run_status >= 0)
+      return OPTI_SUCCESS;
+    else return OPTI_ERR_TERMINATION;
+  }
+
+  template class CMAES_EXPORT AsyncCMAStrategy<CovarianceUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<ACovarianceUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<VDCMAUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<CovarianceUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<ACovarianceUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<VDCMAUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<CovarianceUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<ACovarianceUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<VDCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<CovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<ACovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<VDCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<LMCMAUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<LMCMAUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<LMCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<LMCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<VkDCMAUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<VkDCMAUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<VkDCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT AsyncCMAStrategy<VkDCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+}
@@ -75,6 +75,42 @@ namespace libcmaes
 							       const AskFunc &askf,
 							       const TellFunc &tellf)
   {
+    if (CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters._restart_threads != 1)
+      {
+	// the regime with the least budget committed so far, consumed or reserved by
+	// the runs in flight, gets the next run, so that large and small population runs
+	// interleave on the slots from the start.
+	int nr1 = 0;
+	return IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::optimize_parallel([this,&nr1](CMAParameters<TGenoPheno> &rparameters, int &regime)
+	  {
+	    const std::array<int,2> &budgets = IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::_budgets;
+	    const std::array<int,2> &reserved = IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::_reserved;
+	    int committed_r1 = budgets[0] + reserved[0];
+	    int committed_r2 = budgets[1] + reserved[1];
+	    if (committed_r1 > committed_r2)
+	      {
+		double u = _unif(_gen);
+		double us = _unif(_gen);
+		rparameters._lambda = ceil(_lambda_def * pow(0.5*(_lambda_l/_lambda_def),u));
+		rparameters._sigma_init = 2.0*pow(10,-2.0*us);
+		rparameters._max_fevals = std::max(1,committed_r1/2);
+		regime = 1;
+	      }
+	    else
+	      {
+		if (nr1 >= CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters._nrestarts)
+		  return false;
+		if (nr1 > 0)
+		  _lambda_l *= 2.0;
+		rparameters._lambda = _lambda_l;
+		rparameters._sigma_init = _sigma_init;
+		++nr1;
+		regime = 0;
+	      }
+	    rparameters.initialize_parameters();
+	    return true;
+	  });
+      }
     std::array<int,2> budgets = {{0,0}}; // 0: r1, 1: r2
     CMASolutions best_run;
     const bool has_max_fevals = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters._max_fevals > 0;
@@ -160,4 +196,16 @@ CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters.set_max_fevals(fevals_r1)
   template class CMAES_EXPORT BIPOPCMAStrategy<CovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy> >;
   template class CMAES_EXPORT BIPOPCMAStrategy<ACovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy> >;
   template class CMAES_EXPORT BIPOPCMAStrategy<VDCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<NoBoundStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<pwqBoundStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<LMCMAUpdate,GenoPheno<NoBoundStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<LMCMAUpdate,GenoPheno<pwqBoundStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<LMCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<LMCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<VkDCMAUpdate,GenoPheno<NoBoundStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<VkDCMAUpdate,GenoPheno<pwqBoundStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<VkDCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy> >;
+  template class CMAES_EXPORT BIPOPCMAStrategy<VkDCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy> >;
 }
@@ -0,0 +1,114 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/choleskycovarianceupdate.h>
+#include <iostream>
+
+namespace libcmaes
+{
+
+  template <class TGenoPheno>
+  void CholeskyCovarianceUpdate::update(const CMAParameters<TGenoPheno> &parameters,
+					Eigen::EigenMultivariateNormal<double> &esolver,
+					CMASolutions &solutions)
+  {
+    (void)esolver; // esolver is not needed, sampling uses the factor directly.
+    
+    // compute mean, Eq. (2)
+    dVec xmean = dVec::Zero(parameters._dim);
+    for (int i=0;i<parameters._mu;i++)
+      xmean += parameters._weights[i] * solutions._candidates.at(i).get_x_map();
+    
+    // reusable variables.
+    dVec diffxmean = 1.0/solutions._sigma * (xmean-solutions._xmean); // (m^{t+1}-m^t)/sigma^t
+    
+    // update psigma, Eq. (3), with A^-1 in place of C^-1/2.
+    solutions._psigma = (1.0-parameters._csigma)*solutions._psigma;
+    solutions._psigma += parameters._fact_ps * solutions._csqinv * diffxmean;
+    double norm_ps = solutions._psigma.norm();
+
+    // update pc, Eq. (4)
+    solutions._hsig = 0;
+    double val_for_hsig = sqrt(1.0-pow(1.0-parameters._csigma,2.0*(solutions._niter+1)))*(1.4+2.0/(parameters._dim+1-parameters._fixed_p.size()))*parameters._chi;
+    if (norm_ps < val_for_hsig)
+      solutions._hsig = 1;
+    solutions._pc = (1.0-parameters._cc) * solutions._pc + solutions._hsig * parameters._fact_pc * diffxmean;
+    
+    // covariance update, Eq (5), kept for termination criteria and reporting.
+    double alphacov = 1-parameters._c1-parameters._cmu+(1-solutions._hsig)*parameters._c1*parameters._cc*(2.0-parameters._cc);
+    dMat ys(parameters._dim,parameters._mu);
+    for (int i=0;i<parameters._mu;i++)
+      ys.col(i) = (std::sqrt(parameters._weights[i])/solutions._sigma) * (solutions._candidates.at(i).get_x_map() - solutions._xmean);
+    solutions._cov *= alphacov;
+    solutions._cov.noalias() += parameters._c1 * solutions._pc * solutions._pc.transpose();
+    solutions._cov.noalias() += parameters._cmu * ys * ys.transpose();
+
+    // factor update, as a series of rank-one updates of A and A^-1.
+    if (alphacov > 0.0)
+      {
+	double salpha = std::sqrt(alphacov);
+	solutions._csqrt *= salpha;
+	solutions._csqinv /= salpha;
+	rank_one_update(parameters._c1,solutions._pc,solutions._csqrt,solutions._csqinv);
+	for (int i=0;i<parameters._mu;i++)
+	  rank_one_update(parameters._cmu,ys.col(i),solutions._csqrt,solutions._csqinv);
+      }
+    else // factors cannot be scaled, refactorize.
+      {
+	Eigen::LLT<dMat> llt(solutions._cov);
+	solutions._csqrt = llt.matrixL();
+	solutions._csqinv = llt.matrixL().solve(dMat::Identity(parameters._dim,parameters._dim));
+      }
+    
+    // sigma update, Eq. (6)
+    if (parameters._tpa < 2)
+      solutions._sigma *= std::exp((parameters._csigma / parameters._dsigma) * (norm_ps / parameters._chi - 1.0));
+    else if (solutions._niter > 0)
+      solutions._sigma *= std::exp(solutions._tpa_s / parameters._dsigma);
+    
+    // set mean.
+    if (parameters._tpa)
+      solutions._xmean_prev = solutions._xmean;
+    solutions._xmean = xmean;
+  }
+
+  void CholeskyCovarianceUpdate::rank_one_update(const double &beta,
+						 const dVec &v,
+						 dMat &A,
+						 dMat &Ainv)
+  {
+    if (beta == 0.0)
+      return;
+    dVec z = Ainv * v;
+    double normz = z.squaredNorm();
+    if (normz <= 0.0)
+      return;
+    double s = std::sqrt(1.0+beta*normz);
+    dVec zAinv = Ainv.transpose() * z;
+    A.noalias() += ((s-1.0)/normz) * v * z.transpose();
+    Ainv.noalias() -= ((1.0-1.0/s)/normz) * z * zAinv.transpose();
+  }
+
+  template CMAES_EXPORT void CholeskyCovarianceUpdate::update(const CMAParameters<GenoPheno<NoBoundStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void CholeskyCovarianceUpdate::update(const CMAParameters<GenoPheno<pwqBoundStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void CholeskyCovarianceUpdate::update(const CMAParameters<GenoPheno<NoBoundStrategy,linScalingStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void CholeskyCovarianceUpdate::update(const CMAParameters<GenoPheno<pwqBoundStrategy,linScalingStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+}
@@ -115,13 +115,19 @@ namespace libcmaes
     // uncertainty handling.
     this->_rlambda = std::max(0.1,2.0/Parameters<TGenoPheno>::_lambda);
     this->_alphathuh = 1 + 2.0/(Parameters<TGenoPheno>::_dim+10.0);
+
+    // limited-memory cma, rates depend on lambda.
+    if (_lm)
+      set_lm();
+    if (_vkd)
+      set_vkd();
   }
   
   template <class TGenoPheno>
   void CMAParameters<TGenoPheno>::set_noisy()
   {
-    static double factor = 0.2;
-    static double lfactor = 5.0; // lambda factor.
+    const double factor = 0.2;
+    const double lfactor = 5.0; // lambda factor.
     Parameters<TGenoPheno>::_lambda *= lfactor;
     initialize_parameters(); // reinit parameters.
     _c1 *= factor;
@@ -175,6 +181,63 @@ namespace libcmaes
     _fact_ps = sqrt(_csigma*(2.0-_csigma)*_muw);
   }
 
+  template <class TGenoPheno>
+  void CMAParameters<TGenoPheno>::set_chol()
+  {
+    if (this->_algo != 15 && this->_algo != 16 && this->_algo != 17)
+      {
+	std::cerr << "[Warning]: set_chol on non Cholesky algorithm " << this->_algo << ". Not activating Cholesky update\n";
+	return;
+      }
+    _chol = true;
+  }
+
+  template <class TGenoPheno>
+  void CMAParameters<TGenoPheno>::set_lm()
+  {
+    if (this->_algo != 18 && this->_algo != 19 && this->_algo != 20)
+      {
+	std::cerr << "[Warning]: set_lm on non LM algorithm " << this->_algo << ". Not activating LM update\n";
+	return;
+      }
+    _lm = true;
+    double n = static_cast<double>(Parameters<TGenoPheno>::_dim);
+    double lambda = static_cast<double>(Parameters<TGenoPheno>::_lambda);
+    int m = 4 + static_cast<int>(std::floor(3.0*std::log(n)));
+    _lm_cd = dVec(m);
+    _lm_cc = dVec(m);
+    for (int j=0;j<m;j++)
+      {
+	_lm_cd[j] = std::min(0.5,1.0/(std::pow(1.5,j)*n)); // capped so that every factor remains invertible in small dimensions.
+	_lm_cc[j] = std::min(1.0,lambda/(std::pow(4.0,j)*n));
+      }
+    if (2.0*lambda < n) // default rate is kept in small dimensions.
+      _csigma = 2.0*lambda/n;
+    _fact_ps = sqrt(_csigma*(2.0-_csigma)*_muw);
+  }
+
+  template <class TGenoPheno>
+  void CMAParameters<TGenoPheno>::set_vkd()
+  {
+    if (this->_algo != 21 && this->_algo != 22 && this->_algo != 23)
+      {
+	std::cerr << "[Warning]: set_vkd on non VkD algorithm " << this->_algo << ". Not activating VkD update\n";
+	return;
+      }
+    _vkd = true;
+    double n = static_cast<double>(Parameters<TGenoPheno>::_dim);
+    if (_vkd_k <= 0)
+      _vkd_k = std::max(1,static_cast<int>(std::floor(std::sqrt(n))));
+    // learning rates scaled to the (k+1)n degrees of freedom of the model, as VD-CMA does for k=1.
+    double scale = std::max(1.0,(n-5.0)/(3.0*(_vkd_k+1)));
+    _c1 = scale * 2.0/(pow(n+1.3,2)+_muw);
+    _cmu = std::min(1.0-_c1,scale * 2.0*(_muw-2.0+1.0/_muw)/(pow(n+2.0,2)+_muw));
+    _csigma = std::sqrt(_muw)/(2.0*(std::sqrt(n) + std::sqrt(_muw)));
+    if (this->_tpa == 0)
+      _dsigma = 1.0+_csigma+2.0*std::max(0.0,sqrt((_muw-1)/(n+1))-1);
+    _fact_ps = sqrt(_csigma*(2.0-_csigma)*_muw);
+  }
+
   template <class TGenoPheno>
   void CMAParameters<TGenoPheno>::set_fixed_p(const int &index, const double &value)
   {
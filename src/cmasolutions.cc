@@ -22,6 +22,10 @@
 #include <libcmaes/cmasolutions.h>
 #include <libcmaes/opti_err.h>
 #include <libcmaes/eigenmvn.h>
+#include <libcmaes/lmcmaupdate.h>
+#include <libcmaes/vkdcmaupdate.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <iostream>
 
@@ -33,9 +37,25 @@ namespace libcmaes
   {
     try
       {
-	if (!static_cast<CMAParameters<TGenoPheno>&>(p)._sep && !static_cast<CMAParameters<TGenoPheno>&>(p)._vd)
+	if (!static_cast<CMAParameters<TGenoPheno>&>(p)._sep && !static_cast<CMAParameters<TGenoPheno>&>(p)._vd && !static_cast<CMAParameters<TGenoPheno>&>(p)._lm && !static_cast<CMAParameters<TGenoPheno>&>(p)._vkd)
 	  _cov = dMat::Identity(p._dim,p._dim);
 	else _sepcov = dMat::Constant(p._dim,1,1.0);
+	if (static_cast<CMAParameters<TGenoPheno>&>(p)._chol)
+	  {
+	    _csqrt = dMat::Identity(p._dim,p._dim);
+	    _csqinv = dMat::Identity(p._dim,p._dim);
+	  }
+	if (static_cast<CMAParameters<TGenoPheno>&>(p)._lm)
+	  {
+	    _lmcd = static_cast<CMAParameters<TGenoPheno>&>(p)._lm_cd;
+	    _lmvecs = dMat::Zero(p._dim,_lmcd.size());
+	  }
+	if (static_cast<CMAParameters<TGenoPheno>&>(p)._vkd)
+	  {
+	    _vkdv = dMat::Zero(p._dim,static_cast<CMAParameters<TGenoPheno>&>(p)._vkd_k);
+	    _vkds = dVec::Zero(_vkdv.cols());
+	    _vkdd = dVec::Constant(p._dim,1.0);
+	  }
       }
     catch (std::bad_alloc &e)
       {
@@ -72,12 +92,21 @@ namespace libcmaes
     _psigma = dVec::Zero(p._dim);
     _pc = dVec::Zero(p._dim);
     _candidates.resize(p._lambda);
+    int pop_chunk = static_cast<CMAParameters<TGenoPheno>&>(p)._pop_chunk; // compressed population, no lambda sized buffer.
+    if (pop_chunk <= 0)
+      bind_population();
     _kcand = std::min(p._lambda-1,static_cast<int>(1.0+ceil(0.1+p._lambda/4.0)));
     _max_hist = (p._max_hist > 0) ? p._max_hist : static_cast<int>(10+ceil(30*p._dim/p._lambda));
+    _best_fvalues_hist.set_capacity(_max_hist);
+    _k_best_fvalues_hist.set_capacity(_max_hist);
+    _best_fvalues_range.set_window(std::min(_max_hist,static_cast<int>(10+ceil(30*p._dim/p._lambda))));
+    if (p._full_hist)
+      _best_candidates_hist.set_capacity(_max_hist);
+    _ws.resize(p._dim,pop_chunk > 0 ? std::min(pop_chunk,p._lambda) : p._lambda,static_cast<CMAParameters<TGenoPheno>&>(p)._mu);
     
     if (static_cast<CMAParameters<TGenoPheno>&>(p)._vd)
       {
-	Eigen::EigenMultivariateNormal<double> esolver(false,static_cast<uint64_t>(p._seed));
+	Eigen::EigenMultivariateNormal<double> esolver(false,static_cast<uint64_t>(p._seed),2); // own stream, independent from sampling.
 	esolver.set_covar(_sepcov);
 	_v = esolver.samples_ind(1) / std::sqrt(p._dim);
       }
@@ -87,19 +116,126 @@ namespace libcmaes
   {
   }
 
-  void CMASolutions::update_best_candidates()
+  bool CMASolutions::ranks_before(const int &i, const int &j) const
   {
-    _best_candidates_hist.push_back(_candidates.at(0)); // supposed candidates is sorted.
-    _k_best_candidates_hist.push_back(_candidates.at(_kcand));
-    if ((int)_best_candidates_hist.size() > _max_hist)
+    double fi = _candidates[i].get_fvalue();
+    double fj = _candidates[j].get_fvalue();
+    if (std::isnan(fi) || std::isnan(fj)) // NaN ranks worst.
       {
-	_best_candidates_hist.erase(_best_candidates_hist.begin());
-	_k_best_candidates_hist.erase(_k_best_candidates_hist.begin());
+	if (std::isnan(fi) != std::isnan(fj))
+	  return std::isnan(fj);
+	return i < j;
       }
-    
-    _bfvalues.push_back(_candidates.at(0).get_fvalue());
-    if (_bfvalues.size() > 20)
-      _bfvalues.erase(_bfvalues.begin());
+    if (fi < fj)
+      return true;
+    if (fj < fi)
+      return false;
+    return i < j; // ties keep their order.
+  }
+
+  void CMASolutions::permute_candidates()
+  {
+    // move every candidate once along the cycles of the permutation.
+    std::vector<int> &perm = _ws._perm;
+    for (int i=0;i<static_cast<int>(perm.size());i++)
+      {
+	if (perm[i] == i)
+	  continue;
+	Candidate tmp = std::move(_candidates[i]);
+	int j = i;
+	while (perm[j] != i)
+	  {
+	    int k = perm[j];
+	    _candidates[j] = std::move(_candidates[k]);
+	    perm[j] = j;
+	    j = k;
+	  }
+	_candidates[j] = std::move(tmp);
+	perm[j] = j;
+      }
+  }
+  
+  void CMASolutions::sort_candidates()
+  {
+    // rank a permutation, then move every candidate once, so that no buffer is allocated.
+    std::vector<int> &perm = _ws._perm;
+    perm.resize(_candidates.size());
+    for (size_t i=0;i<perm.size();i++)
+      perm[i] = static_cast<int>(i);
+    std::sort(perm.begin(),perm.end(),
+	      [this](const int &i, const int &j){ return ranks_before(i,j); });
+    permute_candidates();
+  }
+
+  void CMASolutions::select_candidates(const int &ntop, const int &nbottom,
+				       const std::vector<int> &ranks)
+  {
+    int lambda = static_cast<int>(_candidates.size());
+    std::vector<int> &perm = _ws._perm;
+    perm.resize(lambda);
+    for (int i=0;i<lambda;i++)
+      perm[i] = i;
+    auto comp = [this](const int &i, const int &j){ return ranks_before(i,j); };
+
+    // top and bottom ranks, sorted.
+    int lo = std::min(std::max(ntop,0),lambda);
+    int hi = std::max(lambda-std::max(nbottom,0),lo);
+    if (lo > 0)
+      std::partial_sort(perm.begin(),perm.begin()+lo,perm.end(),comp);
+    if (hi < lambda)
+      {
+	std::nth_element(perm.begin()+lo,perm.begin()+hi,perm.end(),comp);
+	std::sort(perm.begin()+hi,perm.end(),comp);
+      }
+
+    // single ranks in between, the worst, the median and k-th best ones used in history.
+    std::vector<int> &sel = _ws._sel;
+    sel.assign(ranks.begin(),ranks.end());
+    if (lambda > 0)
+      {
+	sel.push_back(lambda-1);
+	sel.push_back(lambda/2);
+	if (lambda % 2 == 0)
+	  sel.push_back(lambda/2-1);
+	sel.push_back(_kcand);
+      }
+    std::sort(sel.begin(),sel.end());
+    int first = lo;
+    for (int r: sel)
+      {
+	if (r < first || r >= hi)
+	  continue;
+	std::nth_element(perm.begin()+first,perm.begin()+r,perm.begin()+hi,comp);
+	first = r+1;
+      }
+    permute_candidates();
+  }
+  
+  void CMASolutions::bind_population()
+  {
+    _pop_x.resize(_xmean.size(),_candidates.size());
+    for (size_t i=0;i<_candidates.size();i++)
+      _candidates[i].bind_x(_pop_x.col(i).data(),_pop_x.rows());
+  }
+  
+  void CMASolutions::update_best_candidates()
+  {
+    _best_candidate = _candidates.at(0); // supposed candidates is sorted.
+    double bfvalue = _best_candidate.get_fvalue();
+    double kbfvalue = _candidates.at(_kcand).get_fvalue();
+    if (_best_fvalues_hist.capacity() > 0 && _best_fvalues_hist.size() == _best_fvalues_hist.capacity()
+	&& _best_fvalues_hist.front() == _k_best_fvalues_hist.front())
+      --_nequal_fvalues; // leaves the history.
+    if (_best_fvalues_hist.capacity() > 0 && bfvalue == kbfvalue)
+      ++_nequal_fvalues;
+    _best_fvalues_hist.push_back(bfvalue);
+    _k_best_fvalues_hist.push_back(kbfvalue);
+    _best_fvalues_range.push_back(bfvalue);
+    _best_candidates_hist.push_back(_best_candidate); // no-op unless the full history is kept.
+    if (_bfvalues.size() == _bfvalues.capacity())
+      _sorted_bfvalues.erase(_bfvalues.front());
+    _bfvalues.push_back(bfvalue);
+    _sorted_bfvalues.insert(bfvalue);
 
     // get median of candidate's scores, used in termination criteria (stagnation).
     double median = 0.0;
@@ -107,9 +243,19 @@ namespace libcmaes
     if (csize % 2 == 0)
       median = (_candidates[csize/2-1].get_fvalue() + _candidates[csize/2].get_fvalue())/2.0;
     else median = _candidates[csize/2].get_fvalue();
+    int mcapacity = static_cast<int>(ceil(0.2*_niter+120+30*_xmean.size()/static_cast<double>(_candidates.size())));
+    while (_median_fvalues.size() >= mcapacity)
+      {
+	// the oldest value leaves, and the 21st oldest becomes one of the oldest 20.
+	_oldest_median_fvalues.erase(_median_fvalues.front());
+	_median_fvalues.pop_front();
+	if (_median_fvalues.size() >= 20)
+	  _oldest_median_fvalues.insert(_median_fvalues[19]);
+      }
+    _median_fvalues.set_capacity(mcapacity);
     _median_fvalues.push_back(median);
-    if (_median_fvalues.size() > static_cast<size_t>(ceil(0.2*_niter+120+30*_xmean.size()/static_cast<double>(_candidates.size()))))
-      _median_fvalues.erase(_median_fvalues.begin());
+    if (_median_fvalues.size() <= 20)
+      _oldest_median_fvalues.insert(median);
 
     // store best seen candidate.
     if ((_niter == 0 && !_best_seen_candidate.get_x_size()) || _candidates.at(0).get_fvalue() < _best_seen_candidate.get_fvalue())
@@ -131,6 +277,10 @@ namespace libcmaes
       return _cov;
     else if (_v.size()) // vd
       return _sepcov.asDiagonal()*(dMat::Identity(_sepcov.rows(),_sepcov.rows())+_v*_v.transpose())*(_sepcov.asDiagonal());
+    else if (_lmvecs.size()) // lm
+      return LMCMAUpdate::full_cov(*this);
+    else if (_vkdv.size()) // vkd
+      return VkDCMAUpdate::full_cov(*this);
     else // sep
       return _sepcov.asDiagonal();
   }
@@ -147,10 +297,10 @@ namespace libcmaes
 	for (int i=0;i<_cov.rows();i++)
 	  corr.row(i) = corr.row(i).cwiseProduct(dinvcov.transpose());
       }
-    else if (_v.size() > 0) // vd
+    else if (_v.size() > 0 || _lmvecs.size() > 0 || _vkdv.size() > 0) // vd, lm or vkd
       {
 	// we need to compute the full covariance matrix, which is counter productive in large-scale settings
-	dMat cov = _sepcov.asDiagonal()*(dMat::Identity(_sepcov.rows(),_sepcov.rows())+_v*_v.transpose())*(_sepcov.asDiagonal());
+	dMat cov = full_cov();
 	dinvcov = cov.diagonal().cwiseSqrt().cwiseInverse();
 	corr = dMat(cov.rows(),cov.cols());
 	for (int i=0;i<cov.cols();i++)
@@ -187,6 +337,20 @@ namespace libcmaes
 	dMat c = sc.asDiagonal()*(dMat::Identity(2,2)+v*v.transpose())*(sc.asDiagonal()); // compute cov matrix for i & j
 	return c(0,1)/(st(i)*st(j));
       }
+    else if (_lmvecs.size() > 0) // lm, C_ij = (T^T e_i).(T^T e_j)
+      {
+	dMat e = dMat::Zero(_lmvecs.rows(),2);
+	e(i,0) = e(j,1) = 1.0;
+	LMCMAUpdate::transform(*this,e,true);
+	return e.col(0).dot(e.col(1))/std::sqrt(e.col(0).squaredNorm()*e.col(1).squaredNorm());
+      }
+    else if (_vkdv.size() > 0) // vkd, D_i D_j scalings cancel out
+      {
+	double cij = (_vkdv.row(i).cwiseProduct(_vkdv.row(j)) * _vkds)(0);
+	double cii = 1.0 + (_vkdv.row(i).cwiseAbs2() * _vkds)(0);
+	double cjj = 1.0 + (_vkdv.row(j).cwiseAbs2() * _vkds)(0);
+	return cij/std::sqrt(cii*cjj);
+      }
     else // sep 
       {
 	return 0.0; // XXX: could return nan instead, since value is unknown
@@ -200,25 +364,54 @@ namespace libcmaes
     _min_eigenv = eigenvalues.minCoeff();
     _leigenvalues = eigenvalues;
     _leigenvectors = eigenvectors;
+    _leigenvectors_max = _leigenvectors.rowwise().maxCoeff();
+    _leigenvectors_min = _leigenvectors.rowwise().minCoeff();
   }
 
   void CMASolutions::reset()
   {
     //_candidates.clear();
+    _best_candidate = Candidate();
+    _best_fvalues_hist.clear();
     _best_candidates_hist.clear();
     //_leigenvalues.setZero(); // beware.
     //_leigenvectors.setZero();
     //_cov /= 1e-3;//_sigma;
     _cov = dMat::Identity(_csqinv.rows(),_csqinv.cols());
+    if (_csqrt.size() > 0) // cholesky
+      {
+	_csqrt = dMat::Identity(_csqinv.rows(),_csqinv.cols());
+	_csqinv = dMat::Identity(_csqinv.rows(),_csqinv.cols());
+      }
     //std::cout << "cov: " << _cov << std::endl;
     _niter = 0;
     _nevals = 0;
     //_sigma = 1.0/static_cast<double>(_csqinv.rows());
     _psigma = dVec::Zero(_cov.rows());
     _pc = dVec::Zero(_cov.rows());
-    _k_best_candidates_hist.clear();
+    if (_lmvecs.size() > 0) // lm
+      {
+	_lmvecs.setZero();
+	_lmk = 0;
+	_sepcov = dMat::Constant(_lmvecs.rows(),1,1.0);
+	_psigma = dVec::Zero(_lmvecs.rows());
+      }
+    if (_vkdv.size() > 0) // vkd
+      {
+	_vkdv.setZero();
+	_vkds.setZero();
+	_vkdd.setConstant(1.0);
+	_sepcov = dMat::Constant(_vkdv.rows(),1,1.0);
+	_psigma = dVec::Zero(_vkdv.rows());
+	_pc = dVec::Zero(_vkdv.rows());
+      }
+    _k_best_fvalues_hist.clear();
+    _best_fvalues_range.clear();
+    _nequal_fvalues = 0;
     _bfvalues.clear();
+    _sorted_bfvalues.clear();
     _median_fvalues.clear();
+    _oldest_median_fvalues.clear();
     _run_status = 0;
     _elapsed_time = _elapsed_last_iter = 0;
 #ifdef HAVE_DEBUG
@@ -232,20 +425,46 @@ namespace libcmaes
     removeColumn(_cov,k);
     removeRow(_csqinv,k);
     removeColumn(_csqinv,k);
+    if (_csqrt.size() > 0) // cholesky, factors of the reduced covariance.
+      {
+	Eigen::LLT<dMat> llt(_cov);
+	_csqrt = llt.matrixL();
+	_csqinv = llt.matrixL().solve(dMat::Identity(_cov.rows(),_cov.cols()));
+      }
+    if (_lmvecs.size() > 0) // lm
+      removeRow(_lmvecs,k);
+    if (_vkdv.size() > 0) // vkd
+      {
+	removeRow(_vkdv,k);
+	removeElement(_vkdd,k);
+      }
     removeElement(_xmean,k);
+    if (!_candidates.empty()) // window of termination criteria, on the reduced dimension.
+      _best_fvalues_range.set_window(std::min(_max_hist,static_cast<int>(10+ceil(30*static_cast<int>(_xmean.size())/static_cast<int>(_candidates.size())))));
     removeElement(_psigma,k);
     removeElement(_pc,k);
-    for (size_t i=0;i<_candidates.size();i++)
-      removeElement(_candidates.at(i).get_x_dvec_ref(),k);
+    removeRow(_pop_x,k);
+    bind_population();
+    _best_candidate = Candidate();
+    _best_fvalues_hist.clear();
     _best_candidates_hist.clear();
     removeElement(_leigenvalues,k);
     removeRow(_leigenvectors,k);
     removeColumn(_leigenvectors,k);
+    if (_leigenvectors.size() > 0)
+      {
+	_leigenvectors_max = _leigenvectors.rowwise().maxCoeff();
+	_leigenvectors_min = _leigenvectors.rowwise().minCoeff();
+      }
     _niter = 0;
     _nevals = 0;
-    _k_best_candidates_hist.clear();
+    _k_best_fvalues_hist.clear();
+    _best_fvalues_range.clear();
+    _nequal_fvalues = 0;
     _bfvalues.clear();
+    _sorted_bfvalues.clear();
     _median_fvalues.clear();
+    _oldest_median_fvalues.clear();
     _run_status = 0;
     _elapsed_time = _elapsed_last_iter = 0;
 #ifdef HAVE_DEBUG
@@ -50,22 +50,11 @@ namespace libcmaes
                     {MAXITER,"The maximum number of iterations specified for optimization has been reached"},
                     {FTARGET,"[Success] The objective function target value has been reached"}};
 
-  // computes median of a vector.
-  double median(std::vector<double> scores)
-  {
-    double median;
-    size_t size = scores.size();
-    std::sort(scores.begin(), scores.end());
-    if (size  % 2 == 0)
-      median = (scores[size / 2 - 1] + scores[size / 2]) / 2;
-    else median = scores[size / 2];
-    return median;
-  }
-  
   template <class TGenoPheno>
   CMAStopCriteria<TGenoPheno>::CMAStopCriteria()
     :_active(true)
   {
+    std::map<int,StopCriteriaFunc<TGenoPheno> > scriteria; // criteria, with priorities.
     StopCriteriaFunc<TGenoPheno> maxFEvals = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	if (cmap._max_fevals == -1)
@@ -77,7 +66,7 @@ namespace libcmaes
 	  }
 	else return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(MAXFEVALS,StopCriteria<TGenoPheno>(maxFEvals)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(MAXFEVALS,maxFEvals));
     StopCriteriaFunc<TGenoPheno> maxIter = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	if (cmap._max_iter == -1)
@@ -89,7 +78,7 @@ namespace libcmaes
 	  }
 	else return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(MAXITER,StopCriteria<TGenoPheno>(maxIter)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(MAXITER,maxIter));
     StopCriteriaFunc<TGenoPheno> autoMaxIter = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	double thresh = 100.0 + 50*pow(cmap._dim+3,2) / sqrt(cmap._lambda);
@@ -102,7 +91,7 @@ namespace libcmaes
 	  }
 	return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(AUTOMAXITER,StopCriteria<TGenoPheno>(autoMaxIter)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(AUTOMAXITER,autoMaxIter));
     StopCriteriaFunc<TGenoPheno> fTarget = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	if (cmap._ftarget != std::numeric_limits<double>::infinity())
@@ -115,22 +104,25 @@ namespace libcmaes
 	  }
 	return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(FTARGET,StopCriteria<TGenoPheno>(fTarget)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(FTARGET,fTarget));
     StopCriteriaFunc<TGenoPheno> tolHistFun = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	double threshold = std::max(cmap._ftolerance,1e-12);
-	int histsize = static_cast<int>(cmas._best_candidates_hist.size());
+	int histsize = cmas._best_fvalues_hist.size();
 	int histthresh = std::min(cmas._max_hist,static_cast<int>(10+ceil(30*cmap._dim/cmap._lambda)));
 	int histlength = std::min(histthresh,histsize);
 	if (histlength < histthresh) // not enough data
 	  return CONT;
 	std::pair<double,double> frange(std::numeric_limits<double>::max(),-std::numeric_limits<double>::max());
-	for (int i=0;i<histlength;i++)
-	  {
-	    double val = cmas._best_candidates_hist.at(histsize-1-i).get_fvalue();
-	    frange.first = std::min(val,frange.first);
-	    frange.second = std::max(val,frange.second);
-	  }
+	if (histthresh > 0 && histthresh == cmas._best_fvalues_range.window()) // range kept along the history.
+	  frange = std::make_pair(cmas._best_fvalues_range.min(),cmas._best_fvalues_range.max());
+	else
+	  for (int i=0;i<histlength;i++)
+	    {
+	      double val = cmas._best_fvalues_hist[histsize-1-i];
+	      frange.first = std::min(val,frange.first);
+	      frange.second = std::max(val,frange.second);
+	    }
 	double rg = fabs(frange.second-frange.first);
 	if (rg < threshold)
 	  {
@@ -139,21 +131,15 @@ namespace libcmaes
 	  }
 	return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(TOLHISTFUN,StopCriteria<TGenoPheno>(tolHistFun)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(TOLHISTFUN,tolHistFun));
     StopCriteriaFunc<TGenoPheno> equalFunVals = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
-	int histsize = static_cast<int>(cmas._best_candidates_hist.size());
+	int histsize = cmas._best_fvalues_hist.size();
 	int histlength = std::min(cmap._dim,histsize);
 	if (histlength < cmas._max_hist) // not enough data
 	  return CONT;
 
-	int c = 0;
-	for (int i=0;i<histlength;i++)
-	  {
-	    if (cmas._best_candidates_hist.at(histsize-1-i).get_fvalue()
-		== cmas._k_best_candidates_hist.at(histsize-1-i).get_fvalue())
-	      c++;
-	  }
+	int c = cmas._nequal_fvalues; // histlength is the full history.
 	if (c > histlength / 3.0)
 	  {
 	    LOG_IF(INFO,!cmap._quiet) << "stopping criteria equalFunVals\n";
@@ -161,7 +147,7 @@ namespace libcmaes
 	  }
 	return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(EQUALFUNVALS,StopCriteria<TGenoPheno>(equalFunVals)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(EQUALFUNVALS,equalFunVals));
     StopCriteriaFunc<TGenoPheno> tolX = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	double tolx = std::max(cmap._xtol,1e-12);
@@ -174,16 +160,16 @@ namespace libcmaes
 	//test 2: all square root components of cov . factor < tolx.
 	int covrows = std::max(cmas._cov.rows(),cmas._sepcov.rows());
 	for (int i=0;i<covrows;i++)
-	  if ((!cmap._sep && !cmap._vd && sqrt(cmas._cov(i,i))>=tfactor)
-	      || ((cmap._sep || cmap._vd) && sqrt(cmas._sepcov(i))>=tfactor))
+	  if ((!cmap._sep && !cmap._vd && !cmap._lm && !cmap._vkd && sqrt(cmas._cov(i,i))>=tfactor)
+	      || ((cmap._sep || cmap._vd || cmap._lm || cmap._vkd) && sqrt(cmas._sepcov(i))>=tfactor))
 	    return CONT;
 	LOG_IF(INFO,!cmap._quiet) << "stopping criteria tolX\n";
 	return TOLX;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(TOLX,StopCriteria<TGenoPheno>(tolX)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(TOLX,tolX));
     StopCriteriaFunc<TGenoPheno> tolUpSigma = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
-	static double tolupsigma = 1e20;
+	const double tolupsigma = 1e20;
 	double factor = cmas._sigma / cmap._sigma_init;
 	double rhs = tolupsigma * sqrt(cmas._max_eigenv);
 	if (factor > rhs)
@@ -193,15 +179,13 @@ namespace libcmaes
 	  }
 	return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(TOLUPSIGMA,StopCriteria<TGenoPheno>(tolUpSigma)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(TOLUPSIGMA,tolUpSigma));
     StopCriteriaFunc<TGenoPheno> stagnation = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	if (cmas._bfvalues.size() < 20 || cmas._median_fvalues.size() < 20)
 	  return CONT;
-	double medianbv = median(cmas._bfvalues);
-	std::vector<double> oldest_median_fvalues(20);
-	std::copy_n(cmas._median_fvalues.begin(),20,oldest_median_fvalues.begin());
-	double old_medianbv = median(oldest_median_fvalues);
+	double medianbv = cmas._sorted_bfvalues.median();
+	double old_medianbv = cmas._oldest_median_fvalues.median();
 	if (medianbv >= old_medianbv)
 	  {
 	    LOG_IF(INFO,!cmap._quiet) << "stopping criteria stagnation => oldmedianfvalue=" << old_medianbv << " / newmedianfvalue=" << medianbv << std::endl;
@@ -209,10 +193,10 @@ namespace libcmaes
 	  }
 	return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(STAGNATION,StopCriteria<TGenoPheno>(stagnation)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(STAGNATION,stagnation));
     StopCriteriaFunc<TGenoPheno> conditionCov = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
-	static double bound = 1e14;
+	const double bound = 1e14;
 	double kappa = cmas._max_eigenv / cmas._min_eigenv;
 	if (kappa > bound)
 	  {
@@ -221,33 +205,59 @@ namespace libcmaes
 	  }
 	return CONT;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(CONDITIONCOV,StopCriteria<TGenoPheno>(conditionCov)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(CONDITIONCOV,conditionCov));
     StopCriteriaFunc<TGenoPheno> noEffectAxis = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	double fact = 0.1*cmas._sigma;
 	for (int i=0;i<cmap._dim;i++)
 	  {
 	    double ei = fact * sqrt(cmas._leigenvalues(i));
-	    for (int j=0;j<cmap._dim;j++)
-	      if ((!cmap._sep && !cmap._vd && cmas._xmean[i] != cmas._xmean[i] + ei * cmas._leigenvectors(i,j))
-		  || ((cmap._sep || cmap._vd) && cmas._xmean[i] != cmas._xmean[i] + ei))
-		return CONT;
+	    if (cmap._chol) // columns of the factor as axes
+	      {
+		for (int j=0;j<cmap._dim;j++)
+		  if (cmas._xmean[i] != cmas._xmean[i] + fact * cmas._csqrt(i,j))
+		    return CONT;
+	      }
+	    else if (cmap._sep || cmap._vd || cmap._lm || cmap._vkd)
+	      {
+		if (cmas._xmean[i] != cmas._xmean[i] + ei)
+		  return CONT;
+	      }
+	    // as rounding is monotonic, the test holds for all axes when it holds
+	    // for their extreme coordinates, found once per eigen decomposition.
+	    else if (cmas._xmean[i] != cmas._xmean[i] + ei * cmas._leigenvectors_max(i)
+		     || cmas._xmean[i] != cmas._xmean[i] + ei * cmas._leigenvectors_min(i))
+	      return CONT;
 	  }
 	LOG_IF(INFO,!cmap._quiet) << "stopping criteria NoEffectAxis\n";
 	return NOEFFECTAXIS;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(NOEFFECTAXIS,StopCriteria<TGenoPheno>(noEffectAxis)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(NOEFFECTAXIS,noEffectAxis));
     StopCriteriaFunc<TGenoPheno> noEffectCoor = [](const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas)
       {
 	double fact = 0.2*cmas._sigma;
 	for (int i=0;i<cmap._dim;i++)
-	  if ((!cmap._sep && !cmap._vd && cmas._xmean[i] != cmas._xmean[i] + fact * sqrt(cmas._cov(i,i)))
-	      || ((cmap._sep || cmap._vd) && cmas._xmean[i] != cmas._xmean[i] + fact * sqrt(cmas._sepcov(i))))
+	  if ((!cmap._sep && !cmap._vd && !cmap._lm && !cmap._vkd && cmas._xmean[i] != cmas._xmean[i] + fact * sqrt(cmas._cov(i,i)))
+	      || ((cmap._sep || cmap._vd || cmap._lm || cmap._vkd) && cmas._xmean[i] != cmas._xmean[i] + fact * sqrt(cmas._sepcov(i))))
 	    return CONT;
 	LOG_IF(INFO,!cmap._quiet) << "stopping criteria NoEffectCoor\n";
 	return NOEFFECTCOOR;
       };
-    _scriteria.insert(std::pair<int,StopCriteria<TGenoPheno> >(NOEFFECTCOOR,StopCriteria<TGenoPheno>(noEffectCoor)));
+    scriteria.insert(std::pair<int,StopCriteriaFunc<TGenoPheno> >(NOEFFECTCOOR,noEffectCoor));
+
+    // flat array, in priority order, all active.
+    for (auto &sc: scriteria)
+      _scriteria.emplace_back(sc.first,sc.second);
+    for (size_t i=0;i<_scriteria.size();i++)
+      _active_criteria.set(i); // throws when the mask is too short.
+    bind_criteria();
+  }
+
+  template <class TGenoPheno>
+  CMAStopCriteria<TGenoPheno>::CMAStopCriteria(const CMAStopCriteria &sc)
+    :_scriteria(sc._scriteria),_active_criteria(sc._active_criteria),_active(sc._active)
+  {
+    bind_criteria();
   }
 
   template <class TGenoPheno>
@@ -255,6 +265,27 @@ namespace libcmaes
   {
   }
 
+  template <class TGenoPheno>
+  CMAStopCriteria<TGenoPheno>& CMAStopCriteria<TGenoPheno>::operator=(const CMAStopCriteria &sc)
+  {
+    _scriteria = sc._scriteria;
+    _active_criteria = sc._active_criteria;
+    _active = sc._active;
+    bind_criteria();
+    return *this;
+  }
+
+  template <class TGenoPheno>
+  void CMAStopCriteria<TGenoPheno>::bind_criteria()
+  {
+    // criteria read and write their bit of this set's mask.
+    for (size_t i=0;i<_scriteria.size();i++)
+      {
+	_scriteria[i]._mask = &_active_criteria;
+	_scriteria[i]._bit = i;
+      }
+  }
+
   template <class TGenoPheno>
   int CMAStopCriteria<TGenoPheno>::stop(const CMAParameters<TGenoPheno> &cmap, const CMASolutions &cmas) const
   {
@@ -264,9 +295,9 @@ namespace libcmaes
     if (!_active)
       return 0;
     int r = 0;
-    for (auto imap : _scriteria)
+    for (size_t i=0;i<_scriteria.size();i++)
       {
-	if (imap.second.active() && (r=imap.second._sfunc(cmap,cmas))!=0)
+	if (_active_criteria[i] && (r=_scriteria[i]._sfunc(cmap,cmas))!=0)
 	  {
 	    return r;
 	  }
@@ -281,11 +312,13 @@ namespace libcmaes
   template <class TGenoPheno>
   int CMAStopCriteria<TGenoPheno>::set_criteria_active(const int &c, const bool &active)
   {
-    auto mit = _scriteria.find(c);
-    if (mit == _scriteria.end())
-      return 1;
-    (*mit).second._active = active;
-    return 0;
+    for (size_t i=0;i<_scriteria.size();i++)
+      if (_scriteria[i]._code == c)
+	{
+	  _scriteria[i].set_active(active);
+	  return 0;
+	}
+    return 1;
   }
   
   template class CMAES_EXPORT CMAStopCriteria<GenoPheno<NoBoundStrategy> >;
@@ -28,6 +28,7 @@
 #include <chrono>
 #include <ctime>
 #include <iomanip>
+#include <type_traits>
 
 namespace libcmaes
 {
@@ -139,22 +140,44 @@ namespace libcmaes
   template <class TCovarianceUpdate, class TGenoPheno>
   CMAStrategy<TCovarianceUpdate,TGenoPheno>::~CMAStrategy()
   {
+    if (_async_esolver.valid())
+      _async_esolver.wait(); // no background decomposition outlives the strategy.
     if (!eostrat<TGenoPheno>::_parameters._fplot.empty())
       delete _fplotstream;
   }
   
   template <class TCovarianceUpdate, class TGenoPheno>
-  dMat CMAStrategy<TCovarianceUpdate,TGenoPheno>::ask()
+  void CMAStrategy<TCovarianceUpdate,TGenoPheno>::update_sampler()
   {
-#ifdef HAVE_DEBUG
-    std::chrono::time_point<std::chrono::system_clock> tstart = std::chrono::system_clock::now();
-#endif
-    
     // compute eigenvalues and eigenvectors.
-    if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd)
+    if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd && !eostrat<TGenoPheno>::_parameters._chol && !eostrat<TGenoPheno>::_parameters._lm && !eostrat<TGenoPheno>::_parameters._vkd)
       {
 	eostrat<TGenoPheno>::_solutions._updated_eigen = false;
-	if (eostrat<TGenoPheno>::_niter == 0 || !eostrat<TGenoPheno>::_parameters._lazy_update
+	if (eostrat<TGenoPheno>::_niter == 0 && _async_esolver.valid())
+	  _async_esolver.get(); // discard decomposition from a previous run.
+	if (eostrat<TGenoPheno>::_parameters._async_eigen && eostrat<TGenoPheno>::_niter > 0)
+	  {
+	    // pick up the background decomposition when done, or wait for it when too stale.
+	    if (_async_esolver.valid()
+		&& (_async_esolver.wait_for(std::chrono::seconds(0)) == std::future_status::ready
+		    || eostrat<TGenoPheno>::_niter - eostrat<TGenoPheno>::_solutions._eigeniter > std::max(1.0,eostrat<TGenoPheno>::_parameters._lazy_value)))
+	      {
+		_esolver.set_eigensolver(_async_esolver.get());
+		eostrat<TGenoPheno>::_solutions._eigeniter = _async_eigeniter;
+		eostrat<TGenoPheno>::_solutions._updated_eigen = true;
+	      }
+	    _esolver.setMean(eostrat<TGenoPheno>::_solutions._xmean);
+
+	    // decompose the last told covariance while the candidates are being evaluated.
+	    if (!_async_esolver.valid() && eostrat<TGenoPheno>::_solutions._eigeniter < eostrat<TGenoPheno>::_niter)
+	      {
+		_async_eigeniter = eostrat<TGenoPheno>::_niter;
+		_async_esolver = std::async(std::launch::async,
+					    [](const dMat &cov){ return Eigen::SelfAdjointEigenSolver<dMat>(cov); },
+					    eostrat<TGenoPheno>::_solutions._cov);
+	      }
+	  }
+	else if (eostrat<TGenoPheno>::_niter == 0 || !eostrat<TGenoPheno>::_parameters._lazy_update
 	    || eostrat<TGenoPheno>::_niter - eostrat<TGenoPheno>::_solutions._eigeniter > eostrat<TGenoPheno>::_parameters._lazy_value)
 	  {
 	    eostrat<TGenoPheno>::_solutions._eigeniter = eostrat<TGenoPheno>::_niter;
@@ -169,25 +192,37 @@ namespace libcmaes
 	_esolver.set_covar(eostrat<TGenoPheno>::_solutions._sepcov);
 	_esolver.set_transform(eostrat<TGenoPheno>::_solutions._sepcov.cwiseSqrt());
       }
-    else if (eostrat<TGenoPheno>::_parameters._vd)
+    else if (eostrat<TGenoPheno>::_parameters._vd || eostrat<TGenoPheno>::_parameters._lm || eostrat<TGenoPheno>::_parameters._vkd)
       {
 	_esolver.setMean(eostrat<TGenoPheno>::_solutions._xmean);
 	_esolver.set_covar(eostrat<TGenoPheno>::_solutions._sepcov);
       }
+    else if (eostrat<TGenoPheno>::_parameters._chol)
+      {
+	// no decomposition, the factor is maintained by the update.
+	_esolver.setMean(eostrat<TGenoPheno>::_solutions._xmean);
+	_esolver.set_transform(eostrat<TGenoPheno>::_solutions._csqrt);
+      }
 
     //debug
     //std::cout << "transform: " << _esolver._transform << std::endl;
     //debug
-    
-    // sample for multivariate normal distribution, produces one candidate per column.
-    dMat pop;
-    if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd)
-      pop = _esolver.samples(eostrat<TGenoPheno>::_parameters._lambda,eostrat<TGenoPheno>::_solutions._sigma); // Eq (1).
+  }
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  void CMAStrategy<TCovarianceUpdate,TGenoPheno>::transform_candidates(dMat &pop)
+  {
+    if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd && !eostrat<TGenoPheno>::_parameters._lm && !eostrat<TGenoPheno>::_parameters._vkd)
+      _esolver.transform(pop,eostrat<TGenoPheno>::_solutions._sigma); // Eq (1).
     else if (eostrat<TGenoPheno>::_parameters._sep)
-      pop = _esolver.samples_ind(eostrat<TGenoPheno>::_parameters._lambda,eostrat<TGenoPheno>::_solutions._sigma);
+      {
+	dVec sepsqrt = eostrat<TGenoPheno>::_solutions._sepcov.cwiseSqrt();
+	pop *= eostrat<TGenoPheno>::_solutions._sigma;
+	for (int i=0;i<pop.cols();i++)
+	  pop.col(i) = pop.col(i).cwiseProduct(sepsqrt) + eostrat<TGenoPheno>::_solutions._xmean;
+      }
     else if (eostrat<TGenoPheno>::_parameters._vd)
       {
-	pop = _esolver.samples_ind(eostrat<TGenoPheno>::_parameters._lambda);
 	double normv = eostrat<TGenoPheno>::_solutions._v.squaredNorm();
 	double fact = std::sqrt(1+normv)-1;
 	dVec vbar = eostrat<TGenoPheno>::_solutions._v / std::sqrt(normv);
@@ -198,6 +233,33 @@ namespace libcmaes
 	    pop.col(i) = eostrat<TGenoPheno>::_solutions._xmean + eostrat<TGenoPheno>::_solutions._sigma * eostrat<TGenoPheno>::_solutions._sepcov.cwiseProduct(pop.col(i));
 	  }
       }
+    else if (eostrat<TGenoPheno>::_parameters._lm)
+      {
+	LMCMAUpdate::transform(eostrat<TGenoPheno>::_solutions,pop);
+	pop *= eostrat<TGenoPheno>::_solutions._sigma;
+	pop.colwise() += eostrat<TGenoPheno>::_solutions._xmean;
+      }
+    else if (eostrat<TGenoPheno>::_parameters._vkd)
+      {
+	VkDCMAUpdate::sqrt_transform(eostrat<TGenoPheno>::_solutions,pop);
+	pop = (eostrat<TGenoPheno>::_solutions._sigma * eostrat<TGenoPheno>::_solutions._vkdd).asDiagonal() * pop;
+	pop.colwise() += eostrat<TGenoPheno>::_solutions._xmean;
+      }
+  }
+  
+  template <class TCovarianceUpdate, class TGenoPheno>
+  const dMat& CMAStrategy<TCovarianceUpdate,TGenoPheno>::ask()
+  {
+#ifdef HAVE_DEBUG
+    std::chrono::time_point<std::chrono::system_clock> tstart = std::chrono::system_clock::now();
+#endif
+    update_sampler();
+    
+    // sample for multivariate normal distribution, produces one candidate per column.
+    dMat &pop = eostrat<TGenoPheno>::_solutions._ws._pop;
+    _esolver.samples_ind(eostrat<TGenoPheno>::_parameters._lambda,pop);
+    transform_candidates(pop);
+    _compressed_pop = false;
     
     // gradient if available.
     if (eostrat<TGenoPheno>::_parameters._with_gradient)
@@ -208,10 +270,31 @@ namespace libcmaes
 	if (grad_at_mean != dVec::Zero(eostrat<TGenoPheno>::_parameters._dim))
 	  {
 	    dVec nx;
-	    if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd)
+	    if (eostrat<TGenoPheno>::_parameters._lm)
+	      {
+		dMat q = grad_at_mean;
+		LMCMAUpdate::transform(eostrat<TGenoPheno>::_solutions,q,true); // q = T^T g
+		double normq = q.squaredNorm();
+		LMCMAUpdate::transform(eostrat<TGenoPheno>::_solutions,q); // C g = T T^T g
+		nx = eostrat<TGenoPheno>::_solutions._xmean - eostrat<TGenoPheno>::_solutions._sigma * (sqrt(eostrat<TGenoPheno>::_parameters._dim / normq)) * q;
+	      }
+	    else if (eostrat<TGenoPheno>::_parameters._vkd)
 	      {
-		dMat sqrtcov = _esolver._eigenSolver.operatorSqrt();
-		dVec q = sqrtcov * grad_at_mean;
+		dMat q = eostrat<TGenoPheno>::_solutions._vkdd.cwiseProduct(grad_at_mean);
+		VkDCMAUpdate::sqrt_transform(eostrat<TGenoPheno>::_solutions,q); // q = (I+VSV^T)^1/2 D g
+		double normq = q.squaredNorm();
+		VkDCMAUpdate::sqrt_transform(eostrat<TGenoPheno>::_solutions,q);
+		nx = eostrat<TGenoPheno>::_solutions._xmean - eostrat<TGenoPheno>::_solutions._sigma * (sqrt(eostrat<TGenoPheno>::_parameters._dim / normq)) * eostrat<TGenoPheno>::_solutions._vkdd.cwiseProduct(q);
+	      }
+	    else if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd)
+	      {
+		dVec q;
+		if (!eostrat<TGenoPheno>::_parameters._chol)
+		  {
+		    dMat sqrtcov = _esolver._eigenSolver.operatorSqrt();
+		    q = sqrtcov * grad_at_mean;
+		  }
+		else q = eostrat<TGenoPheno>::_solutions._csqrt.transpose() * grad_at_mean; // ||A^T g|| = ||C^1/2 g||
 		double normq = q.squaredNorm();
 		nx = eostrat<TGenoPheno>::_solutions._xmean - eostrat<TGenoPheno>::_solutions._sigma * (sqrt(eostrat<TGenoPheno>::_parameters._dim / normq)) * eostrat<TGenoPheno>::_solutions._cov * grad_at_mean;
 	      }
@@ -225,12 +308,27 @@ namespace libcmaes
       {
 	dVec mean_shift = eostrat<TGenoPheno>::_solutions._xmean - eostrat<TGenoPheno>::_solutions._xmean_prev;
 	double mean_shift_norm = 1.0;
-	if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd)
+	if (eostrat<TGenoPheno>::_parameters._chol)
+	  mean_shift_norm = (eostrat<TGenoPheno>::_solutions._csqinv * mean_shift).norm() / eostrat<TGenoPheno>::_solutions._sigma;
+	else if (eostrat<TGenoPheno>::_parameters._lm)
+	  {
+	    dMat z = mean_shift;
+	    LMCMAUpdate::inverse_transform(eostrat<TGenoPheno>::_solutions,z);
+	    mean_shift_norm = z.norm() / eostrat<TGenoPheno>::_solutions._sigma;
+	  }
+	else if (eostrat<TGenoPheno>::_parameters._vkd)
+	  {
+	    dMat z = mean_shift.cwiseQuotient(eostrat<TGenoPheno>::_solutions._vkdd);
+	    VkDCMAUpdate::sqrt_transform(eostrat<TGenoPheno>::_solutions,z,true);
+	    mean_shift_norm = z.norm() / eostrat<TGenoPheno>::_solutions._sigma;
+	  }
+	else if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd)
 	  mean_shift_norm = (_esolver._eigenSolver.eigenvalues().cwiseSqrt().cwiseInverse().cwiseProduct(_esolver._eigenSolver.eigenvectors().transpose()*mean_shift)).norm() / eostrat<TGenoPheno>::_solutions._sigma;
 	else mean_shift_norm = eostrat<TGenoPheno>::_solutions._sepcov.cwiseSqrt().cwiseInverse().cwiseProduct(mean_shift).norm() / eostrat<TGenoPheno>::_solutions._sigma;
 	//std::cout << "mean_shift_norm=" << mean_shift_norm << " / sqrt(N)=" << std::sqrt(std::sqrt(eostrat<TGenoPheno>::_parameters._dim)) << std::endl;
 
-	dMat rz = _esolver.samples_ind(1);
+	dMat &rz = eostrat<TGenoPheno>::_solutions._ws._col;
+	_esolver.samples_ind(1,rz); // sized from the mean, the covariance is not set by every flavor.
 	double mfactor = rz.norm();
 	dVec z = mfactor * (mean_shift / mean_shift_norm);
 	eostrat<TGenoPheno>::_solutions._tpa_x1 = eostrat<TGenoPheno>::_solutions._xmean + z;
@@ -269,6 +367,105 @@ namespace libcmaes
     return pop;
   }
   
+  template <class TCovarianceUpdate, class TGenoPheno>
+  bool CMAStrategy<TCovarianceUpdate,TGenoPheno>::compressed_population() const
+  {
+    const CMAParameters<TGenoPheno> &p = eostrat<TGenoPheno>::_parameters;
+    return p._pop_chunk > 0 && !p._with_gradient && p._tpa < 2 && !p._uh
+      && !p._elitist && !p._initial_elitist && !p._initial_elitist_on_restart;
+  }
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  void CMAStrategy<TCovarianceUpdate,TGenoPheno>::sample_candidate(const int &r, dMat &x)
+  {
+    // candidate r is the r-th vector of the generation's bulk draw, always transformed
+    // alone so that the result does not depend on how candidates are grouped.
+    int dim = eostrat<TGenoPheno>::_parameters._dim;
+    x.resize(dim,1);
+    _esolver.normals_at(_pop_counter,static_cast<uint64_t>(r)*dim,x.data(),dim);
+    transform_candidates(x);
+    for (auto it=eostrat<TGenoPheno>::_parameters._fixed_p.begin();
+	 it!=eostrat<TGenoPheno>::_parameters._fixed_p.end();++it)
+      x((*it).first,0) = (*it).second;
+  }
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  const dMat& CMAStrategy<TCovarianceUpdate,TGenoPheno>::ask_eval_chunks()
+  {
+#ifdef HAVE_DEBUG
+    std::chrono::time_point<std::chrono::system_clock> tstart = std::chrono::system_clock::now();
+#endif
+    update_sampler();
+    CMASolutions &sols = eostrat<TGenoPheno>::_solutions;
+    const CMAParameters<TGenoPheno> &p = eostrat<TGenoPheno>::_parameters;
+    _pop_counter = _esolver.counter();
+    _esolver.skip(static_cast<long>(p._lambda)*p._dim); // the stream moves on as with ask().
+    _compressed_pop = true;
+
+    // candidates only keep their f-value and id, that locates their draw in the stream.
+    sols._candidates.resize(p._lambda);
+    for (Candidate &c: sols._candidates)
+      c.set_x(dVec());
+    sols._pop_x.resize(0,0);
+
+    dMat &chunk = sols._ws._pop;
+    dMat &phenochunk = sols._ws._phenopop;
+    for (int s=0;s<p._lambda;s+=p._pop_chunk)
+      {
+	int k = std::min(p._pop_chunk,p._lambda-s);
+	chunk.resize(p._dim,k);
+	for (int j=0;j<k;j++)
+	  {
+	    sample_candidate(s+j,sols._ws._col);
+	    chunk.col(j) = sols._ws._col;
+	  }
+	this->fitfunc_batch(p._gp.pheno(chunk,phenochunk),sols._ws._fvalues);
+	for (int j=0;j<k;j++)
+	  {
+	    sols._candidates.at(s+j).set_fvalue(sols._ws._fvalues(j));
+	    sols._candidates.at(s+j).set_id(s+j);
+	  }
+      }
+    this->update_fevals(p._lambda);
+
+#ifdef HAVE_DEBUG
+    std::chrono::time_point<std::chrono::system_clock> tstop = std::chrono::system_clock::now();
+    sols._elapsed_eval = std::chrono::duration_cast<std::chrono::milliseconds>(tstop-tstart).count();
+#endif
+    return sols._pop_x; // empty until the selected candidates are regenerated.
+  }
+
+  template <class TCovarianceUpdate, class TGenoPheno>
+  void CMAStrategy<TCovarianceUpdate,TGenoPheno>::regenerate_selected(const int &ntop, const int &nbottom)
+  {
+    CMASolutions &sols = eostrat<TGenoPheno>::_solutions;
+    int lambda = static_cast<int>(sols._candidates.size());
+    int dim = eostrat<TGenoPheno>::_parameters._dim;
+    int lo = std::min(ntop,lambda);
+    int hi = std::max(lambda-nbottom,lo);
+
+    // ranks read by the update, then by the history: k-th best and worst.
+    std::vector<int> &sel = sols._ws._sel;
+    sel.clear();
+    for (int i=0;i<lo;i++)
+      sel.push_back(i);
+    if (sols._kcand >= lo && sols._kcand < hi)
+      sel.push_back(sols._kcand);
+    if (hi == lambda && lambda-1 >= lo && lambda-1 != sols._kcand)
+      sel.push_back(lambda-1);
+    for (int i=hi;i<lambda;i++)
+      sel.push_back(i);
+
+    sols._pop_x.resize(dim,sel.size());
+    for (size_t j=0;j<sel.size();j++)
+      {
+	Candidate &c = sols._candidates.at(sel[j]);
+	sample_candidate(c.get_id(),sols._ws._col);
+	sols._pop_x.col(j) = sols._ws._col;
+	c.bind_x(sols._pop_x.col(j).data(),dim);
+      }
+  }
+  
   template <class TCovarianceUpdate, class TGenoPheno>
   void CMAStrategy<TCovarianceUpdate,TGenoPheno>::tell()
   {
@@ -280,10 +477,16 @@ namespace libcmaes
     std::chrono::time_point<std::chrono::system_clock> tstart = std::chrono::system_clock::now();
 #endif
     
-    // sort candidates.
-    if (!eostrat<TGenoPheno>::_parameters._uh)
+    // rank candidates: the updates only read the mu best, and the mu worst with active CMA,
+    // while TPA reads the ranks of its two mirrored candidates.
+    int nbottom = std::is_same<TCovarianceUpdate,ACovarianceUpdate>::value ? eostrat<TGenoPheno>::_parameters._mu : 0;
+    if (!eostrat<TGenoPheno>::_parameters._uh && eostrat<TGenoPheno>::_parameters._tpa == 2)
       eostrat<TGenoPheno>::_solutions.sort_candidates();
+    else if (!eostrat<TGenoPheno>::_parameters._uh)
+      eostrat<TGenoPheno>::_solutions.select_candidates(eostrat<TGenoPheno>::_parameters._mu,nbottom);
     else eostrat<TGenoPheno>::uncertainty_handling();
+    if (_compressed_pop)
+      regenerate_selected(eostrat<TGenoPheno>::_parameters._mu,nbottom);
     
     // call on tpa computation of s(t)
     if (eostrat<TGenoPheno>::_parameters._tpa == 2 && eostrat<TGenoPheno>::_niter > 0)
@@ -300,9 +503,25 @@ namespace libcmaes
 	eostrat<TGenoPheno>::_solutions._sigma *= eostrat<TGenoPheno>::_parameters._alphathuh;
 
     // other stuff.
-    if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd)
-      eostrat<TGenoPheno>::_solutions.update_eigenv(_esolver._eigenSolver.eigenvalues(),
-						    _esolver._eigenSolver.eigenvectors());
+    if (eostrat<TGenoPheno>::_parameters._chol)
+      {
+	// spectrum from the factor, as C=AA^T has the squared singular values of A as eigenvalues,
+	// and its left singular vectors as eigenvectors. Sampling does not need it, so that it is
+	// always refreshed at the pace of lazy updates.
+	if (eostrat<TGenoPheno>::_niter == 0
+	    || eostrat<TGenoPheno>::_niter - eostrat<TGenoPheno>::_solutions._eigeniter > eostrat<TGenoPheno>::_parameters._lazy_value)
+	  {
+	    eostrat<TGenoPheno>::_solutions._eigeniter = eostrat<TGenoPheno>::_niter;
+	    Eigen::BDCSVD<dMat> svd(eostrat<TGenoPheno>::_solutions._csqrt,Eigen::ComputeThinU);
+	    eostrat<TGenoPheno>::_solutions.update_eigenv(svd.singularValues().cwiseAbs2(),svd.matrixU());
+	  }
+      }
+    else if (!eostrat<TGenoPheno>::_parameters._sep && !eostrat<TGenoPheno>::_parameters._vd && !eostrat<TGenoPheno>::_parameters._lm && !eostrat<TGenoPheno>::_parameters._vkd)
+      {
+	if (eostrat<TGenoPheno>::_solutions._updated_eigen) // spectrum unchanged by a lazy update.
+	  eostrat<TGenoPheno>::_solutions.update_eigenv(_esolver._eigenSolver.eigenvalues(),
+							_esolver._eigenSolver.eigenvectors());
+      }
     else eostrat<TGenoPheno>::_solutions.update_eigenv(eostrat<TGenoPheno>::_solutions._sepcov,
 						       dMat::Constant(eostrat<TGenoPheno>::_parameters._dim,1,1.0));
 #ifdef HAVE_DEBUG
@@ -349,17 +568,22 @@ namespace libcmaes
 	this->update_fevals(1);
       }
     
+    // candidates held by the strategy are evaluated in place, those of a custom ask function by value.
+    const PopulationAskFunc *paskf = askf.template target<PopulationAskFunc>();
+    dMat askcandidates;
     std::chrono::time_point<std::chrono::system_clock> tstart = std::chrono::system_clock::now();
     while(!stop())
       {
-	dMat candidates = askf();
-	evalf(candidates,eostrat<TGenoPheno>::_parameters._gp.pheno(candidates));
+	const dMat &candidates = paskf ? paskf->_askf() : (askcandidates = askf());
+	evalf(candidates,eostrat<TGenoPheno>::_parameters._gp.pheno(candidates,eostrat<TGenoPheno>::_solutions._ws._phenopop));
 	tellf();
 	eostrat<TGenoPheno>::inc_iter();
 	std::chrono::time_point<std::chrono::system_clock> tstop = std::chrono::system_clock::now();
 	eostrat<TGenoPheno>::_solutions._elapsed_last_iter = std::chrono::duration_cast<std::chrono::milliseconds>(tstop-tstart).count();
 	tstart = std::chrono::system_clock::now();
       }
+    if (_async_esolver.valid())
+      _async_esolver.wait(); // join the background decomposition at run end.
     if (eostrat<TGenoPheno>::_parameters._with_edm)
       eostrat<TGenoPheno>::edm();
 
@@ -406,4 +630,16 @@ namespace libcmaes
   template class CMAStrategy<CovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
   template class CMAStrategy<ACovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
   template class CMAStrategy<VDCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAStrategy<CholeskyCovarianceUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAStrategy<CholeskyCovarianceUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAStrategy<CholeskyCovarianceUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAStrategy<CholeskyCovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAStrategy<LMCMAUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAStrategy<LMCMAUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAStrategy<LMCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAStrategy<LMCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAStrategy<VkDCMAUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAStrategy<VkDCMAUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAStrategy<VkDCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAStrategy<VkDCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
 }
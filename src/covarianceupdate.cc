@@ -31,21 +31,29 @@ namespace libcmaes
 				CMASolutions &solutions)
   {
     // compute mean, Eq. (2)
-    dVec xmean = dVec::Zero(parameters._dim);
+    dVec &xmean = solutions._ws._xmean;
+    xmean.setZero();
     for (int i=0;i<parameters._mu;i++)
-      xmean += parameters._weights[i] * solutions._candidates.at(i).get_x_dvec();
+      xmean += parameters._weights[i] * solutions._candidates.at(i).get_x_map();
     
     // reusable variables.
-    dVec diffxmean = 1.0/solutions._sigma * (xmean-solutions._xmean); // (m^{t+1}-m^t)/sigma^t
+    dVec &diffxmean = solutions._ws._diffxmean;
+    diffxmean = 1.0/solutions._sigma * (xmean-solutions._xmean); // (m^{t+1}-m^t)/sigma^t
     if (solutions._updated_eigen && !parameters._sep) //TODO: shall not recompute when using gradient, as it is computed in ask.
-      solutions._csqinv = esolver._eigenSolver.operatorInverseSqrt();
+      {
+	// C^{-1/2} = V.D^{-1}.V^T, through the workspace instead of operatorInverseSqrt() temporaries.
+	dMat &vd = solutions._ws._nn;
+	vd.resize(parameters._dim,parameters._dim);
+	vd.noalias() = esolver._eigenSolver.eigenvectors() * esolver._eigenSolver.eigenvalues().cwiseInverse().cwiseSqrt().asDiagonal();
+	solutions._csqinv.noalias() = vd * esolver._eigenSolver.eigenvectors().transpose();
+      }
     else if (parameters._sep)
       solutions._sepcsqinv = solutions._sepcov.cwiseInverse().cwiseSqrt();
     
     // update psigma, Eq. (3)
-    solutions._psigma = (1.0-parameters._csigma)*solutions._psigma;
+    solutions._psigma *= (1.0-parameters._csigma);
     if (!parameters._sep)
-      solutions._psigma += parameters._fact_ps * solutions._csqinv * diffxmean;
+      solutions._psigma.noalias() += parameters._fact_ps * solutions._csqinv * diffxmean;
     else
       solutions._psigma += parameters._fact_ps * solutions._sepcsqinv.cwiseProduct(diffxmean);
     double norm_ps = solutions._psigma.norm();
@@ -56,29 +64,29 @@ namespace libcmaes
     if (norm_ps < val_for_hsig)
       solutions._hsig = 1; //TODO: simplify equation instead.
     solutions._pc = (1.0-parameters._cc) * solutions._pc + solutions._hsig * parameters._fact_pc * diffxmean;
-    dMat spc;
-    if (!parameters._sep)
-      spc = solutions._pc * solutions._pc.transpose();
-    else spc = solutions._pc.cwiseProduct(solutions._pc);
     
     // covariance update, Eq (5).
-    dMat wdiff;
+    double alphacov = 1-parameters._c1-parameters._cmu+(1-solutions._hsig)*parameters._c1*parameters._cc*(2.0-parameters._cc);
     if (!parameters._sep)
-      wdiff = dMat::Zero(parameters._dim,parameters._dim);
-    else wdiff = dMat::Zero(parameters._dim,1);
-    for (int i=0;i<parameters._mu;i++)
       {
-	dVec difftmp = solutions._candidates.at(i).get_x_dvec() - solutions._xmean;
-	if (!parameters._sep)
-	  wdiff += parameters._weights[i] * (difftmp*difftmp.transpose());
-	else wdiff += parameters._weights[i] * (difftmp.cwiseProduct(difftmp));
+	// weighted selected steps, one per column, for the rank-mu update.
+	dMat &ys = solutions._ws._ys;
+	ys.resize(parameters._dim,parameters._mu);
+	for (int i=0;i<parameters._mu;i++)
+	  ys.col(i) = (std::sqrt(parameters._weights[i])/solutions._sigma) * (solutions._candidates.at(i).get_x_map() - solutions._xmean);
+	solutions._cov *= alphacov;
+	solutions._cov.noalias() += parameters._c1 * solutions._pc * solutions._pc.transpose();
+	solutions._cov.noalias() += parameters._cmu * ys * ys.transpose(); // Y.W.Y^T as a single blocked product.
       }
-    wdiff *= 1.0/(solutions._sigma*solutions._sigma);
-    if (!parameters._sep)
-      solutions._cov = (1-parameters._c1-parameters._cmu+(1-solutions._hsig)*parameters._c1*parameters._cc*(2.0-parameters._cc))*solutions._cov + parameters._c1*spc + parameters._cmu*wdiff;
     else
       {
-	solutions._sepcov = (1-parameters._c1-parameters._cmu+(1-solutions._hsig)*parameters._c1*parameters._cc*(2.0-parameters._cc))*solutions._sepcov + parameters._c1*spc + parameters._cmu*wdiff;
+	// the diagonal is already O(mu n), accumulated as w_i d_i^2 / sigma^2 so that results are unchanged.
+	dVec &wdiff = solutions._ws._sepplus;
+	wdiff.setZero(parameters._dim);
+	for (int i=0;i<parameters._mu;i++)
+	  wdiff += parameters._weights[i] * (solutions._candidates.at(i).get_x_map() - solutions._xmean).cwiseAbs2();
+	wdiff *= 1.0/(solutions._sigma*solutions._sigma);
+	solutions._sepcov = alphacov*solutions._sepcov + parameters._c1*solutions._pc.cwiseProduct(solutions._pc) + parameters._cmu*wdiff;
       }
     
     // sigma update, Eq. (6)
@@ -171,7 +171,8 @@ namespace libcmaes
     double fdelta = delta * fup;
     dVec xtmp = x;
     dVec phenoxtmp = parameters._gp.pheno(xtmp);
-    double fvalue = func(phenoxtmp.data(),xtmp.size());
+    std::shared_ptr<EvalCache> fcache = parameters.get_fcache(); // nearby points are often evaluated again.
+    double fvalue = fcache ? fcache->eval(func,phenoxtmp.data(),xtmp.size()) : func(phenoxtmp.data(),xtmp.size());
     double fdiff = fabs(fvalue - minfvalue);
     
     //debug
@@ -193,7 +194,7 @@ namespace libcmaes
 	    dv[k] = d;
 	    xtmp = x + eigenve.transpose() * dv; // search in rotated space
 	    phenoxtmp = parameters._gp.pheno(xtmp);
-	    fvalue = func(phenoxtmp.data(),xtmp.size());
+	    fvalue = fcache ? fcache->eval(func,phenoxtmp.data(),xtmp.size()) : func(phenoxtmp.data(),xtmp.size());
 	    fdiff = fabs(fvalue - minfvalue);
 
 	    //debug
@@ -215,7 +216,7 @@ namespace libcmaes
 	    dv[k] = d;
 	    xtmp = x + eigenve.transpose() * dv; // search in rotated space
 	    phenoxtmp = parameters._gp.pheno(xtmp);
-	    fvalue = func(phenoxtmp.data(),xtmp.size());
+	    fvalue = fcache ? fcache->eval(func,phenoxtmp.data(),xtmp.size()) : func(phenoxtmp.data(),xtmp.size());
 	    fdiff = fabs(fvalue - minfvalue);
 
 	    //debug
@@ -259,12 +260,14 @@ namespace libcmaes
     if (!pheno_vk)
       pvk = parameters.get_gp().pheno(pvk);
      
+    // the cache, if any, is keyed on full points, and the sub-search reaches it through them.
+    std::shared_ptr<EvalCache> fcache = parameters.get_fcache();
     if (rx0.size() == 0) // if all variables are fixed, simply return value for this point
       {
-	double fval = func(pvk.data(),pvk.size());
+	double fval = fcache ? fcache->eval(func,pvk.data(),pvk.size()) : func(pvk.data(),pvk.size());
 	CMASolutions rcmasol;
 	rcmasol._candidates.emplace_back(fval,pvk);
-	rcmasol._best_candidates_hist.push_back(cmasol._candidates.at(0));
+	rcmasol._best_candidate = cmasol._candidates.at(0);
 	rcmasol._nevals++;
 	return rcmasol;
       }
@@ -272,9 +275,12 @@ namespace libcmaes
 					  parameters.get_seed(),ngp);
     nparameters.set_initial_fvalue(true);
     nparameters.set_ftarget(parameters.get_ftarget());
+    nparameters.set_mt_feval(parameters.get_mt_feval()); // sub-searches share the evaluator.
+    nparameters.set_feval_threads(parameters.get_feval_threads());
+    nparameters.set_evaluator(parameters.get_evaluator());
     //nparameters.set_quiet(false);
     
-    FitFunc rfunc = [func,k,pvk](const double *x, const int N)
+    FitFunc rfunc = [func,fcache,k,pvk](const double *x, const int N)
       {
 	dVec nx(N);
 	for (int i=0;i<N;i++)
@@ -283,8 +289,27 @@ namespace libcmaes
 	  {
 	    addElement(nx,k[i],pvk[k[i]]); // in phenotype
 	  }
-	return func(nx.data(),nx.size());
+	return fcache ? fcache->eval(func,nx.data(),nx.size()) : func(nx.data(),nx.size());
       };
+    if (const BatchPointFunc *bpf = func.template target<BatchPointFunc>())
+      {
+	// batch objective function, the sub-search evaluates its populations at once as well.
+	BatchFitFunc bfunc = bpf->_bfunc;
+	rfunc = batch_fitfunc([bfunc,fcache,k,pvk](const dMat &x, dVec &fvalues)
+			      {
+				dMat nx(x.rows()+k.size(),x.cols());
+				for (int c=0;c<x.cols();c++)
+				  {
+				    dVec nxc = x.col(c);
+				    for (size_t i=0;i<k.size();i++)
+				      addElement(nxc,k[i],pvk[k[i]]); // in phenotype
+				    nx.col(c) = nxc;
+				  }
+				if (fcache)
+				  fcache->eval_batch(bfunc,nx,fvalues);
+				else bfunc(nx,fvalues);
+			      });
+      }
         
     CMASolutions cms = cmaes<TGenoPheno>(rfunc,nparameters);
     dVec nx = cms.best_candidate().get_x_dvec();
@@ -306,7 +331,7 @@ namespace libcmaes
       }
     CMASolutions rcmasol;
     rcmasol._candidates.emplace_back(cms.best_candidate().get_fvalue(),nx); // in genotype
-    rcmasol._best_candidates_hist.push_back(rcmasol._candidates.at(0));
+    rcmasol._best_candidate = rcmasol._candidates.at(0);
     rcmasol._nevals = cms._nevals;
     rcmasol._run_status = cms.run_status();
     return rcmasol;
@@ -24,6 +24,8 @@
 #include <libcmaes/cmaparameters.h> // in order to pre-instanciate template into library.
 #include <libcmaes/cmasolutions.h>
 #include <libcmaes/cmastopcriteria.h>
+#include <libcmaes/lmcmaupdate.h>
+#include <libcmaes/vkdcmaupdate.h>
 #include <iostream>
 #include <numeric>
 #include <libcmaes/llogging.h>
@@ -43,10 +45,18 @@ namespace libcmaes
 								 TParameters &parameters)
     :_func(func),_nevals(0),_niter(0),_parameters(parameters)
   {
+    if (const BatchPointFunc *bpf = func.template target<BatchPointFunc>())
+      _bfunc = bpf->_bfunc;
+    init_fcache();
     if (parameters._maximize)
       {
 	_funcaux = _func;
 	_func = [&](const double *x, const int N) { return -1.0*_funcaux(x,N); };
+	if (_bfunc)
+	  {
+	    BatchFitFunc bfunc = _bfunc;
+	    _bfunc = [bfunc](const dMat &x, dVec &fvalues) { bfunc(x,fvalues); fvalues *= -1.0; };
+	  }
       }
     _pfunc = [](const TParameters&,const TSolutions&){return 0;}; // high level progress function does do anything.
     _solutions = TSolutions(_parameters);
@@ -55,6 +65,7 @@ namespace libcmaes
 	std::random_device rd;
 	_uhgen = std::mt19937(rd());
 	_uhunif = std::uniform_real_distribution<>(0,1);
+	_uhesolver = Eigen::EigenMultivariateNormal<double>(false,_parameters._seed,1); // own stream, independent from sampling.
       }
   }
 
@@ -64,6 +75,9 @@ namespace libcmaes
 								 const TSolutions &solutions)
     :_func(func),_nevals(0),_niter(0),_parameters(parameters)
   {
+    if (const BatchPointFunc *bpf = func.template target<BatchPointFunc>())
+      _bfunc = bpf->_bfunc;
+    init_fcache();
     _pfunc = [](const TParameters&,const TSolutions&){return 0;}; // high level progress function does do anything.
     start_from_solution(solutions);
     if (parameters._uh)
@@ -71,6 +85,7 @@ namespace libcmaes
 	std::random_device rd;
 	_uhgen = std::mt19937(rd());
 	_uhunif = std::uniform_real_distribution<>(0,1);
+	_uhesolver = Eigen::EigenMultivariateNormal<double>(false,_parameters._seed,1); // own stream, independent from sampling.
       }
   }
   
@@ -86,15 +101,15 @@ namespace libcmaes
 #ifdef HAVE_DEBUG
     std::chrono::time_point<std::chrono::system_clock> tstart = std::chrono::system_clock::now();
 #endif
-    // one candidate per row.
-#pragma omp parallel for if (_parameters._mt_feval)
+    // one candidate per row, written into the contiguous population matrix.
+    _solutions.bind_population();
+    dVec &fvalues = _solutions._ws._fvalues;
+    fitfunc_batch(phenocandidates.size() ? phenocandidates : candidates,fvalues);
     for (int r=0;r<candidates.cols();r++)
       {
 	_solutions._candidates.at(r).set_x(candidates.col(r));
 	_solutions._candidates.at(r).set_id(r);
-	if (phenocandidates.size())
-	  _solutions._candidates.at(r).set_fvalue(_func(phenocandidates.col(r).data(),candidates.rows()));
-	else _solutions._candidates.at(r).set_fvalue(_func(candidates.col(r).data(),candidates.rows()));
+	_solutions._candidates.at(r).set_fvalue(fvalues(r));
 	
 	//std::cerr << "candidate x: " << _solutions._candidates.at(r)._x.transpose() << std::endl;
       }
@@ -160,6 +175,11 @@ namespace libcmaes
   {
     _nevals += evals;
     _solutions._nevals += evals;
+    if (_parameters._fcache)
+      {
+	_solutions._fcache_hits = _parameters._fcache->hits() - _fcache_hits0;
+	_solutions._fcache_misses = _parameters._fcache->misses() - _fcache_misses0;
+      }
   }
 
   template<class TParameters,class TSolutions,class TStopCriteria>
@@ -167,22 +187,65 @@ namespace libcmaes
   {
     if (_gfunc != nullptr)
       return _gfunc(x.data(),_parameters._dim);
-    dVec vgradf(_parameters._dim);
     dVec epsilon = 1e-8 * (dVec::Constant(_parameters._dim,1.0) + x.cwiseAbs());
-    double fx = _func(x.data(),_parameters._dim);
-#pragma omp parallel for if (_parameters._mt_feval)
+
+    // x, then x moved along each dimension, evaluated at once.
+    dMat ei = x.replicate(1,_parameters._dim+1);
     for (int i=0;i<_parameters._dim;i++)
       {
-	dVec ei1 = x;
-	ei1(i,0) += epsilon(i);
-	ei1(i,0) = std::min(ei1(i,0),_parameters.get_gp().get_boundstrategy_ref().getUBound(i));
-	double gradi = (_func(ei1.data(),_parameters._dim) - fx)/epsilon(i);
-	vgradf(i,0) = gradi;
+	ei(i,i+1) += epsilon(i);
+	ei(i,i+1) = std::min(ei(i,i+1),_parameters.get_gp().get_boundstrategy_ref().getUBound(i));
       }
+    dVec fei;
+    fitfunc_batch(ei,fei);
+    dVec vgradf = (fei.tail(_parameters._dim).array() - fei(0)) / epsilon.array();
     update_fevals(_parameters._dim+1); // numerical gradient increases the budget.
     return vgradf;
   }
 
+  template<class TParameters,class TSolutions,class TStopCriteria>
+  void ESOStrategy<TParameters,TSolutions,TStopCriteria>::fitfunc_batch(const dMat &x, dVec &fvalues)
+  {
+    fvalues.resize(x.cols());
+    if (_bfunc)
+      _bfunc(x,fvalues);
+    else evaluator().parallel_for(x.cols(),[&](const int &r)
+      {
+	fvalues(r) = _func(x.col(r).data(),x.rows());
+      });
+  }
+
+  template<class TParameters,class TSolutions,class TStopCriteria>
+  Evaluator& ESOStrategy<TParameters,TSolutions,TStopCriteria>::evaluator()
+  {
+    static Evaluator sequential;
+    if (_parameters._evaluator)
+      return *_parameters._evaluator;
+    if (!_parameters._mt_feval)
+      return sequential;
+    if (!_pool)
+      _pool = ThreadPool::shared(_parameters._feval_threads); // persists across generations and restarts.
+    return *_pool;
+  }
+
+  template<class TParameters,class TSolutions,class TStopCriteria>
+  void ESOStrategy<TParameters,TSolutions,TStopCriteria>::init_fcache()
+  {
+    std::shared_ptr<EvalCache> fcache = _parameters._fcache;
+    if (!fcache)
+      return;
+    // the cache holds values of the objective function itself, maximization aside.
+    FitFunc func = _func;
+    _func = [fcache,func](const double *x, const int N) { return fcache->eval(func,x,N); };
+    if (_bfunc)
+      {
+	BatchFitFunc bfunc = _bfunc;
+	_bfunc = [fcache,bfunc](const dMat &x, dVec &fvalues) { fcache->eval_batch(bfunc,x,fvalues); };
+      }
+    _fcache_hits0 = fcache->hits();
+    _fcache_misses0 = fcache->misses();
+  }
+
   template<class TParameters,class TSolutions,class TStopCriteria>
   dVec ESOStrategy<TParameters,TSolutions,TStopCriteria>::gradgp(const dVec &x) const
   {
@@ -199,7 +262,19 @@ namespace libcmaes
     dVec gradgpf = gradgp(_solutions._xmean);
     gradff = gradff.cwiseProduct(gradgpf);
     dMat gradmn;
-    if (!_parameters._sep)
+    if (_parameters._chol)
+      gradmn = _solutions._csqrt.transpose() * gradff;
+    else if (_parameters._lm)
+      {
+	gradmn = gradff;
+	LMCMAUpdate::transform(_solutions,gradmn,true);
+      }
+    else if (_parameters._vkd)
+      {
+	gradmn = _solutions._vkdd.cwiseProduct(gradff);
+	VkDCMAUpdate::sqrt_transform(_solutions,gradmn);
+      }
+    else if (!_parameters._sep)
       gradmn = _solutions._leigenvectors*_solutions._leigenvalues.cwiseSqrt().asDiagonal() * gradff;
     else gradmn = _solutions._sepcov.cwiseSqrt().cwiseProduct(gradff);
     double gradn = _solutions._sigma * gradmn.norm();
@@ -361,12 +436,13 @@ namespace libcmaes
   void ESOStrategy<TParameters,TSolutions,TStopCriteria>::eval_candidates_uh(const dMat& candidates, const dMat& candidates_uh, std::vector<RankedCandidate>& nvcandidates, int& nfcalls)
 	{
 	// re-evaluate
+	dVec nfvalues;
+	fitfunc_batch(candidates_uh,nfvalues);
 	for (int r=0;r<candidates.cols();r++)
 	  {
 	    if (r < _solutions._lambda_reev)
 	      {
-		double nfvalue = _func(candidates_uh.col(r).data(),candidates_uh.rows());
-		nvcandidates.emplace_back(nfvalue,_solutions._candidates.at(r),r);
+		nvcandidates.emplace_back(nfvalues(r),_solutions._candidates.at(r),r);
 		nfcalls++;
 	      }
 	    else nvcandidates.emplace_back(_solutions._candidates.at(r).get_fvalue(),_solutions._candidates.at(r),r);
@@ -0,0 +1,129 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/evalcache.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace libcmaes
+{
+  EvalCache::EvalCache(const int &capacity,
+		       const double &quantum,
+		       const int &nstripes)
+    :_capacity(std::max(capacity,1)),_quantum(quantum)
+  {
+    int ns = std::max(1,std::min(nstripes,_capacity));
+    _stripe_capacity = (_capacity + ns - 1) / ns;
+    for (int s=0;s<ns;s++)
+      _stripes.emplace_back(new Stripe());
+  }
+
+  size_t EvalCache::KeyHash::operator()(const Key &k) const
+  {
+    // FNV-1a over the bit patterns of the coordinates.
+    uint64_t h = 14695981039346656037ULL;
+    for (double v: k)
+      {
+	uint64_t b;
+	std::memcpy(&b,&v,sizeof(b));
+	h = (h ^ b) * 1099511628211ULL;
+      }
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+
+  void EvalCache::make_key(const double *x, const int &n, Key &k) const
+  {
+    k.resize(n);
+    for (int i=0;i<n;i++)
+      {
+	double v = _quantum > 0.0 ? std::round(x[i]/_quantum)*_quantum : x[i];
+	k[i] = v == 0.0 ? 0.0 : v; // -0 and +0 are the same point.
+      }
+  }
+
+  EvalCache::Stripe& EvalCache::stripe(const Key &k)
+  {
+    return *_stripes[(KeyHash()(k) >> 7) % _stripes.size()];
+  }
+
+  bool EvalCache::lookup(const double *x, const int &n, double &fvalue)
+  {
+    Key k;
+    make_key(x,n,k);
+    Stripe &s = stripe(k);
+    std::lock_guard<std::mutex> lock(s._mtx);
+    auto it = s._index.find(k);
+    if (it == s._index.end())
+      {
+	++_misses;
+	return false;
+      }
+    s._lru.splice(s._lru.begin(),s._lru,it->second);
+    fvalue = it->second->second;
+    ++_hits;
+    return true;
+  }
+
+  void EvalCache::insert(const double *x, const int &n, const double &fvalue)
+  {
+    Key k;
+    make_key(x,n,k);
+    Stripe &s = stripe(k);
+    std::lock_guard<std::mutex> lock(s._mtx);
+    auto it = s._index.find(k);
+    if (it != s._index.end())
+      {
+	it->second->second = fvalue;
+	s._lru.splice(s._lru.begin(),s._lru,it->second);
+	return;
+      }
+    if ((int)s._lru.size() >= _stripe_capacity)
+      {
+	s._index.erase(s._lru.back().first);
+	s._lru.pop_back();
+      }
+    s._lru.emplace_front(std::move(k),fvalue);
+    s._index.emplace(s._lru.front().first,s._lru.begin());
+  }
+
+  void EvalCache::clear()
+  {
+    for (auto &s: _stripes)
+      {
+	std::lock_guard<std::mutex> lock(s->_mtx);
+	s->_index.clear();
+	s->_lru.clear();
+      }
+  }
+
+  int EvalCache::size() const
+  {
+    int n = 0;
+    for (auto &s: _stripes)
+      {
+	std::lock_guard<std::mutex> lock(s->_mtx);
+	n += s->_lru.size();
+      }
+    return n;
+  }
+}
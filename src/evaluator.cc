@@ -0,0 +1,222 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/evaluator.h>
+#include <libcmaes/eo_matrix.h>
+#include <algorithm>
+#include <map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace libcmaes
+{
+  // whether the current thread is running a task, so that nested batches do not wait on their own pool.
+  static thread_local bool in_task = false;
+
+  // Eigen's parallel products are limited to a single thread while running tasks, unless
+  // the number of Eigen threads was set explicitly.
+  class TaskScope
+  {
+  public:
+    TaskScope()
+      :_in_task(in_task)
+    {
+      in_task = true;
+#ifdef _OPENMP
+      _omp_threads = omp_get_max_threads();
+      omp_set_num_threads(1);
+#endif
+    }
+
+    ~TaskScope()
+    {
+#ifdef _OPENMP
+      omp_set_num_threads(_omp_threads);
+#endif
+      in_task = _in_task;
+    }
+
+  private:
+    bool _in_task;
+    int _omp_threads = 1;
+  };
+
+  void Evaluator::parallel_for(const int &n, const EvalTask &task)
+  {
+    for (int i=0;i<n;i++)
+      task(i);
+  }
+
+  ThreadPool::ThreadPool(const int &nthreads)
+    :_remaining(0)
+  {
+    int nt = nthreads > 0 ? nthreads : default_nthreads();
+    for (int w=0;w<nt;w++)
+      _queues.emplace_back(new TaskQueue());
+    for (int w=1;w<nt;w++)
+      _workers.emplace_back(&ThreadPool::worker,this,w);
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      _stop = true;
+    }
+    _start_cv.notify_all();
+    for (std::thread &t: _workers)
+      t.join();
+  }
+
+  int ThreadPool::default_nthreads()
+  {
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    int eigen_threads = 1;
+    {
+      TaskScope scope; // as seen from within a task.
+      eigen_threads = Eigen::nbThreads();
+    }
+    return std::max(1,hw/std::max(1,eigen_threads));
+  }
+
+  std::shared_ptr<ThreadPool> ThreadPool::shared(const int &nthreads)
+  {
+    static std::mutex mtx;
+    static std::map<int,std::shared_ptr<ThreadPool>> pools;
+    int nt = nthreads > 0 ? nthreads : default_nthreads();
+    std::lock_guard<std::mutex> lock(mtx);
+    std::shared_ptr<ThreadPool> &pool = pools[nt];
+    if (!pool)
+      pool = std::make_shared<ThreadPool>(nt);
+    return pool;
+  }
+
+  void ThreadPool::parallel_for(const int &n, const EvalTask &task)
+  {
+    if (n <= 0)
+      return;
+    if (in_task || n == 1 || _queues.size() == 1)
+      {
+	Evaluator::parallel_for(n,task);
+	return;
+      }
+    std::lock_guard<std::mutex> call(_call_mtx);
+    _task = &task;
+    _error = nullptr;
+    _remaining = n;
+
+    // contiguous blocks of tasks, one per thread, that are later rebalanced by stealing.
+    int nq = static_cast<int>(_queues.size());
+    for (int q=0;q<nq;q++)
+      {
+	std::lock_guard<std::mutex> lock(_queues[q]->_mtx);
+	for (int i=(q*static_cast<long>(n))/nq;i<((q+1)*static_cast<long>(n))/nq;i++)
+	  _queues[q]->_tasks.push_back(i);
+      }
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      ++_epoch;
+    }
+    _start_cv.notify_all();
+
+    {
+      TaskScope scope;
+      run_tasks(0);
+    }
+    {
+      std::unique_lock<std::mutex> lock(_mtx);
+      _done_cv.wait(lock,[this]{ return _remaining.load() == 0; });
+    }
+    _task = nullptr;
+    if (_error)
+      std::rethrow_exception(_error);
+  }
+
+  void ThreadPool::worker(const int &w)
+  {
+    TaskScope scope;
+    unsigned long epoch = 0;
+    while(true)
+      {
+	{
+	  std::unique_lock<std::mutex> lock(_mtx);
+	  _start_cv.wait(lock,[this,&epoch]{ return _stop || _epoch != epoch; });
+	  if (_stop)
+	    return;
+	  epoch = _epoch;
+	}
+	run_tasks(w);
+      }
+  }
+
+  bool ThreadPool::next_task(const int &w, int &i)
+  {
+    int nq = static_cast<int>(_queues.size());
+    {
+      TaskQueue &own = *_queues[w];
+      std::lock_guard<std::mutex> lock(own._mtx);
+      if (!own._tasks.empty())
+	{
+	  i = own._tasks.front();
+	  own._tasks.pop_front();
+	  return true;
+	}
+    }
+    for (int k=1;k<nq;k++)
+      {
+	TaskQueue &victim = *_queues[(w+k)%nq];
+	std::lock_guard<std::mutex> lock(victim._mtx);
+	if (!victim._tasks.empty())
+	  {
+	    i = victim._tasks.back();
+	    victim._tasks.pop_back();
+	    return true;
+	  }
+      }
+    return false;
+  }
+
+  void ThreadPool::run_tasks(const int &w)
+  {
+    int i = 0;
+    while (next_task(w,i))
+      {
+	try
+	  {
+	    (*_task)(i);
+	  }
+	catch (...)
+	  {
+	    std::lock_guard<std::mutex> lock(_error_mtx);
+	    if (!_error)
+	      _error = std::current_exception();
+	  }
+	if (_remaining.fetch_sub(1) == 1)
+	  {
+	    std::lock_guard<std::mutex> lock(_mtx);
+	    _done_cv.notify_all();
+	  }
+      }
+  }
+
+}
@@ -22,6 +22,11 @@
 #include <libcmaes/ipopcmastrategy.h>
 #include <libcmaes/opti_err.h>
 #include <libcmaes/llogging.h>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
 #include <iostream>
 
 namespace libcmaes
@@ -57,6 +62,22 @@ namespace libcmaes
 							      const AskFunc &askf,
 							      const TellFunc &tellf)
   {
+    if (CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters._restart_threads != 1)
+      {
+	// runs with increasing population, in order as slots free up.
+	int r = 0;
+	return optimize_parallel([this,&r](CMAParameters<TGenoPheno> &rparameters, int &regime)
+				 {
+				   if (r >= CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters._nrestarts)
+				     return false;
+				   for (int i=0;i<r;i++)
+				     rparameters._lambda *= 2.0;
+				   rparameters.initialize_parameters();
+				   regime = 0;
+				   ++r;
+				   return true;
+				 });
+      }
     CMASolutions best_run;
     bool has_max_fevals = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters._max_fevals > 0;
     int fevals_max = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters._max_fevals;
@@ -115,6 +136,128 @@ namespace libcmaes
       best_run = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_solutions;
   }
 
+  template <class TCovarianceUpdate, class TGenoPheno>
+  int IPOPCMAStrategy<TCovarianceUpdate,TGenoPheno>::optimize_parallel(const std::function<bool (CMAParameters<TGenoPheno>&, int&)> &next)
+  {
+    CMAParameters<TGenoPheno> &parameters = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_parameters;
+    const bool has_max_fevals = parameters._max_fevals > 0;
+    const int fevals_max = parameters._max_fevals;
+    const int nthreads = parameters._restart_threads > 0 ? parameters._restart_threads : ThreadPool::default_nthreads();
+
+    // runs evaluate through the objective function of this strategy, that already
+    // accounts for maximization and the cache, and they do not plot.
+    FitFunc func = this->_bfunc ? batch_fitfunc(this->_bfunc) : this->_func;
+    CMAParameters<TGenoPheno> rparameters0 = parameters;
+    rparameters0._maximize = false;
+    rparameters0._fcache = nullptr;
+    rparameters0._fplot = "";
+    rparameters0._restart_threads = 1;
+
+    std::mutex mtx; // guards the shared state below, and the calls to the progress function.
+    CMASolutions best_run;
+    int fevals = CMAStrategy<TCovarianceUpdate,TGenoPheno>::_nevals;
+    int nruns = 0;
+    bool cancel = false;
+    std::exception_ptr error;
+    _budgets = {{0,0}};
+    _reserved = {{0,0}};
+
+    auto worker = [&]()
+      {
+	while (true)
+	  {
+	    CMAParameters<TGenoPheno> rparameters = rparameters0;
+	    int regime = 0;
+	    int reserve = 0; // part of the cap of the run it has not consumed yet.
+	    {
+	      std::lock_guard<std::mutex> lock(mtx);
+	      if (cancel || (has_max_fevals && fevals >= fevals_max))
+		return;
+	      if (!next(rparameters,regime))
+		return;
+	      rparameters._seed = parameters._seed + nruns++; // independent runs.
+	      if (has_max_fevals)
+		rparameters._max_fevals = rparameters._max_fevals > 0 ? std::min(rparameters._max_fevals,fevals_max-fevals) : fevals_max-fevals;
+	      if (rparameters._max_fevals > 0)
+		reserve = rparameters._max_fevals;
+	      else
+		{
+		  // uncapped runs reserve lambda times their iteration horizon, that of the
+		  // autoMaxIter criterion unless a maximum number of iterations is set.
+		  double horizon = rparameters._max_iter > 0 ? rparameters._max_iter
+		    : 100.0 + 50*pow(rparameters._dim+3,2) / sqrt(rparameters._lambda);
+		  reserve = static_cast<int>(std::min(rparameters._lambda*horizon,
+						      static_cast<double>(std::numeric_limits<int>::max()/(2*nthreads))));
+		}
+	      _reserved[regime] += reserve;
+	      LOG_IF(INFO,!parameters._quiet) << "parallel restart " << nruns << " / lambda=" << rparameters._lambda << " / sigma=" << rparameters._sigma_init << " / regime=" << regime << std::endl;
+	    }
+	    try
+	      {
+		CMAStrategy<TCovarianceUpdate,TGenoPheno> run(func,rparameters);
+		int last = 0;
+		auto consume = [&](const int &n)
+		  {
+		    fevals += n;
+		    _budgets[regime] += n;
+		    int r = std::min(n,reserve);
+		    reserve -= r;
+		    _reserved[regime] -= r;
+		  };
+		ProgressFunc<CMAParameters<TGenoPheno>,CMASolutions> pfunc = [&](const CMAParameters<TGenoPheno> &cmaparams, const CMASolutions &cmasols)
+		  {
+		    std::lock_guard<std::mutex> lock(mtx);
+		    consume(cmasols._nevals - last);
+		    last = cmasols._nevals;
+		    int status = this->_pfunc(cmaparams,cmasols);
+		    if (cancel || (has_max_fevals && fevals >= fevals_max))
+		      return 1;
+		    return status;
+		  };
+		run.set_progress_func(pfunc);
+		if (this->_gfunc)
+		  run.set_gradient_func(this->_gfunc);
+		run.optimize();
+
+		std::lock_guard<std::mutex> lock(mtx);
+		const CMASolutions &rsols = run.get_solutions();
+		consume(rsols._nevals - last);
+		_reserved[regime] -= reserve;
+		if (!rsols._candidates.empty()
+		    && (best_run._candidates.empty() || rsols.best_candidate().get_fvalue() < best_run.best_candidate().get_fvalue()))
+		  best_run = rsols;
+		if (rsols._run_status == FTARGET)
+		  cancel = true; // siblings stop at their next iteration.
+	      }
+	    catch (...)
+	      {
+		std::lock_guard<std::mutex> lock(mtx);
+		if (!error)
+		  error = std::current_exception();
+		_reserved[regime] -= reserve;
+		cancel = true;
+		return;
+	      }
+	  }
+      };
+    std::vector<std::thread> threads;
+    for (int t=0;t<nthreads;t++)
+      threads.emplace_back(worker);
+    for (std::thread &t: threads)
+      t.join();
+    if (error)
+      std::rethrow_exception(error);
+
+    LOG_IF(INFO,!parameters._quiet) << "parallel restarts ended after " << nruns << " runs / fevals=" << fevals << std::endl;
+    this->update_fevals(fevals - CMAStrategy<TCovarianceUpdate,TGenoPheno>::_nevals);
+    if (!best_run._candidates.empty())
+      CMAStrategy<TCovarianceUpdate,TGenoPheno>::_solutions = best_run;
+    this->update_fevals(0); // cache counters, if any.
+    if (CMAStrategy<TCovarianceUpdate,TGenoPheno>::_solutions._run_status >= 0)
+      return OPTI_SUCCESS;
+    return OPTI_ERR_TERMINATION; // exact termination code is in CMAStrategy<TCovarianceUpdate>::_solutions._run_status.
+  }
+
   template class CMAES_EXPORT IPOPCMAStrategy<CovarianceUpdate,GenoPheno<NoBoundStrategy>>;
   template class CMAES_EXPORT IPOPCMAStrategy<ACovarianceUpdate,GenoPheno<NoBoundStrategy>>;
   template class CMAES_EXPORT IPOPCMAStrategy<VDCMAUpdate,GenoPheno<NoBoundStrategy>>;
@@ -127,4 +270,16 @@ namespace libcmaes
   template class CMAES_EXPORT IPOPCMAStrategy<CovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
   template class CMAES_EXPORT IPOPCMAStrategy<ACovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
   template class CMAES_EXPORT IPOPCMAStrategy<VDCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<CholeskyCovarianceUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<LMCMAUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<LMCMAUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<LMCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<LMCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<VkDCMAUpdate,GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<VkDCMAUpdate,GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<VkDCMAUpdate,GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT IPOPCMAStrategy<VkDCMAUpdate,GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
 }
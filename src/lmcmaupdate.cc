@@ -0,0 +1,160 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/lmcmaupdate.h>
+#include <iostream>
+
+namespace libcmaes
+{
+
+  template <class TGenoPheno>
+  void LMCMAUpdate::update(const CMAParameters<TGenoPheno> &parameters,
+			   Eigen::EigenMultivariateNormal<double> &esolver,
+			   CMASolutions &solutions)
+  {
+    (void)esolver; // esolver is not needed, sampling uses the direction vectors.
+
+    // update of the mean.
+    dVec xmean = dVec::Zero(parameters._dim);
+    for (int i=0;i<parameters._mu;i++)
+      xmean += parameters._weights[i] * solutions._candidates.at(i).get_x_map();
+
+    // recover the selected standard normal steps z_i = T^-1 (x_i-m)/sigma.
+    dMat zs(parameters._dim,parameters._mu);
+    for (int i=0;i<parameters._mu;i++)
+      zs.col(i) = (solutions._candidates.at(i).get_x_map() - solutions._xmean) / solutions._sigma;
+    inverse_transform(solutions,zs);
+    dVec zmean = zs * parameters._weights;
+
+    // update psigma.
+    solutions._psigma = (1.0-parameters._csigma)*solutions._psigma + parameters._fact_ps * zmean;
+    double norm_ps = solutions._psigma.squaredNorm();
+
+    // update direction vectors, each with its own learning rate.
+    for (int j=0;j<solutions._lmvecs.cols();j++)
+      {
+	double cc = parameters._lm_cc[j];
+	solutions._lmvecs.col(j) = (1.0-cc)*solutions._lmvecs.col(j) + std::sqrt(parameters._muw*cc*(2.0-cc)) * zmean;
+      }
+    solutions._lmk = std::min(solutions._lmk+1,static_cast<int>(solutions._lmvecs.cols()));
+
+    // diagonal of the covariance serves the termination criteria and stds, its O(n m^2) cost is amortized over m iterations.
+    if (solutions._niter - solutions._eigeniter >= solutions._lmvecs.cols() || solutions._lmk < solutions._lmvecs.cols())
+      {
+	solutions._sepcov = cov_diagonal(solutions);
+	solutions._eigeniter = solutions._niter;
+      }
+
+    // update sigma.
+    if (parameters._tpa < 2)
+      solutions._sigma *= std::exp(0.5*parameters._csigma * (norm_ps / parameters._dim - 1.0));
+    else if (solutions._niter > 0)
+      solutions._sigma *= std::exp(solutions._tpa_s / parameters._dsigma);
+
+    // set mean.
+    if (parameters._tpa)
+      solutions._xmean_prev = solutions._xmean;
+    solutions._xmean = xmean;
+  }
+
+  void LMCMAUpdate::transform(const CMASolutions &solutions,
+			      dMat &z,
+			      const bool &transpose)
+  {
+    for (int l=0;l<solutions._lmk;l++)
+      {
+	int j = transpose ? solutions._lmk-1-l : l;
+	double cd = solutions._lmcd[j];
+	dMat::ConstColXpr m = solutions._lmvecs.col(j);
+	Eigen::RowVectorXd mz = m.transpose() * z;
+	z *= (1.0-cd);
+	z.noalias() += cd * m * mz;
+      }
+  }
+
+  void LMCMAUpdate::inverse_transform(const CMASolutions &solutions,
+				      dMat &y)
+  {
+    // ((1-c)I + c mm^T)^-1 = 1/(1-c) (I - c/(1-c+c|m|^2) mm^T)
+    for (int j=solutions._lmk-1;j>=0;j--)
+      {
+	double cd = solutions._lmcd[j];
+	dMat::ConstColXpr m = solutions._lmvecs.col(j);
+	double fact = cd / (1.0-cd+cd*m.squaredNorm());
+	Eigen::RowVectorXd my = m.transpose() * y;
+	y.noalias() -= fact * m * my;
+	y /= (1.0-cd);
+      }
+  }
+
+  void LMCMAUpdate::low_rank_form(const CMASolutions &solutions,
+				  double &alpha,
+				  dMat &P,
+				  dMat &Q)
+  {
+    // T_j (alpha I + PQ^T) = (1-c)alpha I + [(1-c)P, c m] [Q, alpha m + Q P^T m]^T
+    int n = solutions._lmvecs.rows();
+    int k = solutions._lmk;
+    alpha = 1.0;
+    P.resize(n,k);
+    Q.resize(n,k);
+    for (int j=0;j<k;j++)
+      {
+	double cd = solutions._lmcd[j];
+	dMat::ConstColXpr m = solutions._lmvecs.col(j);
+	dVec Ptm = P.leftCols(j).transpose() * m;
+	Q.col(j) = alpha * m;
+	Q.col(j).noalias() += Q.leftCols(j) * Ptm;
+	P.leftCols(j) *= (1.0-cd);
+	P.col(j) = cd * m;
+	alpha *= (1.0-cd);
+      }
+  }
+
+  dVec LMCMAUpdate::cov_diagonal(const CMASolutions &solutions)
+  {
+    // diag(TT^T) = alpha^2 + 2 alpha diag(PQ^T) + diag(P Q^TQ P^T)
+    double alpha;
+    dMat P, Q;
+    low_rank_form(solutions,alpha,P,Q);
+    dMat PG = P * (Q.transpose() * Q);
+    return (dVec::Constant(P.rows(),alpha*alpha)
+	    + 2.0*alpha*P.cwiseProduct(Q).rowwise().sum()
+	    + PG.cwiseProduct(P).rowwise().sum());
+  }
+
+  dMat LMCMAUpdate::full_cov(const CMASolutions &solutions)
+  {
+    double alpha;
+    dMat P, Q;
+    low_rank_form(solutions,alpha,P,Q);
+    dMat PQt = P * Q.transpose();
+    dMat cov = alpha * (PQt + PQt.transpose());
+    cov.noalias() += P * (Q.transpose() * Q) * P.transpose();
+    cov.diagonal().array() += alpha*alpha;
+    return cov;
+  }
+
+  template CMAES_EXPORT void LMCMAUpdate::update(const CMAParameters<GenoPheno<NoBoundStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void LMCMAUpdate::update(const CMAParameters<GenoPheno<pwqBoundStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void LMCMAUpdate::update(const CMAParameters<GenoPheno<NoBoundStrategy,linScalingStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void LMCMAUpdate::update(const CMAParameters<GenoPheno<pwqBoundStrategy,linScalingStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+}
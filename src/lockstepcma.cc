@@ -0,0 +1,656 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/lockstepcma.h>
+#include <libcmaes/cmaes.h>
+#include <libcmaes/llogging.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace libcmaes
+{
+  typedef Eigen::ArrayXd dArr;
+
+  /**
+   * \brief per-lane history of values, as kept by CMASolutions for the termination criteria.
+   */
+  struct LaneHistory
+  {
+    Eigen::internal::scalar_normal_dist_op<double> _rng; /**< the instance's normal generator. */
+    std::vector<int> _criteria; /**< active termination criteria, in CMAStopCriteria order. */
+    RingBuffer<double> _hist; /**< best value of the last generations. */
+    RingBuffer<double> _khist; /**< k-th best value of the last generations. */
+    RingBuffer<double> _bfvalues = RingBuffer<double>(20); /**< best value of the last 20 generations. */
+    RingBuffer<double> _medians; /**< median value of the last generations. */
+    std::vector<int> _order; /**< candidates of the last generation, best first. */
+    double _best_fvalue = std::numeric_limits<double>::quiet_NaN(); /**< best value seen. */
+    dVec _best_x; /**< best candidate seen. */
+    int _best_iter = 0; /**< generation of the best candidate seen. */
+    int _status = CONT;
+  };
+
+  template <class TGenoPheno>
+  struct LockstepCMA<TGenoPheno>::Lanes
+  {
+    int _dim;
+    int _lambda;
+    int _mu;
+    int _kcand; /**< rank of the k-th best candidate in the history. */
+    int _niter = 0;
+    int _eigeniter = 0;
+    dVec _weights;
+    std::vector<int> _ks; /**< instance of every lane. */
+    std::vector<LaneHistory> _hists;
+
+    // one row per lane, so that every column is a contiguous array over instances.
+    dMat _xmean;
+    dMat _psigma;
+    dMat _pc;
+    dMat _cov; /**< upper triangle of the covariance matrix, row by row. */
+    dMat _evals;
+    dMat _evecs; /**< eigenvectors, row-major. */
+    dMat _bd; /**< eigenvectors scaled by the square root of the eigenvalues, row-major. */
+    dMat _z; /**< standard normal draws, candidate by candidate. */
+    dMat _y; /**< steps, candidate by candidate. */
+    dMat _x; /**< candidates. */
+    dMat _fvalues;
+    dMat _ysel; /**< steps of the mu best candidates. */
+    dMat _zw; /**< weighted mean of the selected draws. */
+    dMat _nmean; /**< new mean. */
+    dMat _jm; /**< Jacobi iterate. */
+    dVec _sigma;
+    dVec _csigma, _cc, _c1, _cmu, _dsigma, _fact_ps, _fact_pc, _chi;
+    std::vector<double> _draws; /**< bulk draw of one lane. */
+
+    int cidx(const int &p, const int &q) const { return p*_dim - p*(p-1)/2 + q - p; } // p <= q.
+    int lanes() const { return static_cast<int>(_ks.size()); }
+  };
+
+  // keeps the rows in keep, in order.
+  template <class TMat>
+  static void compact_rows(TMat &m, const std::vector<int> &keep)
+  {
+    for (int c=0;c<m.cols();c++)
+      for (size_t i=0;i<keep.size();i++)
+	m(i,c) = m(keep[i],c);
+    m.conservativeResize(keep.size(),Eigen::NoChange);
+  }
+
+  // median of the m oldest values, as in termination criteria.
+  static double lane_median(const RingBuffer<double> &r, const int &m)
+  {
+    std::vector<double> v(m);
+    for (int i=0;i<m;i++)
+      v[i] = r[i];
+    std::sort(v.begin(),v.end());
+    size_t size = v.size();
+    return size % 2 == 0 ? (v[size/2-1] + v[size/2]) / 2 : v[size/2];
+  }
+
+  /**
+   * \brief Jacobi eigendecomposition of a block of lanes, see jacobi().
+   * @param m matrices
+   * @param v eigenvectors
+   * @param n dimension
+   * @param warm whether to start from the previous eigenvectors
+   * @param b first lane of the block
+   * @param nl number of lanes in the block
+   */
+  static void jacobi_lanes(dMat &m, dMat &v, const int &n, const bool &warm,
+			   const int &b, const int &nl)
+  {
+    auto mc = [&m,&b,&nl](const int &c) { return m.col(c).segment(b,nl).array(); };
+    auto vc = [&v,&b,&nl](const int &c) { return v.col(c).segment(b,nl).array(); };
+    auto idx = [n](const int &p, const int &q) { return p < q ? p*n - p*(p-1)/2 + q - p : q*n - q*(q-1)/2 + p - q; };
+    if (warm)
+      {
+	// m <- V^T m V, upper triangle.
+	dMat w(nl,n*n);
+	for (int i=0;i<n;i++)
+	  for (int j=0;j<n;j++)
+	    {
+	      auto wij = w.col(i*n+j).array();
+	      wij = mc(idx(i,0)) * vc(j);
+	      for (int k=1;k<n;k++)
+		wij += mc(idx(i,k)) * vc(k*n+j);
+	    }
+	for (int p=0;p<n;p++)
+	  for (int q=p;q<n;q++)
+	    {
+	      auto mpq = mc(idx(p,q));
+	      mpq = vc(p) * w.col(q).array();
+	      for (int i=1;i<n;i++)
+		mpq += vc(i*n+p) * w.col(i*n+q).array();
+	    }
+      }
+    const double eps = std::numeric_limits<double>::epsilon();
+    dArr theta(nl), t(nl), s(nl), tau(nl), g(nl);
+    bool rotated = true;
+    for (int sweep=0;sweep<50&&rotated;sweep++)
+      {
+	rotated = false;
+	for (int p=0;p<n-1;p++)
+	  for (int q=p+1;q<n;q++)
+	    {
+	      // off-diagonal elements below the precision of the diagonal are left as is.
+	      auto apq = mc(idx(p,q));
+	      auto app = mc(idx(p,p));
+	      auto aqq = mc(idx(q,q));
+	      if ((apq.abs() <= eps*(app*aqq).abs().sqrt()).all())
+		continue;
+	      rotated = true;
+	      // rotation that zeroes (p,q), the smaller angle for stability.
+	      theta = (aqq - app) / (2.0*(apq == 0.0).select(1.0,apq));
+	      t = (apq == 0.0).select(0.0,theta.sign().max(0.0)*2.0-1.0) / (theta.abs() + (theta.square()+1.0).sqrt());
+	      s = t*(t.square()+1.0).rsqrt();
+	      tau = s/(1.0+(t.square()+1.0).rsqrt());
+	      app -= t*apq;
+	      aqq += t*apq;
+	      for (int r=0;r<n;r++)
+		{
+		  if (r == p || r == q)
+		    continue;
+		  auto arp = mc(idx(r,p));
+		  auto arq = mc(idx(r,q));
+		  g = arp;
+		  arp -= s*(arq + g*tau);
+		  arq += s*(g - arq*tau);
+		}
+	      apq = 0.0;
+	      for (int r=0;r<n;r++)
+		{
+		  auto vrp = vc(r*n+p);
+		  auto vrq = vc(r*n+q);
+		  g = vrp;
+		  vrp -= s*(vrq + g*tau);
+		  vrq += s*(g - vrq*tau);
+		}
+	    }
+      }
+  }
+
+  /**
+   * \brief cyclic Jacobi eigendecomposition of one symmetric matrix per lane, with
+   *        every rotation applied to all lanes at once.
+   *        With previous eigenvectors, rotations start from the matrices in
+   *        that basis, which the covariance update only slightly perturbs, and
+   *        take fewer sweeps.
+   * @param m upper triangles of the matrices, row by row, one per row, overwritten by
+   *        the eigenvalues on the diagonal
+   * @param v eigenvectors, row-major, one set per row, previous eigenvectors if warm
+   * @param n dimension
+   * @param warm whether to start from the previous eigenvectors
+   */
+  static void jacobi(dMat &m, dMat &v, const int &n, const bool &warm)
+  {
+    if (!warm)
+      {
+	v.setZero(m.rows(),n*n);
+	for (int j=0;j<n;j++)
+	  v.col(j*n+j).setOnes();
+      }
+    // blocks of lanes, whose matrices stay in cache through the sweeps.
+    static const int block = 64;
+    for (int b=0;b<m.rows();b+=block)
+      jacobi_lanes(m,v,n,warm,b,std::min(block,static_cast<int>(m.rows())-b));
+  }
+
+  template <class TGenoPheno>
+  LockstepCMA<TGenoPheno>::LockstepCMA(const std::vector<FitFunc> &funcs,
+				       const std::vector<CMAParameters<TGenoPheno>> &parameters)
+    :_funcs(funcs),_parameters(parameters)
+  {
+    if (_funcs.size() != _parameters.size())
+      throw std::invalid_argument("lockstep cma: one objective function per set of parameters is required");
+    _solutions.reserve(_parameters.size());
+    for (size_t k=0;k<_parameters.size();k++)
+      _solutions.push_back(CMASolutions(_parameters[k]));
+  }
+
+  template <class TGenoPheno>
+  LockstepCMA<TGenoPheno>::~LockstepCMA()
+  {
+  }
+
+  template <class TGenoPheno>
+  bool LockstepCMA<TGenoPheno>::lockstep(const int &k) const
+  {
+    const CMAParameters<TGenoPheno> &p = _parameters.at(k);
+    return p._algo == CMAES_DEFAULT && !p._sep && !p._vd && !p._chol && !p._lm && !p._vkd
+      && p._tpa < 2 && !p._uh && !p._with_gradient && !p._with_edm
+      && !p._elitist && !p._initial_elitist && !p._initial_elitist_on_restart && !p._initial_fvalue
+      && p._fixed_p.empty() && !p._fcache && p._fplot.empty() && p._pop_chunk <= 0
+      && _solutions.at(k)._run_status >= 0;
+  }
+
+  template <class TGenoPheno>
+  int LockstepCMA<TGenoPheno>::optimize()
+  {
+    // instances that share dimension, population size, weights and eigendecomposition schedule run together.
+    std::vector<std::vector<int>> groups;
+    std::vector<int> others;
+    for (int k=0;k<size();k++)
+      {
+	if (!lockstep(k))
+	  {
+	    others.push_back(k);
+	    continue;
+	  }
+	const CMAParameters<TGenoPheno> &p = _parameters[k];
+	auto git = std::find_if(groups.begin(),groups.end(),[&](const std::vector<int> &g)
+				{
+				  const CMAParameters<TGenoPheno> &q = _parameters[g.front()];
+				  return q._dim == p._dim && q._lambda == p._lambda && q._mu == p._mu
+				    && q._weights == p._weights && q._lazy_update == p._lazy_update
+				    && q._lazy_value == p._lazy_value;
+				});
+	if (git == groups.end())
+	  groups.push_back(std::vector<int>(1,k));
+	else git->push_back(k);
+      }
+    for (const std::vector<int> &g: groups)
+      run_lockstep(g);
+    for (int k: others)
+      _solutions[k] = cmaes<TGenoPheno>(_funcs[k],_parameters[k]);
+    for (const CMASolutions &s: _solutions)
+      if (s._run_status < 0)
+	return OPTI_ERR_TERMINATION;
+    return OPTI_SUCCESS;
+  }
+
+  template <class TGenoPheno>
+  void LockstepCMA<TGenoPheno>::run_lockstep(const std::vector<int> &ks)
+  {
+    std::chrono::time_point<std::chrono::system_clock> tstart = std::chrono::system_clock::now();
+    const CMAParameters<TGenoPheno> &p0 = _parameters[ks.front()];
+    Lanes ls;
+    const int n = ls._dim = p0._dim;
+    const int lambda = ls._lambda = p0._lambda;
+    const int mu = ls._mu = p0._mu;
+    ls._kcand = _solutions[ks.front()]._kcand;
+    ls._weights = p0._weights;
+    ls._ks = ks;
+    int nl = ls.lanes();
+    int nc = n*(n+1)/2;
+    ls._hists.resize(nl);
+    ls._xmean.resize(nl,n);
+    ls._psigma.resize(nl,n);
+    ls._pc.resize(nl,n);
+    ls._cov.resize(nl,nc);
+    ls._sigma.resize(nl);
+    ls._csigma.resize(nl); ls._cc.resize(nl); ls._c1.resize(nl); ls._cmu.resize(nl);
+    ls._dsigma.resize(nl); ls._fact_ps.resize(nl); ls._fact_pc.resize(nl); ls._chi.resize(nl);
+    static const int criteria[] = {CONDITIONCOV,TOLUPSIGMA,TOLHISTFUN,TOLX,NOEFFECTAXIS,NOEFFECTCOOR,
+				   EQUALFUNVALS,STAGNATION,AUTOMAXITER,MAXFEVALS,MAXITER,FTARGET};
+    for (int a=0;a<nl;a++)
+      {
+	const CMAParameters<TGenoPheno> &p = _parameters[ks[a]];
+	const CMASolutions &s = _solutions[ks[a]];
+	ls._xmean.row(a) = s._xmean.transpose();
+	ls._psigma.row(a) = s._psigma.transpose();
+	ls._pc.row(a) = s._pc.transpose();
+	for (int i=0;i<n;i++)
+	  for (int j=i;j<n;j++)
+	    ls._cov(a,ls.cidx(i,j)) = s._cov(i,j);
+	ls._sigma(a) = s._sigma;
+	ls._csigma(a) = p._csigma; ls._cc(a) = p._cc; ls._c1(a) = p._c1; ls._cmu(a) = p._cmu;
+	ls._dsigma(a) = p._dsigma; ls._fact_ps(a) = p._fact_ps; ls._fact_pc(a) = p._fact_pc; ls._chi(a) = p._chi;
+	LaneHistory &h = ls._hists[a];
+	h._rng.seed(p._seed); // the stream CMAStrategy samples from.
+	for (int c: criteria)
+	  {
+	    auto mit = p._stoppingcrit.find(c);
+	    if (mit == p._stoppingcrit.end() || (*mit).second)
+	      h._criteria.push_back(c);
+	  }
+	h._hist.set_capacity(s._max_hist);
+	h._khist.set_capacity(s._max_hist);
+      }
+    ls._draws.resize(lambda*n);
+    dArr normps(nl), hsig(nl), alphacov(nl);
+
+    while (true)
+      {
+	// termination, ahead of every generation but the first, as with CMAStrategy::stop().
+	if (ls._niter > 0)
+	  {
+	    std::vector<int> keep;
+	    for (int a=0;a<nl;a++)
+	      {
+		LaneHistory &h = ls._hists[a];
+		if ((h._status = stop_lane(ls,a)) == CONT)
+		  {
+		    keep.push_back(a);
+		    continue;
+		  }
+
+		// hand the final state over to the instance solutions.
+		const int k = ls._ks[a];
+		CMASolutions &s = _solutions[k];
+		s._xmean = ls._xmean.row(a).transpose();
+		s._psigma = ls._psigma.row(a).transpose();
+		s._pc = ls._pc.row(a).transpose();
+		for (int i=0;i<n;i++)
+		  for (int j=i;j<n;j++)
+		    s._cov(i,j) = s._cov(j,i) = ls._cov(a,ls.cidx(i,j));
+		s._sigma = ls._sigma(a);
+		s._niter = ls._niter;
+		s._nevals = ls._niter*lambda;
+		s._eigeniter = ls._eigeniter;
+		s._run_status = h._status;
+		std::vector<int> eorder(n);
+		std::iota(eorder.begin(),eorder.end(),0);
+		std::sort(eorder.begin(),eorder.end(),[&](const int &i, const int &j){ return ls._evals(a,i) < ls._evals(a,j); });
+		dVec evals(n);
+		dMat evecs(n,n);
+		for (int j=0;j<n;j++)
+		  {
+		    evals(j) = ls._evals(a,eorder[j]);
+		    for (int i=0;i<n;i++)
+		      evecs(i,j) = ls._evecs(a,i*n+eorder[j]);
+		  }
+		s.update_eigenv(evals,evecs);
+		for (int r=0;r<lambda;r++)
+		  {
+		    int c = h._order[r];
+		    s._candidates.at(r).set_x(ls._x.block(a,c*n,1,n).transpose());
+		    s._candidates.at(r).set_fvalue(ls._fvalues(a,c));
+		    s._candidates.at(r).set_id(c);
+		  }
+		s._niter = ls._niter - 1; // history of the last generation.
+		s.update_best_candidates();
+		s._niter = ls._niter;
+		s._best_seen_candidate = Candidate(h._best_fvalue,h._best_x);
+		s._best_seen_iter = h._best_iter;
+		s._elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()-tstart).count();
+		LOG_IF(INFO,!_parameters[k]._quiet) << "lockstep instance " << k << " stopped at iter " << ls._niter << ": " << s.status_msg() << std::endl;
+	      }
+	    if ((int)keep.size() < nl)
+	      {
+		std::vector<int> nks;
+		std::vector<LaneHistory> nhists;
+		for (int a: keep)
+		  {
+		    nks.push_back(ls._ks[a]);
+		    nhists.push_back(std::move(ls._hists[a]));
+		  }
+		ls._ks.swap(nks);
+		ls._hists.swap(nhists);
+		for (dMat *m: {&ls._xmean,&ls._psigma,&ls._pc,&ls._cov,&ls._evals,&ls._evecs,&ls._bd})
+		  compact_rows(*m,keep);
+		for (dVec *v: {&ls._sigma,&ls._csigma,&ls._cc,&ls._c1,&ls._cmu,&ls._dsigma,&ls._fact_ps,&ls._fact_pc,&ls._chi})
+		  compact_rows(*v,keep);
+		nl = ls.lanes();
+		normps.resize(nl);
+		hsig.resize(nl);
+		alphacov.resize(nl);
+	      }
+	    if (nl == 0)
+	      break;
+	  }
+
+	// eigendecomposition, on the CMAStrategy lazy update schedule.
+	if (ls._niter == 0 || !p0._lazy_update || ls._niter - ls._eigeniter > p0._lazy_value)
+	  {
+	    ls._eigeniter = ls._niter;
+	    ls._jm = ls._cov;
+	    jacobi(ls._jm,ls._evecs,n,ls._niter > 0);
+	    ls._evals.resize(nl,n);
+	    ls._bd.resize(nl,n*n);
+	    for (int j=0;j<n;j++)
+	      {
+		ls._evals.col(j) = ls._jm.col(ls.cidx(j,j));
+		dArr sqev = ls._evals.col(j).array().max(0.0).sqrt();
+		for (int i=0;i<n;i++)
+		  ls._bd.col(i*n+j).array() = ls._evecs.col(i*n+j).array() * sqev;
+	      }
+	  }
+
+	// sampling, Eq (1): the draws of a lane are those of CMAStrategy::ask().
+	ls._z.resize(nl,lambda*n);
+	ls._y.resize(nl,lambda*n);
+	ls._x.resize(nl,lambda*n);
+	for (int a=0;a<nl;a++)
+	  {
+	    ls._hists[a]._rng.fill(ls._draws.data(),lambda*n);
+	    for (int c=0;c<lambda*n;c++)
+	      ls._z(a,c) = ls._draws[c];
+	  }
+	for (int r=0;r<lambda;r++)
+	  for (int i=0;i<n;i++)
+	    {
+	      auto yri = ls._y.col(r*n+i).array();
+	      yri = ls._bd.col(i*n).array() * ls._z.col(r*n).array();
+	      for (int j=1;j<n;j++)
+		yri += ls._bd.col(i*n+j).array() * ls._z.col(r*n+j).array();
+	      ls._x.col(r*n+i).array() = ls._xmean.col(i).array() + ls._sigma.array() * yri;
+	    }
+
+	// evaluation, lane by lane.
+	ls._fvalues.resize(nl,lambda);
+	dMat pop(n,lambda), phenobuf;
+	for (int a=0;a<nl;a++)
+	  {
+	    const int k = ls._ks[a];
+	    for (int r=0;r<lambda;r++)
+	      pop.col(r) = ls._x.block(a,r*n,1,n).transpose();
+	    const dMat &phenopop = _parameters[k]._gp.pheno(pop,phenobuf);
+	    for (int r=0;r<lambda;r++)
+	      {
+		double f = _funcs[k](phenopop.col(r).data(),n);
+		ls._fvalues(a,r) = _parameters[k]._maximize ? -f : f;
+	      }
+	  }
+
+	// selection and history, lane by lane.
+	ls._ysel.resize(nl,mu*n);
+	ls._zw.setZero(nl,n);
+	ls._nmean.setZero(nl,n);
+	for (int a=0;a<nl;a++)
+	  {
+	    LaneHistory &h = ls._hists[a];
+	    h._order.resize(lambda);
+	    std::iota(h._order.begin(),h._order.end(),0);
+	    std::sort(h._order.begin(),h._order.end(),[&](const int &i, const int &j)
+		      {
+			double fi = ls._fvalues(a,i), fj = ls._fvalues(a,j);
+			if (std::isnan(fi) || std::isnan(fj)) // NaN ranks worst.
+			  return std::isnan(fi) != std::isnan(fj) ? std::isnan(fj) : i < j;
+			return fi < fj || (fi == fj && i < j);
+		      });
+	    for (int i=0;i<mu;i++)
+	      {
+		int c = h._order[i];
+		double w = ls._weights(i);
+		for (int j=0;j<n;j++)
+		  {
+		    ls._nmean(a,j) += w * ls._x(a,c*n+j);
+		    ls._zw(a,j) += w * ls._z(a,c*n+j);
+		    ls._ysel(a,i*n+j) = ls._y(a,c*n+j);
+		  }
+	      }
+	    double fbest = ls._fvalues(a,h._order[0]);
+	    h._hist.push_back(fbest);
+	    h._khist.push_back(ls._fvalues(a,h._order[ls._kcand]));
+	    h._bfvalues.push_back(fbest);
+	    double median = lambda % 2 == 0 ? (ls._fvalues(a,h._order[lambda/2-1]) + ls._fvalues(a,h._order[lambda/2]))/2.0 : ls._fvalues(a,h._order[lambda/2]);
+	    h._medians.set_capacity(static_cast<int>(ceil(0.2*ls._niter+120+30*n/static_cast<double>(lambda))));
+	    h._medians.push_back(median);
+	    if (ls._niter == 0 || fbest < h._best_fvalue)
+	      {
+		h._best_fvalue = fbest;
+		h._best_x = ls._x.block(a,h._order[0]*n,1,n).transpose();
+		h._best_iter = ls._niter;
+	      }
+	  }
+
+	// update, Eq (3) to (6), as in CovarianceUpdate, across lanes.
+	// C^{-1/2} (m'-m)/sigma is B.zw, with the same decomposition as the draws.
+	for (int i=0;i<n;i++)
+	  {
+	    auto psi = ls._psigma.col(i).array();
+	    psi *= 1.0-ls._csigma.array();
+	    for (int j=0;j<n;j++)
+	      psi += ls._fact_ps.array() * ls._evecs.col(i*n+j).array() * ls._zw.col(j).array();
+	  }
+	normps = ls._psigma.rowwise().norm().array();
+	for (int a=0;a<nl;a++)
+	  hsig(a) = normps(a) < sqrt(1.0-pow(1.0-ls._csigma(a),2.0*(ls._niter+1)))*(1.4+2.0/(n+1))*ls._chi(a) ? 1.0 : 0.0;
+	for (int i=0;i<n;i++)
+	  ls._pc.col(i).array() = (1.0-ls._cc.array())*ls._pc.col(i).array()
+	    + hsig*ls._fact_pc.array()*(ls._nmean.col(i).array()-ls._xmean.col(i).array())/ls._sigma.array();
+	alphacov = 1.0-ls._c1.array()-ls._cmu.array()+(1.0-hsig)*ls._c1.array()*ls._cc.array()*(2.0-ls._cc.array());
+	for (int i=0;i<n;i++)
+	  for (int j=i;j<n;j++)
+	    {
+	      auto cij = ls._cov.col(ls.cidx(i,j)).array();
+	      cij = alphacov*cij + ls._c1.array()*ls._pc.col(i).array()*ls._pc.col(j).array();
+	      for (int r=0;r<mu;r++)
+		cij += (ls._cmu.array()*ls._weights(r)) * ls._ysel.col(r*n+i).array() * ls._ysel.col(r*n+j).array();
+	    }
+	ls._sigma.array() *= ((ls._csigma.array()/ls._dsigma.array()) * (normps/ls._chi.array() - 1.0)).exp();
+	ls._xmean.swap(ls._nmean);
+	++ls._niter;
+      }
+  }
+
+  template <class TGenoPheno>
+  int LockstepCMA<TGenoPheno>::stop_lane(const Lanes &ls, const int &a) const
+  {
+    const CMAParameters<TGenoPheno> &cmap = _parameters[ls._ks[a]];
+    const CMASolutions &cmas = _solutions[ls._ks[a]];
+    const LaneHistory &h = ls._hists[a];
+    const int n = ls._dim;
+    const double sigma = ls._sigma(a);
+    for (int c: h._criteria)
+      {
+	switch (c)
+	  {
+	  case CONDITIONCOV:
+	    if (ls._evals.row(a).maxCoeff() / ls._evals.row(a).minCoeff() > 1e14)
+	      return c;
+	    break;
+	  case TOLUPSIGMA:
+	    if (sigma / cmap._sigma_init > 1e20 * sqrt(ls._evals.row(a).maxCoeff()))
+	      return c;
+	    break;
+	  case TOLHISTFUN:
+	    {
+	      int histsize = h._hist.size();
+	      int histthresh = std::min(cmas._max_hist,static_cast<int>(10+ceil(30*cmap._dim/cmap._lambda)));
+	      if (histsize < histthresh)
+		break;
+	      double fmin = h._hist[histsize-1], fmax = fmin;
+	      for (int i=histsize-histthresh;i<histsize;i++)
+		{
+		  fmin = std::min(fmin,h._hist[i]);
+		  fmax = std::max(fmax,h._hist[i]);
+		}
+	      if (fabs(fmax-fmin) < std::max(cmap._ftolerance,1e-12))
+		return c;
+	      break;
+	    }
+	  case TOLX:
+	    {
+	      double tfactor = std::max(cmap._xtol,1e-12) * sigma / cmap._sigma_init;
+	      bool tolx = true;
+	      for (int i=0;i<n && tolx;i++)
+		tolx = ls._pc(a,i) < tfactor && sqrt(ls._cov(a,ls.cidx(i,i))) < tfactor;
+	      if (tolx)
+		return c;
+	      break;
+	    }
+	  case NOEFFECTAXIS:
+	    {
+	      double fact = 0.1*sigma;
+	      bool noeffect = true;
+	      for (int i=0;i<n && noeffect;i++)
+		{
+		  double ei = fact * sqrt(ls._evals(a,i));
+		  for (int j=0;j<n && noeffect;j++)
+		    noeffect = ls._xmean(a,i) == ls._xmean(a,i) + ei * ls._evecs(a,i*n+j);
+		}
+	      if (noeffect)
+		return c;
+	      break;
+	    }
+	  case NOEFFECTCOOR:
+	    {
+	      double fact = 0.2*sigma;
+	      bool noeffect = true;
+	      for (int i=0;i<n && noeffect;i++)
+		noeffect = ls._xmean(a,i) == ls._xmean(a,i) + fact * sqrt(ls._cov(a,ls.cidx(i,i)));
+	      if (noeffect)
+		return c;
+	      break;
+	    }
+	  case EQUALFUNVALS:
+	    {
+	      int histsize = h._hist.size();
+	      int histlength = std::min(n,histsize);
+	      if (histlength < cmas._max_hist)
+		break;
+	      int ne = 0;
+	      for (int i=0;i<histlength;i++)
+		if (h._hist[histsize-1-i] == h._khist[histsize-1-i])
+		  ne++;
+	      if (ne > histlength / 3.0)
+		return c;
+	      break;
+	    }
+	  case STAGNATION:
+	    {
+	      if (h._bfvalues.size() < 20 || h._medians.size() < 20)
+		break;
+	      if (lane_median(h._bfvalues,20) >= lane_median(h._medians,20))
+		return c;
+	      break;
+	    }
+	  case AUTOMAXITER:
+	    if (ls._niter >= 100.0 + 50*pow(cmap._dim+3,2) / sqrt(cmap._lambda))
+	      return c;
+	    break;
+	  case MAXFEVALS:
+	    if (cmap._max_fevals != -1 && ls._niter*ls._lambda >= cmap._max_fevals)
+	      return c;
+	    break;
+	  case MAXITER:
+	    if (cmap._max_iter != -1 && ls._niter >= cmap._max_iter)
+	      return c;
+	    break;
+	  case FTARGET:
+	    if (cmap._ftarget != std::numeric_limits<double>::infinity() && h._hist.back() <= cmap._ftarget)
+	      return c;
+	    break;
+	  }
+      }
+    return CONT;
+  }
+
+  template class CMAES_EXPORT LockstepCMA<GenoPheno<NoBoundStrategy>>;
+  template class CMAES_EXPORT LockstepCMA<GenoPheno<pwqBoundStrategy>>;
+  template class CMAES_EXPORT LockstepCMA<GenoPheno<NoBoundStrategy,linScalingStrategy>>;
+  template class CMAES_EXPORT LockstepCMA<GenoPheno<pwqBoundStrategy,linScalingStrategy>>;
+}
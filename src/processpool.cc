@@ -0,0 +1,425 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/processpool.h>
+#include <libcmaes/llogging.h>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+namespace libcmaes
+{
+#ifndef _WIN32
+  static const char *worker_env = "LIBCMAES_WORKER";
+
+  // reads or writes exactly n bytes, false on end of stream or error.
+  static bool read_full(const int &fd, void *buf, const size_t &n)
+  {
+    size_t done = 0;
+    while (done < n)
+      {
+	ssize_t r = ::read(fd,static_cast<char*>(buf)+done,n-done);
+	if (r < 0 && errno == EINTR)
+	  continue;
+	if (r <= 0)
+	  return false;
+	done += r;
+      }
+    return true;
+  }
+
+  static bool write_full(const int &fd, const void *buf, const size_t &n)
+  {
+    size_t done = 0;
+    while (done < n)
+      {
+#ifdef MSG_NOSIGNAL
+	ssize_t r = ::send(fd,static_cast<const char*>(buf)+done,n-done,MSG_NOSIGNAL);
+#else
+	ssize_t r = ::write(fd,static_cast<const char*>(buf)+done,n-done);
+#endif
+	if (r < 0 && errno == EINTR)
+	  continue;
+	if (r <= 0)
+	  return false;
+	done += r;
+      }
+    return true;
+  }
+
+  // number of threads of this process, 0 when it cannot be told.
+  static int nthreads()
+  {
+    DIR *d = ::opendir("/proc/self/task");
+    if (!d)
+      return 0;
+    int n = 0;
+    while (dirent *e = ::readdir(d))
+      if (e->d_name[0] != '.')
+	++n;
+    ::closedir(d);
+    return n;
+  }
+
+  // evaluates the slots the doorbells point to, until the pool closes the socket.
+  static int run_worker(FitFunc &func, const int &sock, double *slots, const int &dim)
+  {
+    uint32_t s;
+    while (read_full(sock,&s,sizeof(s)))
+      {
+	double *x = slots + static_cast<size_t>(s)*(dim+1);
+	x[dim] = func(x,dim);
+	if (!write_full(sock,&s,sizeof(s)))
+	  return 1;
+      }
+    return 0;
+  }
+
+  ProcessPool::ProcessPool(const std::vector<std::string> &command,
+			   const int &nworkers,
+			   const int &dim,
+			   const int &depth)
+    :_command(command),_dim(dim),_depth(depth),_workers(nworkers)
+  {
+    if (_command.empty())
+      throw std::invalid_argument("process pool: empty worker command");
+    init();
+  }
+
+  ProcessPool::ProcessPool(FitFunc &func,
+			   const int &nworkers,
+			   const int &dim,
+			   const int &depth)
+    :_func(func),_dim(dim),_depth(depth),_workers(nworkers)
+  {
+    init();
+  }
+
+  ProcessPool::~ProcessPool()
+  {
+    // workers exit when their doorbell socket closes.
+    for (Worker &wk: _workers)
+      if (wk._sock >= 0)
+	::close(wk._sock);
+    for (Worker &wk: _workers)
+      if (wk._pid > 0)
+	::waitpid(wk._pid,nullptr,0);
+    if (_slots)
+      ::munmap(_slots,_shm_size);
+    if (_shm >= 0)
+      ::close(_shm);
+  }
+
+  void ProcessPool::init()
+  {
+    if (_workers.empty() || _dim <= 0 || _depth <= 0)
+      throw std::invalid_argument("process pool: number of workers, dimension and depth must be positive");
+
+    // the shared memory is a file that is unlinked right away, and that workers inherit.
+    const char *tmpdir = ::access("/dev/shm",W_OK) == 0 ? "/dev/shm" : "/tmp";
+    std::string path = std::string(tmpdir) + "/libcmaes-XXXXXX";
+    std::vector<char> cpath(path.begin(),path.end());
+    cpath.push_back('\0');
+    _shm = ::mkstemp(cpath.data());
+    if (_shm < 0)
+      throw std::runtime_error(std::string("process pool: shared memory: ") + std::strerror(errno));
+    ::unlink(cpath.data());
+    _shm_size = _workers.size()*_depth*(_dim+1)*sizeof(double);
+    if (::ftruncate(_shm,_shm_size) != 0)
+      throw std::runtime_error(std::string("process pool: shared memory: ") + std::strerror(errno));
+    void *m = ::mmap(nullptr,_shm_size,PROT_READ|PROT_WRITE,MAP_SHARED,_shm,0);
+    if (m == MAP_FAILED)
+      throw std::runtime_error(std::string("process pool: shared memory: ") + std::strerror(errno));
+    _slots = static_cast<double*>(m);
+    ::fcntl(_shm,F_SETFD,FD_CLOEXEC);
+    for (size_t w=0;w<_workers.size();w++)
+      spawn(w);
+  }
+
+  void ProcessPool::spawn(const int &w)
+  {
+    // a fork only copies the calling thread, locks held by the others stay locked in the child.
+    if (_command.empty() && nthreads() > 1)
+      throw std::runtime_error("process pool: forked workers require a single-threaded process, use a worker command instead");
+
+    int fds[2];
+    if (::socketpair(AF_UNIX,SOCK_STREAM,0,fds) != 0)
+      throw std::runtime_error(std::string("process pool: socket: ") + std::strerror(errno));
+    ::fcntl(fds[0],F_SETFD,FD_CLOEXEC);
+
+    // everything the child needs is prepared before the fork.
+    std::vector<std::string> env;
+    std::vector<char*> envp, argv;
+    if (!_command.empty())
+      {
+	for (char **e=environ;*e;++e)
+	  if (std::strncmp(*e,worker_env,std::strlen(worker_env)) != 0)
+	    env.push_back(*e);
+	env.push_back(std::string(worker_env) + "=" + std::to_string(fds[1]) + ":" + std::to_string(_shm)
+		      + ":" + std::to_string(_dim) + ":" + std::to_string(_workers.size()*_depth));
+	for (std::string &e: env)
+	  envp.push_back(&e[0]);
+	envp.push_back(nullptr);
+	for (const std::string &a: _command)
+	  argv.push_back(const_cast<char*>(a.c_str()));
+	argv.push_back(nullptr);
+      }
+
+    pid_t pid = ::fork();
+    if (pid < 0)
+      {
+	::close(fds[0]);
+	::close(fds[1]);
+	throw std::runtime_error(std::string("process pool: fork: ") + std::strerror(errno));
+      }
+    if (pid == 0)
+      {
+	::close(fds[0]);
+	if (!_command.empty())
+	  {
+	    ::fcntl(_shm,F_SETFD,0);
+	    environ = envp.data();
+	    ::execvp(argv[0],argv.data());
+	    ::_exit(127);
+	  }
+	for (Worker &wk: _workers)
+	  if (wk._sock >= 0)
+	    ::close(wk._sock);
+	::_exit(run_worker(_func,fds[1],_slots,_dim));
+      }
+    ::close(fds[1]);
+    _workers.at(w)._pid = pid;
+    _workers.at(w)._sock = fds[0];
+    _workers.at(w)._next_slot = 0;
+  }
+
+  void ProcessPool::reap(const int &w)
+  {
+    Worker &wk = _workers.at(w);
+    if (wk._sock >= 0)
+      ::close(wk._sock);
+    wk._sock = -1;
+    int status = 0;
+    if (wk._pid > 0)
+      ::waitpid(wk._pid,&status,0);
+    wk._pid = -1;
+    ++_restarts;
+    LOG(WARNING) << "process pool: worker " << w << " died with status " << status << ", restarting\n";
+    spawn(w);
+  }
+
+  void ProcessPool::reset()
+  {
+    // results of an interrupted batch are still on their way, workers that hold some start afresh.
+    for (size_t w=0;w<_workers.size();w++)
+      {
+	Worker &wk = _workers.at(w);
+	if (wk._inflight.empty())
+	  continue;
+	wk._inflight.clear();
+	::kill(wk._pid,SIGKILL);
+	::close(wk._sock);
+	wk._sock = -1;
+	::waitpid(wk._pid,nullptr,0);
+	wk._pid = -1;
+	spawn(w);
+      }
+  }
+
+  double* ProcessPool::slot(const int &w, const int &s) const
+  {
+    return _slots + static_cast<size_t>(w*_depth+s)*(_dim+1);
+  }
+
+  bool ProcessPool::issue(const int &w, const int &c, const dMat &x)
+  {
+    Worker &wk = _workers.at(w);
+    int s = wk._next_slot;
+    std::copy(x.col(c).data(),x.col(c).data()+_dim,slot(w,s));
+    wk._inflight.push_back(c);
+    wk._next_slot = (s + 1) % _depth;
+    uint32_t ds = w*_depth + s;
+    return write_full(wk._sock,&ds,sizeof(ds));
+  }
+
+  void ProcessPool::eval(const dMat &x, dVec &fvalues)
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (x.rows() != _dim)
+      throw std::invalid_argument("process pool: candidates of dimension " + std::to_string(x.rows()) + ", expected " + std::to_string(_dim));
+    const int n = x.cols();
+    std::deque<int> todo;
+    for (int c=0;c<n;c++)
+      todo.push_back(c);
+    std::vector<int> retries(n,0);
+    int ndone = 0;
+    std::vector<pollfd> pfds(_workers.size());
+
+    // a dead worker is restarted, and its candidates are issued again first.
+    auto restart = [&](const int &w)
+      {
+	Worker &wk = _workers.at(w);
+	for (auto it=wk._inflight.rbegin();it!=wk._inflight.rend();++it)
+	  {
+	    if (++retries.at(*it) > _max_retries)
+	      throw std::runtime_error("process pool: candidate " + std::to_string(*it) + " killed its worker " + std::to_string(retries.at(*it)) + " times");
+	    todo.push_front(*it);
+	  }
+	wk._inflight.clear();
+	reap(w);
+      };
+
+    try
+      {
+	while (ndone < n)
+	  {
+	    for (size_t w=0;w<_workers.size();w++)
+	      {
+		while (!todo.empty() && (int)_workers[w]._inflight.size() < _depth)
+		  {
+		    int c = todo.front();
+		    todo.pop_front();
+		    if (!issue(w,c,x))
+		      restart(w);
+		  }
+		pfds[w].fd = _workers[w]._sock;
+		pfds[w].events = POLLIN;
+		pfds[w].revents = 0;
+	      }
+	    int r = ::poll(pfds.data(),pfds.size(),-1);
+	    if (r < 0)
+	      {
+		if (errno == EINTR)
+		  continue;
+		throw std::runtime_error(std::string("process pool: poll: ") + std::strerror(errno));
+	      }
+	    for (size_t w=0;w<_workers.size();w++)
+	      {
+		if (!pfds[w].revents)
+		  continue;
+		Worker &wk = _workers[w];
+		if (wk._inflight.empty())
+		  {
+		    // an idle worker has nothing to say, unless it died.
+		    if (pfds[w].revents & (POLLHUP|POLLERR|POLLNVAL))
+		      restart(w);
+		    continue;
+		  }
+		uint32_t ds;
+		if (!read_full(wk._sock,&ds,sizeof(ds)))
+		  {
+		    restart(w);
+		    continue;
+		  }
+		int c = wk._inflight.front();
+		wk._inflight.pop_front();
+		fvalues(c) = _slots[static_cast<size_t>(ds)*(_dim+1)+_dim];
+		++ndone;
+	      }
+	  }
+      }
+    catch (...)
+      {
+	reset();
+	throw;
+      }
+  }
+
+  BatchFitFunc ProcessPool::batch_func()
+  {
+    return [this](const dMat &x, dVec &fvalues) { eval(x,fvalues); };
+  }
+
+  bool ProcessPool::is_worker()
+  {
+    return std::getenv(worker_env) != nullptr;
+  }
+
+  int ProcessPool::worker_main(FitFunc &func)
+  {
+    const char *env = std::getenv(worker_env);
+    int sock, shm, dim, nslots;
+    if (!env || std::sscanf(env,"%d:%d:%d:%d",&sock,&shm,&dim,&nslots) != 4)
+      {
+	LOG(ERROR) << "process pool worker: not started by a process pool\n";
+	return 1;
+      }
+    size_t size = static_cast<size_t>(nslots)*(dim+1)*sizeof(double);
+    void *m = ::mmap(nullptr,size,PROT_READ|PROT_WRITE,MAP_SHARED,shm,0);
+    if (m == MAP_FAILED)
+      {
+	LOG(ERROR) << "process pool worker: shared memory: " << std::strerror(errno) << std::endl;
+	return 1;
+      }
+    ::close(shm);
+    int status = run_worker(func,sock,static_cast<double*>(m),dim);
+    ::munmap(m,size);
+    ::close(sock);
+    return status;
+  }
+#else
+  ProcessPool::ProcessPool(const std::vector<std::string> &command,
+			   const int &nworkers,
+			   const int &dim,
+			   const int &depth)
+    :_command(command),_dim(dim),_depth(depth),_workers(nworkers)
+  {
+    throw std::runtime_error("process pool: not available on this platform");
+  }
+
+  ProcessPool::ProcessPool(FitFunc &func,
+			   const int &nworkers,
+			   const int &dim,
+			   const int &depth)
+    :_func(func),_dim(dim),_depth(depth),_workers(nworkers)
+  {
+    throw std::runtime_error("process pool: not available on this platform");
+  }
+
+  ProcessPool::~ProcessPool() {}
+  void ProcessPool::init() {}
+  void ProcessPool::spawn(const int &) {}
+  void ProcessPool::reap(const int &) {}
+  void ProcessPool::reset() {}
+  bool ProcessPool::issue(const int &, const int &, const dMat &) { return false; }
+  double* ProcessPool::slot(const int &, const int &) const { return nullptr; }
+  void ProcessPool::eval(const dMat &, dVec &) {}
+  BatchFitFunc ProcessPool::batch_func() { return nullptr; }
+  bool ProcessPool::is_worker() { return false; }
+  int ProcessPool::worker_main(FitFunc &) { return 1; }
+#endif
+}
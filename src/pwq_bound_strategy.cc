@@ -81,47 +81,165 @@ namespace libcmaes
 
   void pwqBoundStrategy::to_f_representation(const dVec &x, dVec &y) const
   {
-    shift_into_feasible(x,y);
-    for (int i=0;i<x.rows();i++) //TODO: vectorize ?
-      {
-	if (y[i] < _lbounds[i] + _al[i])
-	  y[i] = _lbounds[i] + (y[i] - (_lbounds[i] - _al[i])) * (y[i] - (_lbounds[i] - _al[i])) / 4.0 / _al[i];
-	else if (y[i] > _ubounds[i] - _au[i])
-	  y[i] = _ubounds[i] - (y[i] - (_ubounds[i] + _au[i])) * (y[i] - (_ubounds[i] + _au[i])) / 4.0 / _au[i];
-      }
+    y = x;
+    shift_col(y,true);
   }
 
   void pwqBoundStrategy::shift_into_feasible(const dVec &x, dVec &x_s) const
   {
     x_s = x;
-    for (int i=0;i<x.rows();i++) //TODO: vectorize ?
-      {
-	if (x_s[i] < _xlow[i])
-	  x_s[i] += _r[i] * (1.0 + static_cast<int>((_xlow[i]-x_s[i])/_r[i])); // shift up.
-	if (x_s[i] > _xup[i])
-	  x_s[i] -= _r[i] * (1.0 + static_cast<int>((x_s[i]-_xup[i])/_r[i])); // shift down;
-	if (x_s[i] < _lbounds[i] - _al[i])
-	  x_s[i] += 2.0 * (_lbounds[i] - _al[i] - x_s[i]);
-	if (x_s[i] > _ubounds[i] + _au[i])
-	  x_s[i] -= 2.0 * (x_s[i] - _ubounds[i] - _au[i]);
-
-	if ((x_s[i] < _lbounds[i] - _al[i] - 1e-15) || (x_s[i] > _ubounds[i] + _au[i] + 1e-15))
-	  {
-	    LOG(FATAL) << "error in shifting pwq bounds in dimension " << i << ": lb=" << _lbounds[i] << " / ub=" << _ubounds[i] << " / al=" << _al[i] << " / au=" << _au[i] << " / x_s=" << x_s[i] << " / x=" << x[i] << " / xlow=" << _xlow[i] << " / xup=" << _xup[i] << " / r=" << _r[i] << std::endl;
-	  }
-      }
+    shift_col(x_s,false);
   }
 
   void pwqBoundStrategy::to_internal_representation(dVec &x, const dVec &y) const
   {
     x = y;
-    for (int i=0;i<y.rows();i++)
+    to_internal_col(x);
+  }
+
+  void pwqBoundStrategy::to_f_representation(Eigen::Ref<dVec> x) const
+  {
+    shift_col(x,true);
+  }
+
+  void pwqBoundStrategy::to_f_representation(dMat &x) const
+  {
+#pragma omp parallel for if (x.cols() >= 100)
+    for (int c=0;c<x.cols();c++)
+      shift_col(x.col(c),true);
+  }
+
+  void pwqBoundStrategy::to_internal_representation(dMat &x) const
+  {
+#pragma omp parallel for if (x.cols() >= 100)
+    for (int c=0;c<x.cols();c++)
+      to_internal_col(x.col(c));
+  }
+
+  void pwqBoundStrategy::shift_into_feasible(dMat &x) const
+  {
+#pragma omp parallel for if (x.cols() >= 100)
+    for (int c=0;c<x.cols();c++)
+      shift_col(x.col(c),false);
+  }
+
+  void pwqBoundStrategy::shift_col(Eigen::Ref<dVec> x, const bool &to_f) const
+  {
+    typedef Eigen::internal::packet_traits<double>::type Packet;
+    double *xd = x.data();
+    const int n = x.size();
+    
+    // shifts by periods, only far from the bounds, thus rare and scalar.
+    bool far = false;
+    far_blocks<double>(xd,n,far_blocks<Packet>(xd,n,0,far),far);
+    if (far)
+      for (int i=0;i<n;i++)
+	{
+	  if (xd[i] < _xlow[i])
+	    xd[i] += _r[i] * (1.0 + static_cast<int>((_xlow[i]-xd[i])/_r[i])); // shift up.
+	  if (xd[i] > _xup[i])
+	    xd[i] -= _r[i] * (1.0 + static_cast<int>((xd[i]-_xup[i])/_r[i])); // shift down;
+	}
+
+    bool err = false;
+    mirror_blocks<double>(xd,n,mirror_blocks<Packet>(xd,n,0,err),err);
+    if (err)
+      for (int i=0;i<n;i++)
+	if ((xd[i] < _lbounds[i] - _al[i] - 1e-15) || (xd[i] > _ubounds[i] + _au[i] + 1e-15))
+	  LOG(FATAL) << "error in shifting pwq bounds in dimension " << i << ": lb=" << _lbounds[i] << " / ub=" << _ubounds[i] << " / al=" << _al[i] << " / au=" << _au[i] << " / x_s=" << xd[i] << " / xlow=" << _xlow[i] << " / xup=" << _xup[i] << " / r=" << _r[i] << std::endl;
+
+    if (to_f)
+      to_f_blocks<double>(xd,n,to_f_blocks<Packet>(xd,n,0));
+  }
+
+  void pwqBoundStrategy::to_internal_col(Eigen::Ref<dVec> x) const
+  {
+    typedef Eigen::internal::packet_traits<double>::type Packet;
+    to_internal_blocks<double>(x.data(),x.size(),to_internal_blocks<Packet>(x.data(),x.size(),0));
+  }
+
+  // the kernels compute both sides of every test and select bitwise, with
+  // the same operations, in the same order, as the scalar code of
+  // boundary_transformation.c, so that results are unchanged to the last bit.
+  template <class P>
+  int pwqBoundStrategy::far_blocks(const double *x, const int &n, int i, bool &far) const
+  {
+    using namespace Eigen::internal;
+    const int ps = unpacket_traits<P>::size;
+    P pfar = pset1<P>(0.0);
+    for (;i+ps<=n;i+=ps)
+      {
+	const P xs = ploadu<P>(x+i);
+	pfar = por(pfar,por(pcmp_lt(xs,ploadu<P>(_xlow.data()+i)),pcmp_lt(ploadu<P>(_xup.data()+i),xs)));
+      }
+    far = far || predux_any(pfar);
+    return i;
+  }
+
+  template <class P>
+  int pwqBoundStrategy::mirror_blocks(double *x, const int &n, int i, bool &err) const
+  {
+    using namespace Eigen::internal;
+    const int ps = unpacket_traits<P>::size;
+    const P two = pset1<P>(2.0);
+    const P eps = pset1<P>(1e-15);
+    P perr = pset1<P>(0.0);
+    for (;i+ps<=n;i+=ps)
+      {
+	P xs = ploadu<P>(x+i);
+	const P lmal = psub(ploadu<P>(_lbounds.data()+i),ploadu<P>(_al.data()+i));
+	const P ub = ploadu<P>(_ubounds.data()+i);
+	const P au = ploadu<P>(_au.data()+i);
+	const P upau = padd(ub,au);
+	xs = pselect(pcmp_lt(xs,lmal),padd(xs,pmul(two,psub(lmal,xs))),xs);
+	xs = pselect(pcmp_lt(upau,xs),psub(xs,pmul(two,psub(psub(xs,ub),au))),xs);
+	perr = por(perr,por(pcmp_lt(xs,psub(lmal,eps)),pcmp_lt(padd(upau,eps),xs)));
+	pstoreu(x+i,xs);
+      }
+    err = err || predux_any(perr);
+    return i;
+  }
+
+  template <class P>
+  int pwqBoundStrategy::to_f_blocks(double *x, const int &n, int i) const
+  {
+    using namespace Eigen::internal;
+    const int ps = unpacket_traits<P>::size;
+    const P four = pset1<P>(4.0);
+    for (;i+ps<=n;i+=ps)
+      {
+	const P y = ploadu<P>(x+i);
+	const P lb = ploadu<P>(_lbounds.data()+i);
+	const P ub = ploadu<P>(_ubounds.data()+i);
+	const P al = ploadu<P>(_al.data()+i);
+	const P au = ploadu<P>(_au.data()+i);
+	const P dl = psub(y,psub(lb,al));
+	const P du = psub(y,padd(ub,au));
+	const P yl = padd(lb,pdiv(pdiv(pmul(dl,dl),four),al));
+	const P yu = psub(ub,pdiv(pdiv(pmul(du,du),four),au));
+	pstoreu(x+i,pselect(pcmp_lt(y,padd(lb,al)),yl,pselect(pcmp_lt(psub(ub,au),y),yu,y)));
+      }
+    return i;
+  }
+
+  template <class P>
+  int pwqBoundStrategy::to_internal_blocks(double *x, const int &n, int i) const
+  {
+    using namespace Eigen::internal;
+    const int ps = unpacket_traits<P>::size;
+    const P two = pset1<P>(2.0);
+    for (;i+ps<=n;i+=ps)
       {
-	if (x[i] < _lbounds[i] + _al[i])
-	  x[i] = (_lbounds[i] - _al[i]) + 2.0 * sqrt(_al[i] * fabs(_lbounds[i] - x[i]));
-	else if (x[i] > _ubounds[i] - _au[i])
-	  x[i] = (_ubounds[i] + _au[i]) - 2.0 * sqrt(_au[i] * fabs(x[i] - _ubounds[i]));
+	const P y = ploadu<P>(x+i);
+	const P lb = ploadu<P>(_lbounds.data()+i);
+	const P ub = ploadu<P>(_ubounds.data()+i);
+	const P al = ploadu<P>(_al.data()+i);
+	const P au = ploadu<P>(_au.data()+i);
+	const P xl = padd(psub(lb,al),pmul(two,psqrt(pmul(al,pabs(psub(lb,y))))));
+	const P xu = psub(padd(ub,au),pmul(two,psqrt(pmul(au,pabs(psub(y,ub))))));
+	pstoreu(x+i,pselect(pcmp_lt(y,padd(lb,al)),xl,pselect(pcmp_lt(psub(ub,au),y),xu,y)));
       }
+    return i;
   }
 
   void pwqBoundStrategy::remove_dimensions(const std::vector<int> &k)
@@ -185,7 +185,7 @@ namespace libcmaes
   int SimpleSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::optimize()
   {
     return TStrategy<TCovarianceUpdate,TGenoPheno>::optimize(std::bind(&SimpleSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::eval,this,std::placeholders::_1,std::placeholders::_2),
-							     std::bind(&CMAStrategy<TCovarianceUpdate,TGenoPheno>::ask,this),
+							     population_askfunc(std::bind(&CMAStrategy<TCovarianceUpdate,TGenoPheno>::ask,this)),
 							     std::bind(&SimpleSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::tell,this));
   }
   
@@ -222,7 +222,7 @@ namespace libcmaes
   }
 
   template<template <class U,class V> class TStrategy, class TCovarianceUpdate, class TGenoPheno>
-  dMat ACMSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::ask()
+  const dMat& ACMSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::ask()
   {
     // when starting or restarting, make sure the training set is reset.
     if (this->_niter == 0)
@@ -236,7 +236,7 @@ namespace libcmaes
       {
 	double lambda = eostrat<TGenoPheno>::_parameters._lambda; // XXX: hacky.
 	eostrat<TGenoPheno>::_parameters._lambda = _prelambda;
-	dMat pop = TStrategy<TCovarianceUpdate,TGenoPheno>::ask();
+	const dMat &pop = TStrategy<TCovarianceUpdate,TGenoPheno>::ask();
 	eostrat<TGenoPheno>::_parameters._lambda = lambda;
 	return pop;
       }
@@ -310,23 +310,25 @@ namespace libcmaes
   int ACMSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::optimize()
   {
     return TStrategy<TCovarianceUpdate,TGenoPheno>::optimize(std::bind(&ACMSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::eval,this,std::placeholders::_1,std::placeholders::_2),
-							     std::bind(&ACMSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::ask,this),
+							     population_askfunc(std::bind(&ACMSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::ask,this)),
 							     std::bind(&ACMSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::tell,this));
   }
   
   template<template <class U,class V> class TStrategy, class TCovarianceUpdate, class TGenoPheno>
   void ACMSurrogateStrategy<TStrategy,TCovarianceUpdate,TGenoPheno>::pre_selection_eval(const dMat &candidates)
   {
-    // - rank all candidates according to surrogate.
-    eostrat<TGenoPheno>::_solutions._candidates.clear();
+    // - predict all candidates according to surrogate, candidates are views onto the population matrix.
+    eostrat<TGenoPheno>::_solutions._candidates.resize(candidates.cols());
+    eostrat<TGenoPheno>::_solutions.bind_population();
     for (int r=0;r<candidates.cols();r++)
       {
-	eostrat<TGenoPheno>::_solutions._candidates.push_back(Candidate(0.0,candidates.col(r)));
+	eostrat<TGenoPheno>::_solutions._candidates.at(r).set_x(candidates.col(r));
+	eostrat<TGenoPheno>::_solutions._candidates.at(r).set_fvalue(0.0);
+	eostrat<TGenoPheno>::_solutions._candidates.at(r).set_id(r);
       }
     if (!eostrat<TGenoPheno>::_parameters.is_sep() && !eostrat<TGenoPheno>::_parameters.is_vd())
       this->predict(eostrat<TGenoPheno>::_solutions._candidates,eostrat<TGenoPheno>::_solutions._csqinv);
     else this->predict(eostrat<TGenoPheno>::_solutions._candidates,eostrat<TGenoPheno>::_solutions._sepcsqinv);
-    eostrat<TGenoPheno>::_solutions.sort_candidates();
 
     /*std::vector<Candidate> &vc = eostrat<TGenoPheno>::_solutions.candidates();
     for (size_t i=0;i<vc.size();i++)
@@ -335,39 +337,42 @@ namespace libcmaes
 	}*/
 
     // - draw 'a'<lambda_pre samples according to lambda_pre*N(0,theta_sel0^2) and retain each sample from initial population, with rank r < floor(a)
-    std::vector<Candidate> ncandidates;
+    std::vector<int> ranks;
     std::unordered_set<int> uh;
     
     // keep the estimated best candidate.
-    ncandidates.push_back(eostrat<TGenoPheno>::_solutions._candidates.at(0));
-    ncandidates.at(0).set_rank(0);
+    ranks.push_back(0);
     uh.insert(0);
     
     std::unordered_set<int>::const_iterator uhit;
-    while((int)ncandidates.size() < eostrat<TGenoPheno>::_parameters._lambda)
+    while((int)ranks.size() < eostrat<TGenoPheno>::_parameters._lambda)
       {
 	double da = _prelambda*std::fabs(_norm_sel0(_gen0));
 	int a = std::floor(da);
 	if (a < (int)eostrat<TGenoPheno>::_solutions._candidates.size() && (uhit=uh.find(a))==uh.end())
 	  {
 	    uh.insert(a);
-	    eostrat<TGenoPheno>::_solutions._candidates.at(a).set_rank(a);
-	    ncandidates.push_back(eostrat<TGenoPheno>::_solutions._candidates.at(a));
+	    ranks.push_back(a);
 	  }
       }
+
+    // - rank only the drawn candidates, by partial selection.
+    eostrat<TGenoPheno>::_solutions.select_candidates(0,0,ranks);
+    std::vector<Candidate> ncandidates;
+    for (int a: ranks)
+      {
+	eostrat<TGenoPheno>::_solutions._candidates.at(a).set_rank(a);
+	ncandidates.push_back(eostrat<TGenoPheno>::_solutions._candidates.at(a));
+      }
     
     // - draw 'a'<lambda samples according to lambda*N(0,theta_sel1^2) and retain each sample from the population from previous step, with rank r < floor(a)
     std::vector<Candidate> test_set;
     std::sort(ncandidates.begin(),ncandidates.end(),
 	      [](Candidate const &c1, Candidate const &c2){return c1.get_fvalue() < c2.get_fvalue();});
-    ncandidates.at(0).set_fvalue(this->_func(eostrat<TGenoPheno>::_parameters._gp.pheno(ncandidates.at(0).get_x_dvec()).data(),ncandidates.at(0).get_x_size()));
-    this->update_fevals(1);
-    test_set.push_back(ncandidates.at(0));
-    this->add_to_training_set(ncandidates.at(0));
-    int count = 1;
+    std::vector<int> evals = {0};
     uh.clear();
     uh.insert(0);
-    while(count < _lambdaprime)
+    while((int)evals.size() < _lambdaprime)
       {
 	// XXX: do we need to drop the samples with a > lambda and if a == 0 ? weird bias on sampling...
 	double da = std::fabs(_norm_sel1(_gen1));
@@ -375,14 +380,25 @@ namespace libcmaes
 	if (a < (int)ncandidates.size() && (uhit=uh.find(a))==uh.end())
 	  {
 	    uh.insert(a);
-	    double fvalue = this->_func(eostrat<TGenoPheno>::_parameters._gp.pheno(ncandidates.at(a).get_x_dvec()).data(),ncandidates.at(a).get_x_size());
-	    ncandidates.at(a).set_fvalue(fvalue);
-	    test_set.push_back(ncandidates.at(a));
-	    this->add_to_training_set(ncandidates.at(a));
-	    this->update_fevals(1);
-	    ++count;
+	    evals.push_back(a);
 	  }
       }
+
+    // - evaluate the retained samples with the original objective function, at once.
+    dMat x(eostrat<TGenoPheno>::_parameters._dim,evals.size());
+    for (size_t j=0;j<evals.size();j++)
+      x.col(j) = ncandidates.at(evals.at(j)).get_x_dvec();
+    dMat phenox;
+    dVec fvalues;
+    this->fitfunc_batch(eostrat<TGenoPheno>::_parameters._gp.pheno(x,phenox),fvalues);
+    for (size_t j=0;j<evals.size();j++)
+      {
+	Candidate &c = ncandidates.at(evals.at(j));
+	c.set_fvalue(fvalues(j));
+	test_set.push_back(c);
+	this->add_to_training_set(c);
+      }
+    this->update_fevals(evals.size());
     for (size_t i=1;i<ncandidates.size();i++)
       if ((uhit=uh.find(i))==uh.end())
 	ncandidates.at(i).set_fvalue(std::numeric_limits<double>::max());
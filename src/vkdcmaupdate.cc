@@ -0,0 +1,140 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/vkdcmaupdate.h>
+#include <iostream>
+#include <limits>
+
+namespace libcmaes
+{
+
+  template <class TGenoPheno>
+  void VkDCMAUpdate::update(const CMAParameters<TGenoPheno> &parameters,
+			    Eigen::EigenMultivariateNormal<double> &esolver,
+			    CMASolutions &solutions)
+  {
+    (void)esolver; // esolver is not needed, sampling uses the restricted model.
+
+    // update of the mean.
+    dVec xmean = dVec::Zero(parameters._dim);
+    for (int i=0;i<parameters._mu;i++)
+      xmean += parameters._weights[i] * solutions._candidates.at(i).get_x_map();
+
+    // reusable variables.
+    dVec diffxmean = 1.0/solutions._sigma * (xmean-solutions._xmean); // (m^{t+1}-m^t)/sigma^t
+
+    // update psigma, with C^-1/2 = (I+VSV^T)^-1/2 D^-1.
+    dMat csqinvdiff = diffxmean.cwiseQuotient(solutions._vkdd);
+    sqrt_transform(solutions,csqinvdiff,true);
+    solutions._psigma = (1.0-parameters._csigma)*solutions._psigma + parameters._fact_ps * csqinvdiff;
+    double norm_ps = solutions._psigma.norm();
+
+    // update pc.
+    solutions._hsig = 0;
+    double val_for_hsig = sqrt(1.0-pow(1.0-parameters._csigma,2.0*(solutions._niter+1)))*(1.4+2.0/(parameters._dim+1-parameters._fixed_p.size()))*parameters._chi;
+    if (norm_ps < val_for_hsig)
+      solutions._hsig = 1;
+    solutions._pc = (1.0-parameters._cc) * solutions._pc + solutions._hsig * parameters._fact_pc * diffxmean;
+
+    // updated covariance in D-normalized coordinates, alphacov*I + UU^T with
+    // U = [sqrt(alphacov) V S^1/2, sqrt(c1) pc, sqrt(cmu w_i) y_i].
+    int k = solutions._vkdv.cols();
+    double alphacov = 1-parameters._c1-parameters._cmu+(1-solutions._hsig)*parameters._c1*parameters._cc*(2.0-parameters._cc);
+    dMat U(parameters._dim,k+1+parameters._mu);
+    U.leftCols(k) = solutions._vkdv * (alphacov*solutions._vkds).cwiseSqrt().asDiagonal();
+    U.col(k) = std::sqrt(parameters._c1) * solutions._pc.cwiseQuotient(solutions._vkdd);
+    for (int i=0;i<parameters._mu;i++)
+      U.col(k+1+i) = (std::sqrt(parameters._cmu*parameters._weights[i])/solutions._sigma) * (solutions._candidates.at(i).get_x_map() - solutions._xmean).cwiseQuotient(solutions._vkdd);
+
+    // projection: the k leading eigendirections of UU^T, obtained from the small Gram matrix U^TU,
+    // are kept as such, whereas the remaining ones only contribute their diagonal.
+    Eigen::SelfAdjointEigenSolver<dMat> gsolver(U.transpose()*U);
+    dMat F = U * gsolver.eigenvectors().rightCols(k); // columns are sqrt(lambda_j) e_j
+    dVec Fdiag = F.cwiseAbs2().rowwise().sum();
+    dVec delta = dVec::Constant(parameters._dim,alphacov) + U.cwiseAbs2().rowwise().sum() - Fdiag;
+
+    // D and V are not identifiable along axis-aligned directions, where D would otherwise shrink
+    // geometrically while S grows. D is thus only changed in proportion to its share of each
+    // coordinate variance.
+    delta = dVec::Constant(parameters._dim,1.0) + (delta.array()-1.0).matrix().cwiseProduct(delta.cwiseQuotient(delta+Fdiag));
+    dVec sqdelta = delta.cwiseSqrt();
+
+    // D <- D delta^1/2, and the rescaled directions are orthonormalized again into V and S.
+    F = sqdelta.cwiseInverse().asDiagonal() * F;
+    Eigen::SelfAdjointEigenSolver<dMat> fsolver(F.transpose()*F);
+    solutions._vkdv.noalias() = F * fsolver.eigenvectors();
+    solutions._vkds = fsolver.eigenvalues();
+    for (int j=0;j<k;j++)
+      {
+	if (solutions._vkds[j] > std::numeric_limits<double>::epsilon())
+	  solutions._vkdv.col(j) /= std::sqrt(solutions._vkds[j]);
+	else
+	  {
+	    solutions._vkdv.col(j).setZero();
+	    solutions._vkds[j] = 0.0;
+	  }
+      }
+    solutions._vkdd = solutions._vkdd.cwiseProduct(sqdelta);
+    solutions._sepcov = cov_diagonal(solutions);
+
+    // update sigma.
+    if (parameters._tpa < 2)
+      solutions._sigma *= std::exp((parameters._csigma / parameters._dsigma) * (norm_ps / parameters._chi - 1.0));
+    else if (solutions._niter > 0)
+      solutions._sigma *= std::exp(solutions._tpa_s / parameters._dsigma);
+
+    // set mean.
+    if (parameters._tpa)
+      solutions._xmean_prev = solutions._xmean;
+    solutions._xmean = xmean;
+  }
+
+  void VkDCMAUpdate::sqrt_transform(const CMASolutions &solutions,
+				    dMat &z,
+				    const bool &inverse)
+  {
+    // V orthonormal: (I+VSV^T)^p = I + V((1+S)^p-1)V^T.
+    dVec fact = (dVec::Constant(solutions._vkds.size(),1.0)+solutions._vkds).cwiseSqrt();
+    if (inverse)
+      fact = fact.cwiseInverse();
+    fact.array() -= 1.0;
+    dMat vz = solutions._vkdv.transpose() * z;
+    z.noalias() += solutions._vkdv * (fact.asDiagonal() * vz);
+  }
+
+  dVec VkDCMAUpdate::cov_diagonal(const CMASolutions &solutions)
+  {
+    return solutions._vkdd.cwiseAbs2().cwiseProduct(dVec::Constant(solutions._vkdd.size(),1.0) + solutions._vkdv.cwiseAbs2() * solutions._vkds);
+  }
+
+  dMat VkDCMAUpdate::full_cov(const CMASolutions &solutions)
+  {
+    dMat DV = solutions._vkdd.asDiagonal() * solutions._vkdv;
+    dMat cov = DV * solutions._vkds.asDiagonal() * DV.transpose();
+    cov.diagonal() += solutions._vkdd.cwiseAbs2();
+    return cov;
+  }
+
+  template CMAES_EXPORT void VkDCMAUpdate::update(const CMAParameters<GenoPheno<NoBoundStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void VkDCMAUpdate::update(const CMAParameters<GenoPheno<pwqBoundStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void VkDCMAUpdate::update(const CMAParameters<GenoPheno<NoBoundStrategy,linScalingStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+  template CMAES_EXPORT void VkDCMAUpdate::update(const CMAParameters<GenoPheno<pwqBoundStrategy,linScalingStrategy> >&,Eigen::EigenMultivariateNormal<double>&,CMASolutions&);
+}
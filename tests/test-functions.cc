@@ -481,8 +481,9 @@ DEFINE_bool(full_fplot,false,"whether to activate full legacy plot");
 DEFINE_double(sigma0,-1.0,"initial value for step-size sigma (-1.0 for automated value)");
 DEFINE_double(x0,-std::numeric_limits<double>::max(),"initial value for all components of the mean vector (-DBL_MAX for automated value)");
 DEFINE_uint64(seed,0,"seed for random generator");
-DEFINE_string(alg,"cmaes","algorithm, among cmaes, ipop, bipop, acmaes, aipop, abipop, sepcmaes, sepipop, sepbipop, sepacmaes, sepaipop, sepabipop");
+DEFINE_string(alg,"cmaes","algorithm, among cmaes, ipop, bipop, acmaes, aipop, abipop, sepcmaes, sepipop, sepbipop, sepacmaes, sepaipop, sepabipop, vdcma, vdipopcma, vdbipopcma, cholcmaes, cholipop, cholbipop, lmcma, lmipopcma, lmbipopcma, vkdcma, vkdipopcma, vkdbipopcma");
 DEFINE_bool(lazy_update,false,"covariance lazy update");
+DEFINE_bool(async_eigen,false,"eigendecomposition in background of the evaluation");
 //DEFINE_string(boundtype,"none","treatment applied to bounds, none or pwq (piecewise linear / quadratic) transformation");
 DEFINE_double(lbound,std::numeric_limits<double>::max()/-1e2,"lower bound to parameter vector");
 DEFINE_double(ubound,std::numeric_limits<double>::max()/1e2,"upper bound to parameter vector");
@@ -541,6 +542,7 @@ CMASolutions cmaes_opt()
   cmaparams.set_fplot(FLAGS_fplot);
   cmaparams.set_full_fplot(FLAGS_full_fplot);
   cmaparams.set_lazy_update(FLAGS_lazy_update);
+  cmaparams.set_async_eigen(FLAGS_async_eigen);
   cmaparams.set_quiet(FLAGS_quiet);
   cmaparams.set_tpa(FLAGS_tpa);
   cmaparams.set_gradient(FLAGS_with_gradient || FLAGS_with_num_gradient);
@@ -587,6 +589,24 @@ CMASolutions cmaes_opt()
     cmaparams.set_algo(VD_IPOP_CMAES);
   else if (FLAGS_alg == "vdbipopcma")
     cmaparams.set_algo(VD_BIPOP_CMAES);
+  else if (FLAGS_alg == "cholcmaes")
+    cmaparams.set_algo(CHOL_CMAES);
+  else if (FLAGS_alg == "cholipop")
+    cmaparams.set_algo(CHOL_IPOP_CMAES);
+  else if (FLAGS_alg == "cholbipop")
+    cmaparams.set_algo(CHOL_BIPOP_CMAES);
+  else if (FLAGS_alg == "lmcma")
+    cmaparams.set_algo(LM_CMAES);
+  else if (FLAGS_alg == "lmipopcma")
+    cmaparams.set_algo(LM_IPOP_CMAES);
+  else if (FLAGS_alg == "lmbipopcma")
+    cmaparams.set_algo(LM_BIPOP_CMAES);
+  else if (FLAGS_alg == "vkdcma")
+    cmaparams.set_algo(VKD_CMAES);
+  else if (FLAGS_alg == "vkdipopcma")
+    cmaparams.set_algo(VKD_IPOP_CMAES);
+  else if (FLAGS_alg == "vkdbipopcma")
+    cmaparams.set_algo(VKD_BIPOP_CMAES);
   else
     {
       LOG(ERROR) << "unknown algorithm flavor " << FLAGS_alg << std::endl;
@@ -696,6 +716,7 @@ int main(int argc, char *argv[])
 	    cmaparams = (*pmit).second;
 	  cmaparams.set_quiet(true);
 	  cmaparams.set_lazy_update(FLAGS_lazy_update);
+	  cmaparams.set_async_eigen(FLAGS_async_eigen);
 	  if (FLAGS_alg == "cmaes")
 	    cmaparams.set_algo(CMAES_DEFAULT);
 	  else if (FLAGS_alg == "ipop")
@@ -0,0 +1,126 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc fsphere = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+FitFunc elli = [](const double *x, const int N)
+{
+  if (N == 1)
+    return x[0] * x[0];
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += exp(log(1e3)*2.0*static_cast<double>(i)/static_cast<double>((N-1))) * x[i]*x[i];
+  return val;
+};
+
+FitFunc rosenbrock = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*pow((x[i+1]-x[i]*x[i]),2) + pow((x[i]-1.0),2);
+  return val;
+};
+
+FitFunc rastrigin = [](const double *x, const int N)
+{
+  static double A = 10.0;
+  double val = A*N;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i] - A*cos(2*M_PI*x[i]);
+  return val;
+};
+
+double exact_max_eigenvalue(const dMat &zs)
+{
+  Eigen::SelfAdjointEigenSolver<dMat> esolve(zs*zs.transpose());
+  return esolve.eigenvalues().maxCoeff();
+}
+
+TEST(acovarianceupdate,max_eigenvalue_random)
+{
+  for (int n : {2,10,50})
+    for (int mu : {1,5,30,100})
+      {
+	dMat zs = dMat::Random(n,mu);
+	double exact = exact_max_eigenvalue(zs);
+	ASSERT_NEAR(exact,ACovarianceUpdate::max_eigenvalue(zs),1e-10*exact);
+      }
+}
+
+// the negative update step-size of active CMA follows the exact value along runs.
+void check_cminus_along_run(FitFunc &func, const int &dim, const int &lambda)
+{
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,lambda,1234);
+  cmaparams.set_algo(aCMAES);
+  cmaparams.set_quiet(true);
+  cmaparams.set_max_iter(300);
+  int mu = lambda / 2;
+  dVec weights(mu);
+  for (int i=0;i<mu;i++)
+    weights[i] = log(mu+1)-log(i+1);
+  weights /= weights.sum();
+  double lambdamintarget = 0.66, cmu = 0.5; // only used for comparing values of cminus.
+  ESOptimizer<CMAStrategy<ACovarianceUpdate>,CMAParameters<>> optim(func,cmaparams);
+  while(!optim.stop())
+    {
+      dMat candidates = optim.ask();
+      optim.eval(candidates);
+      CMASolutions cmasols = optim.get_solutions();
+      cmasols.sort_candidates();
+      dMat csqinv = cmasols.csqinv();
+      if (csqinv.size())
+	{
+	  dMat zs(dim,mu);
+	  for (int i=0;i<mu;i++)
+	    zs.col(i) = std::sqrt(weights[i])/cmasols.sigma() * csqinv * (cmasols.get_candidate(lambda-i-1).get_x_dvec() - cmasols.xmean());
+	  double exact = exact_max_eigenvalue(zs);
+	  double estimate = ACovarianceUpdate::max_eigenvalue(zs);
+	  ASSERT_NEAR(exact,estimate,1e-9*exact);
+	  double cminus_exact = (1.0-cmu)*(1.0-lambdamintarget)/exact;
+	  double cminus_estimate = (1.0-cmu)*(1.0-lambdamintarget)/estimate;
+	  ASSERT_NEAR(cminus_exact,cminus_estimate,1e-9*cminus_exact);
+	}
+      optim.tell();
+      optim.inc_iter();
+    }
+}
+
+TEST(acovarianceupdate,cminus_test_functions)
+{
+  check_cminus_along_run(fsphere,10,10);
+  check_cminus_along_run(elli,10,10);
+  check_cminus_along_run(rosenbrock,20,12);
+  check_cminus_along_run(rastrigin,10,10);
+  check_cminus_along_run(elli,5,100); // mu > dim
+}
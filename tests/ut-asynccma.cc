@@ -0,0 +1,108 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <iostream>
+
+using namespace libcmaes;
+
+std::atomic<int> ncalls(0);
+
+// sphere with a long tail of evaluation times.
+FitFunc slow_sphere = [](const double *x, const int N)
+{
+  int c = ++ncalls;
+  std::this_thread::sleep_for(std::chrono::microseconds(c % 7 == 0 ? 2000 : 100));
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+TEST(asynccma,optimize)
+{
+  int dim = 8;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_feval_threads(4);
+  cmaparams.set_ftarget(1e-8);
+  ncalls = 0;
+  ESOptimizer<AsyncCMAStrategy<CovarianceUpdate,GenoPheno<>>,CMAParameters<>> optim(slow_sphere,cmaparams);
+  ASSERT_TRUE(optim.asynchronous());
+  optim.optimize();
+  CMASolutions cmasols = optim.get_solutions();
+  ASSERT_LE(0,cmasols.run_status());
+  ASSERT_LE(cmasols.best_candidate().get_fvalue(),1e-8);
+  ASSERT_EQ(ncalls.load(),cmasols.fevals()); // every evaluation counts, rejected ones included.
+  ASSERT_EQ(4,optim.nworkers());
+  ASSERT_LT(0.0,optim.utilization());
+  ASSERT_GE(optim.busy_utilization(),optim.utilization()); // rejected results do not count as utilization.
+  ASSERT_GE(1.0,optim.busy_utilization());
+
+  // a distribution overshoots lambda by lambda/5 at most, and only those results can be rejected.
+  ASSERT_LE(optim.rejected(),(cmaparams.lambda()/5)*(cmasols.niter()+1));
+}
+
+TEST(asynccma,max_age)
+{
+  int dim = 8;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_feval_threads(4);
+  cmaparams.set_max_iter(50);
+  ESOptimizer<AsyncCMAStrategy<CovarianceUpdate,GenoPheno<>>,CMAParameters<>> optim(slow_sphere,cmaparams);
+
+  // with more outstanding candidates than lambda and no tolerance on age, results get rejected.
+  ASSERT_EQ(0,optim.get_max_age());
+  optim.set_outstanding(4*cmaparams.lambda());
+  optim.set_overdraw(4*cmaparams.lambda());
+  optim.optimize();
+  ASSERT_LT(0,optim.rejected());
+  ASSERT_EQ(50,optim.get_solutions().niter());
+}
+
+TEST(asynccma,synchronous_fallback_and_errors)
+{
+  int dim = 6;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_elitism(1);
+  ESOptimizer<AsyncCMAStrategy<CovarianceUpdate,GenoPheno<>>,CMAParameters<>> optim(slow_sphere,cmaparams);
+  ASSERT_FALSE(optim.asynchronous());
+  optim.optimize();
+  ASSERT_LE(0,optim.get_solutions().run_status());
+  ASSERT_EQ(0,optim.nworkers());
+
+  CMAParameters<> ecmaparams(x0,0.5,-1,1234);
+  ecmaparams.set_quiet(true);
+  ecmaparams.set_feval_threads(3);
+  FitFunc ffail = [](const double*, const int) -> double { throw std::runtime_error("fail"); };
+  ESOptimizer<AsyncCMAStrategy<CovarianceUpdate,GenoPheno<>>,CMAParameters<>> eoptim(ffail,ecmaparams);
+  ASSERT_THROW(eoptim.optimize(),std::runtime_error);
+}
@@ -0,0 +1,152 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc fsphere = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+FitFunc elli = [](const double *x, const int N)
+{
+  if (N == 1)
+    return x[0] * x[0];
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += exp(log(1e3)*2.0*static_cast<double>(i)/static_cast<double>((N-1))) * x[i]*x[i];
+  return val;
+};
+
+// exposes the state of the background decomposition.
+class AsyncEigenOptimizer : public ESOptimizer<CMAStrategy<CovarianceUpdate>,CMAParameters<>>
+{
+public:
+  AsyncEigenOptimizer(FitFunc &func, CMAParameters<> &parameters)
+    :ESOptimizer<CMAStrategy<CovarianceUpdate>,CMAParameters<>>(func,parameters)
+  {
+  }
+
+  bool pending() const
+  {
+    return _async_esolver.valid();
+  }
+
+  bool running() const
+  {
+    return _async_esolver.valid()
+      && _async_esolver.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+  }
+};
+
+TEST(asynceigen,optimize_sphere)
+{
+  int dim = 20;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_async_eigen(true);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-8);
+  CMASolutions cmasols = cmaes<>(fsphere,cmaparams);
+  ASSERT_EQ(FTARGET,cmasols.run_status());
+}
+
+TEST(asynceigen,optimize_elli)
+{
+  int dim = 20;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_async_eigen(true);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-8);
+  CMASolutions cmasols = cmaes<>(elli,cmaparams);
+  ASSERT_EQ(FTARGET,cmasols.run_status());
+}
+
+TEST(asynceigen,staleness)
+{
+  int dim = 100;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_async_eigen(true);
+  cmaparams.set_quiet(true);
+  double bound = std::max(1.0,cmaparams.get_lazy_value());
+  AsyncEigenOptimizer optim(elli,cmaparams);
+  int neigen = 0, eigeniter = 0;
+  for (int i=0;i<200;i++)
+    {
+      dMat candidates = optim.ask();
+      ASSERT_LE(i-optim.get_solutions().eigeniter(),bound);
+      if (optim.get_solutions().eigeniter() != eigeniter)
+	{
+	  ASSERT_LT(eigeniter,optim.get_solutions().eigeniter());
+	  eigeniter = optim.get_solutions().eigeniter();
+	  ++neigen;
+	}
+      optim.eval(candidates);
+      optim.tell();
+      optim.inc_iter();
+    }
+  ASSERT_LT(0,neigen);
+}
+
+TEST(asynceigen,join_at_run_end)
+{
+  int dim = 100;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_async_eigen(true);
+  cmaparams.set_quiet(true);
+  cmaparams.set_max_iter(50);
+  AsyncEigenOptimizer optim(elli,cmaparams);
+  optim.optimize();
+  ASSERT_EQ(50,optim.get_solutions().niter());
+  ASSERT_FALSE(optim.running());
+}
+
+TEST(asynceigen,join_on_destruction)
+{
+  int dim = 300;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_async_eigen(true);
+  cmaparams.set_quiet(true);
+  {
+    AsyncEigenOptimizer optim(elli,cmaparams);
+    for (int i=0;i<3;i++)
+      {
+	dMat candidates = optim.ask();
+	optim.eval(candidates);
+	optim.tell();
+	optim.inc_iter();
+      }
+    optim.ask();
+    ASSERT_TRUE(optim.pending());
+  } // destroyed with a decomposition in flight.
+  SUCCEED();
+}
@@ -0,0 +1,108 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <libcmaes/errstats.h>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc rosenbrock = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*(x[i+1]-x[i]*x[i])*(x[i+1]-x[i]*x[i]) + (1.0-x[i])*(1.0-x[i]);
+  return val;
+};
+
+// batch rosenbrock, that counts its calls and the points it evaluates.
+int ncalls = 0;
+int npoints = 0;
+BatchFitFunc brosenbrock = [](const dMat &x, dVec &fvalues)
+{
+  ++ncalls;
+  npoints += x.cols();
+  for (int c=0;c<x.cols();c++)
+    fvalues(c) = rosenbrock(x.col(c).data(),x.rows());
+};
+
+TEST(batchfitfunc,same_as_fitfunc)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  ncalls = npoints = 0;
+  CMASolutions bcmasols = cmaes<>(brosenbrock,cmaparams);
+  ASSERT_EQ(cmasols.fevals(),bcmasols.fevals());
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),bcmasols.best_candidate().get_fvalue());
+
+  // one batch call per generation.
+  ASSERT_EQ(bcmasols.niter(),ncalls);
+  ASSERT_EQ(bcmasols.fevals(),npoints);
+}
+
+TEST(batchfitfunc,gradient_and_maximize)
+{
+  int dim = 8;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_gradient(true);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  ncalls = npoints = 0;
+  CMASolutions bcmasols = cmaes<>(brosenbrock,cmaparams);
+  ASSERT_EQ(cmasols.fevals(),bcmasols.fevals());
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),bcmasols.best_candidate().get_fvalue());
+  ASSERT_EQ(2*bcmasols.niter(),ncalls); // population and numerical gradient.
+
+  FitFunc mfunc = [](const double *x, const int N) { return -rosenbrock(x,N); };
+  BatchFitFunc bmfunc = [](const dMat &x, dVec &fvalues)
+    {
+      for (int c=0;c<x.cols();c++)
+	fvalues(c) = -rosenbrock(x.col(c).data(),x.rows());
+    };
+  CMAParameters<> mcmaparams(x0,0.5,-1,1234);
+  mcmaparams.set_quiet(true);
+  mcmaparams.set_maximize(true);
+  CMASolutions mcmasols = cmaes<>(mfunc,mcmaparams);
+  CMASolutions bmcmasols = cmaes<>(bmfunc,mcmaparams);
+  ASSERT_EQ(mcmasols.best_candidate().get_fvalue(),bmcmasols.best_candidate().get_fvalue());
+}
+
+TEST(batchfitfunc,errstats)
+{
+  int dim = 6;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(dim,&x0.front(),0.1);
+  cmaparams.set_quiet(true);
+  cmaparams.set_seed(1234);
+  FitFunc bfunc = batch_fitfunc(brosenbrock);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  pli le = errstats<>::profile_likelihood(rosenbrock,cmaparams,cmasols,2,false,5,0.1);
+  ncalls = npoints = 0;
+  pli ble = errstats<>::profile_likelihood(bfunc,cmaparams,cmasols,2,false,5,0.1);
+  ASSERT_EQ(le.get_min(),ble.get_min());
+  ASSERT_EQ(le.get_max(),ble.get_max());
+  ASSERT_LT(ncalls,npoints); // sub-searches evaluate by batches.
+}
@@ -0,0 +1,134 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc fsphere = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+FitFunc elli = [](const double *x, const int N)
+{
+  if (N == 1)
+    return x[0] * x[0];
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += exp(log(1e3)*2.0*static_cast<double>(i)/static_cast<double>((N-1))) * x[i]*x[i];
+  return val;
+};
+
+// runs a few generations so that the factor is far from the identity.
+CMASolutions chol_solutions(const int &dim, const int &niter)
+{
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_str_algo("cholcmaes");
+  cmaparams.set_quiet(true);
+  ESOptimizer<CMAStrategy<CholeskyCovarianceUpdate>,CMAParameters<>> optim(elli,cmaparams);
+  for (int i=0;i<niter;i++)
+    {
+      dMat candidates = optim.ask();
+      optim.eval(candidates);
+      optim.tell();
+      optim.inc_iter();
+    }
+  return optim.get_solutions();
+}
+
+TEST(choleskyupdate,factors)
+{
+  int dim = 20;
+  CMASolutions cmasols = chol_solutions(dim,100);
+  dMat A = cmasols.csqrt();
+  dMat Ainv = cmasols.csqinv();
+  ASSERT_FALSE(A.isDiagonal(1e-3));
+  ASSERT_TRUE((A*A.transpose()).isApprox(cmasols.cov(),1e-8));
+  ASSERT_TRUE((A*Ainv).isApprox(dMat::Identity(dim,dim),1e-8));
+}
+
+TEST(choleskyupdate,rank_one_update)
+{
+  int dim = 10;
+  dMat A = dMat::Random(dim,dim) + dim * dMat::Identity(dim,dim);
+  dMat Ainv = A.inverse();
+  dVec v = dVec::Random(dim);
+  dMat C = A*A.transpose() + 0.3 * v * v.transpose();
+  CholeskyCovarianceUpdate::rank_one_update(0.3,v,A,Ainv);
+  ASSERT_TRUE((A*A.transpose()).isApprox(C,1e-12));
+  ASSERT_TRUE((A*Ainv).isApprox(dMat::Identity(dim,dim),1e-12));
+}
+
+TEST(choleskyupdate,spectrum)
+{
+  int dim = 20;
+  CMASolutions cmasols = chol_solutions(dim,100);
+  Eigen::SelfAdjointEigenSolver<dMat> es(cmasols.cov());
+  ASSERT_NEAR(es.eigenvalues().maxCoeff(),cmasols.max_eigenv(),1e-8*es.eigenvalues().maxCoeff());
+  ASSERT_NEAR(es.eigenvalues().minCoeff(),cmasols.min_eigenv(),1e-8*es.eigenvalues().maxCoeff());
+  dMat V = cmasols.eigenvectors();
+  ASSERT_TRUE((V*cmasols.eigenvalues().asDiagonal()*V.transpose()).isApprox(cmasols.cov(),1e-8));
+}
+
+TEST(choleskyupdate,optimize_sphere)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_algo(CHOL_CMAES);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-8);
+  CMASolutions cmasols = cmaes<>(fsphere,cmaparams);
+  ASSERT_EQ(FTARGET,cmasols.run_status());
+}
+
+TEST(choleskyupdate,optimize_elli)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_algo(CHOL_CMAES);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-8);
+  CMASolutions cmasols = cmaes<>(elli,cmaparams);
+  ASSERT_EQ(FTARGET,cmasols.run_status());
+}
+
+TEST(choleskyupdate,optimize_tpa)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_algo(CHOL_CMAES);
+  cmaparams.set_tpa(2);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-8);
+  CMASolutions cmasols = cmaes<>(fsphere,cmaparams);
+  ASSERT_EQ(FTARGET,cmasols.run_status());
+  ASSERT_LE(cmasols.best_candidate().get_fvalue(),1e-8);
+}
@@ -0,0 +1,116 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+TEST(eigenmvn,per_instance_streams)
+{
+  int dim = 100;
+  Eigen::EigenMultivariateNormal<double> esolver1(false,1234);
+  Eigen::EigenMultivariateNormal<double> esolver2(false,1234);
+  Eigen::EigenMultivariateNormal<double> esolver3(false,1234,1);
+  dVec diag = dVec::Ones(dim);
+  esolver1.set_covar(diag);
+  esolver2.set_covar(diag);
+  esolver3.set_covar(diag);
+  dMat s1 = esolver1.samples_ind(10);
+  dMat s3 = esolver3.samples_ind(10); // drawing from another instance does not affect esolver2.
+  dMat s2 = esolver2.samples_ind(10);
+  ASSERT_TRUE(s1 == s2);
+  ASSERT_FALSE(s1 == s3);
+  ASSERT_FALSE(esolver1.samples_ind(10) == s1);
+}
+
+TEST(eigenmvn,bulk_split)
+{
+  int dim = 37;
+  Eigen::EigenMultivariateNormal<double> esolver1(false,42);
+  Eigen::EigenMultivariateNormal<double> esolver2(false,42);
+  dVec diag = dVec::Ones(dim);
+  esolver1.set_covar(diag);
+  esolver2.set_covar(diag);
+  dMat s1 = esolver1.samples_ind(1000); // large enough to be split into blocks across threads.
+  dMat s2(dim,1000);
+  for (int i=0;i<1000;i+=200)
+    s2.middleCols(i,200) = esolver2.samples_ind(200);
+  ASSERT_TRUE(s1 == s2);
+  Eigen::internal::scalar_normal_dist_op<double> randN(42);
+  dVec s3(dim);
+  for (int i=0;i<dim;i++)
+    s3(i) = randN(i);
+  ASSERT_TRUE(s3 == s1.col(0));
+}
+
+TEST(eigenmvn,regenerate)
+{
+  int dim = 37; // odd, so that vectors straddle pairs of variates.
+  Eigen::EigenMultivariateNormal<double> esolver1(false,42);
+  Eigen::EigenMultivariateNormal<double> esolver2(false,42);
+  dVec diag = dVec::Ones(dim);
+  esolver1.set_covar(diag);
+  esolver2.set_covar(diag);
+  uint64_t base = esolver1.counter();
+  dMat s1 = esolver1.samples_ind(500);
+  esolver2.skip(500*dim);
+  ASSERT_EQ(esolver1.counter(),esolver2.counter());
+  for (int i: {0,1,2,3,254,499})
+    {
+      dVec z(dim);
+      esolver2.normals_at(base,static_cast<uint64_t>(i)*dim,z.data(),dim);
+      ASSERT_TRUE(z == s1.col(i));
+    }
+  ASSERT_TRUE(esolver1.samples_ind(3) == esolver2.samples_ind(3));
+}
+
+TEST(eigenmvn,moments)
+{
+  int dim = 10;
+  Eigen::EigenMultivariateNormal<double> esolver(false,7);
+  dVec diag = dVec::Ones(dim);
+  esolver.set_covar(diag);
+  dMat s = esolver.samples_ind(100000);
+  double mean = s.mean();
+  double var = s.array().square().mean() - mean*mean;
+  double kurt = s.array().pow(4).mean();
+  ASSERT_NEAR(0.0,mean,0.005);
+  ASSERT_NEAR(1.0,var,0.005);
+  ASSERT_NEAR(3.0,kurt,0.05);
+  ASSERT_TRUE(s.allFinite());
+}
+
+TEST(eigenmvn,reusable_eigensolver)
+{
+  Eigen::ReusableEigenSolver<dMat> rsolver;
+  for (int dim : {2,3,10,10,25})
+    {
+      dMat a = dMat::Random(dim,dim);
+      dMat cov = a * a.transpose() + dMat::Identity(dim,dim);
+      Eigen::SelfAdjointEigenSolver<dMat> esolver(cov);
+      rsolver.compute(cov);
+      ASSERT_EQ(Eigen::Success,rsolver.info());
+      ASSERT_TRUE(esolver.eigenvalues().isApprox(rsolver.eigenvalues(),1e-12));
+      ASSERT_TRUE(cov.isApprox(rsolver.eigenvectors() * rsolver.eigenvalues().asDiagonal() * rsolver.eigenvectors().transpose(),1e-10));
+    }
+}
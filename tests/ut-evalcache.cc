@@ -0,0 +1,123 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+
+using namespace libcmaes;
+
+std::atomic<int> ncalls(0);
+
+FitFunc rosenbrock = [](const double *x, const int N)
+{
+  ++ncalls;
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*(x[i+1]-x[i]*x[i])*(x[i+1]-x[i]*x[i]) + (1.0-x[i])*(1.0-x[i]);
+  return val;
+};
+
+// objective over a grid, as when parameters are discretized within the simulation.
+FitFunc grid_sphere = [](const double *x, const int N)
+{
+  ++ncalls;
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    {
+      double xi = std::round(x[i]*10.0)/10.0;
+      val += xi*xi;
+    }
+  return val;
+};
+
+TEST(evalcache,lru_and_keys)
+{
+  EvalCache cache(4,0.0,1);
+  double x[2] = {1.0,2.0};
+  double f;
+  ASSERT_FALSE(cache.lookup(x,2,f));
+  cache.insert(x,2,5.0);
+  ASSERT_TRUE(cache.lookup(x,2,f));
+  ASSERT_EQ(5.0,f);
+  double y[2] = {1.0,2.0+1e-12};
+  ASSERT_FALSE(cache.lookup(y,2,f)); // exact matching.
+  double z[2] = {-0.0,0.0}, pz[2] = {0.0,0.0};
+  cache.insert(z,2,1.0);
+  ASSERT_TRUE(cache.lookup(pz,2,f));
+  ASSERT_FALSE(cache.lookup(x,1,f)); // dimension is part of the key.
+
+  // least recently used values go first.
+  for (int i=0;i<3;i++)
+    {
+      double w[2] = {10.0+i,0.0};
+      cache.insert(w,2,i);
+    }
+  ASSERT_EQ(4,cache.size());
+  ASSERT_TRUE(cache.lookup(pz,2,f));
+  ASSERT_FALSE(cache.lookup(x,2,f));
+  ASSERT_EQ(3,cache.hits());
+  ASSERT_EQ(4,cache.misses());
+
+  EvalCache qcache(100,0.1);
+  qcache.insert(x,2,5.0);
+  double qx[2] = {1.04,1.96};
+  ASSERT_TRUE(qcache.lookup(qx,2,f));
+  ASSERT_EQ(5.0,f);
+}
+
+TEST(evalcache,exact_same_search)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_initial_fvalue(true);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  cmaparams.set_fcache(100000);
+  ncalls = 0;
+  CMASolutions ccmasols = cmaes<>(rosenbrock,cmaparams);
+  ASSERT_EQ(cmasols.fevals(),ccmasols.fevals());
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),ccmasols.best_candidate().get_fvalue());
+  ASSERT_EQ(ccmasols.fcache_misses(),ncalls.load());
+  ASSERT_EQ(ccmasols.fevals(),ccmasols.fcache_hits()+ccmasols.fcache_misses());
+  ASSERT_EQ(0,cmasols.fcache_hits());
+}
+
+TEST(evalcache,quantized_grid)
+{
+  int dim = 5;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_mt_feval(true);
+  cmaparams.set_feval_threads(4);
+  cmaparams.set_max_iter(200);
+  cmaparams.set_fcache(10000,0.1);
+  ncalls = 0;
+  CMASolutions cmasols = cmaes<>(grid_sphere,cmaparams);
+  ASSERT_EQ(0.0,cmasols.best_candidate().get_fvalue());
+  ASSERT_LT(0,cmasols.fcache_hits());
+  ASSERT_EQ(cmasols.fcache_misses(),ncalls.load());
+  ASSERT_LT(ncalls.load(),cmasols.fevals());
+}
@@ -0,0 +1,116 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc fsphere = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+// counts the tasks it runs, and runs them on the built-in pool.
+class CountingEvaluator : public Evaluator
+{
+public:
+  CountingEvaluator():_pool(3) {}
+
+  void parallel_for(const int &n, const EvalTask &task) override
+  {
+    _ntasks += n;
+    _pool.parallel_for(n,task);
+  }
+
+  ThreadPool _pool;
+  std::atomic<int> _ntasks{0};
+};
+
+TEST(evaluator,thread_pool)
+{
+  ThreadPool pool(4);
+  ASSERT_EQ(4,pool.nthreads());
+  for (int b=0;b<50;b++)
+    {
+      int n = 1 + 37*b % 200;
+      std::vector<std::atomic<int>> runs(n);
+      for (auto &r: runs)
+	r = 0;
+      pool.parallel_for(n,[&](const int &i)
+			{
+			  if (i % 13 == 0) // uneven task durations.
+			    std::this_thread::sleep_for(std::chrono::microseconds(200));
+			  ++runs[i];
+			});
+      for (int i=0;i<n;i++)
+	ASSERT_EQ(1,runs[i].load());
+    }
+}
+
+TEST(evaluator,exceptions_and_nesting)
+{
+  ThreadPool pool(3);
+  ASSERT_THROW(pool.parallel_for(20,[](const int &i){ if (i == 7) throw std::runtime_error("fail"); }),std::runtime_error);
+
+  // nested batches run within their task, and the pool is usable afterwards.
+  std::atomic<int> count(0);
+  pool.parallel_for(8,[&](const int &)
+		    {
+		      pool.parallel_for(5,[&](const int &){ ++count; });
+		    });
+  ASSERT_EQ(40,count.load());
+}
+
+TEST(evaluator,custom_evaluator)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  std::shared_ptr<CountingEvaluator> ev = std::make_shared<CountingEvaluator>();
+  cmaparams.set_evaluator(ev);
+  CMASolutions cmasols = cmaes<>(fsphere,cmaparams);
+  ASSERT_LE(0,cmasols.run_status());
+  ASSERT_LE(cmasols.best_candidate().get_fvalue(),1e-8);
+  ASSERT_EQ(cmasols.fevals(),ev->_ntasks.load());
+}
+
+TEST(evaluator,mt_feval_same_result)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  CMASolutions seqsols = cmaes<>(fsphere,cmaparams);
+  cmaparams.set_mt_feval(true);
+  cmaparams.set_feval_threads(4);
+  CMASolutions mtsols = cmaes<>(fsphere,cmaparams);
+  ASSERT_EQ(seqsols.fevals(),mtsols.fevals());
+  ASSERT_EQ(seqsols.best_candidate().get_fvalue(),mtsols.best_candidate().get_fvalue());
+}
@@ -0,0 +1,107 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc rosenbrock = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*(x[i+1]-x[i]*x[i])*(x[i+1]-x[i]*x[i]) + (1.0-x[i])*(1.0-x[i]);
+  return val;
+};
+
+TEST(fixedcmastrategy,same_generations)
+{
+  int dim = 5;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  ESOptimizer<CMAStrategy<CovarianceUpdate>,CMAParameters<>> optim(rosenbrock,cmaparams);
+  ESOptimizer<FixedCMAStrategy<5>,CMAParameters<>> foptim(rosenbrock,cmaparams);
+  ASSERT_TRUE(foptim.fixed_dim());
+
+  // same draws and same update, up to the rounding of the fixed-size kernels.
+  for (int i=0;i<20;i++)
+    {
+      const dMat &candidates = optim.ask();
+      const dMat &fcandidates = foptim.ask();
+      ASSERT_TRUE(candidates.isApprox(fcandidates,1e-10));
+      optim.eval(candidates);
+      foptim.eval(fcandidates);
+      optim.tell();
+      foptim.tell();
+      optim.inc_iter();
+      foptim.inc_iter();
+    }
+  CMASolutions &sols = optim.get_solutions();
+  CMASolutions &fsols = foptim.get_solutions();
+  ASSERT_TRUE(sols.cov().isApprox(fsols.cov(),1e-10));
+  ASSERT_NEAR(sols.sigma(),fsols.sigma(),1e-10*sols.sigma());
+  ASSERT_NEAR(sols.max_eigenv(),fsols.max_eigenv(),1e-10*sols.max_eigenv());
+  ASSERT_NEAR(sols.best_candidate().get_fvalue(),fsols.best_candidate().get_fvalue(),1e-8*sols.best_candidate().get_fvalue());
+}
+
+TEST(fixedcmastrategy,optimize)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-10);
+  ESOptimizer<FixedCMAStrategy<10>,CMAParameters<>> foptim(rosenbrock,cmaparams);
+  ASSERT_EQ(OPTI_SUCCESS,foptim.optimize());
+  CMASolutions &fsols = foptim.get_solutions();
+  ASSERT_EQ(FTARGET,fsols.run_status());
+  ASSERT_LE(fsols.best_candidate().get_fvalue(),1e-10);
+  ASSERT_EQ(fsols.eigenvalues().size(),dim);
+  ASSERT_LT(0.0,fsols.min_eigenv());
+}
+
+TEST(fixedcmastrategy,fallback)
+{
+  // other dimension, and other flavor, run through CMAStrategy.
+  int dim = 4;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-8);
+  ESOptimizer<FixedCMAStrategy<5>,CMAParameters<>> foptim(rosenbrock,cmaparams);
+  ASSERT_FALSE(foptim.fixed_dim());
+  ASSERT_EQ(OPTI_SUCCESS,foptim.optimize());
+  ASSERT_LE(foptim.get_solutions().best_candidate().get_fvalue(),1e-8);
+
+  std::vector<double> x5(5,0.0);
+  CMAParameters<> sepparams(x5,0.5,-1,1234);
+  sepparams.set_quiet(true);
+  sepparams.set_sep();
+  sepparams.set_max_iter(50);
+  ESOptimizer<FixedCMAStrategy<5>,CMAParameters<>> soptim(rosenbrock,sepparams);
+  ESOptimizer<CMAStrategy<CovarianceUpdate>,CMAParameters<>> doptim(rosenbrock,sepparams);
+  ASSERT_FALSE(soptim.fixed_dim());
+  soptim.optimize();
+  doptim.optimize();
+  ASSERT_EQ(doptim.get_solutions().best_candidate().get_fvalue(),soptim.get_solutions().best_candidate().get_fvalue());
+}
@@ -0,0 +1,127 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <iostream>
+
+using namespace libcmaes;
+
+inline double rosen(const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*(x[i+1]-x[i]*x[i])*(x[i+1]-x[i]*x[i]) + (1.0-x[i])*(1.0-x[i]);
+  return val;
+}
+
+FitFunc rosenbrock = [](const double *x, const int N) { return rosen(x,N); };
+
+// functor that counts its calls, shared among its copies.
+struct CountingRosen
+{
+  double operator()(const double *x, const int N) const
+  {
+    ++(*_ncalls);
+    return rosen(x,N);
+  }
+  std::shared_ptr<int> _ncalls = std::make_shared<int>(0);
+};
+
+TEST(inlinefitfunc,same_as_fitfunc)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  CMASolutions lcmasols = cmaes<>([](const double *x, const int N) { return rosen(x,N); },cmaparams);
+  ASSERT_EQ(cmasols.fevals(),lcmasols.fevals());
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),lcmasols.best_candidate().get_fvalue());
+
+  CountingRosen crosen;
+  CMASolutions ccmasols = cmaes<>(crosen,cmaparams);
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),ccmasols.best_candidate().get_fvalue());
+  ASSERT_EQ(ccmasols.fevals(),*crosen._ncalls);
+
+  // plain functions, and other genotype / phenotype transforms.
+  CMASolutions fcmasols = cmaes<>(&rosen,cmaparams);
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),fcmasols.best_candidate().get_fvalue());
+  std::vector<double> lbounds(dim,-5.0), ubounds(dim,5.0);
+  GenoPheno<pwqBoundStrategy> gp(&lbounds.front(),&ubounds.front(),dim);
+  CMAParameters<GenoPheno<pwqBoundStrategy>> bcmaparams(x0,0.5,-1,1234,gp);
+  bcmaparams.set_quiet(true);
+  CMASolutions bcmasols = cmaes<GenoPheno<pwqBoundStrategy>>(rosenbrock,bcmaparams);
+  CMASolutions blcmasols = cmaes<GenoPheno<pwqBoundStrategy>>(&rosen,bcmaparams);
+  ASSERT_EQ(bcmasols.best_candidate().get_fvalue(),blcmasols.best_candidate().get_fvalue());
+}
+
+TEST(inlinefitfunc,gradient_and_maximize)
+{
+  int dim = 8;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_gradient(true);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  CMASolutions lcmasols = cmaes<>(&rosen,cmaparams);
+  ASSERT_EQ(cmasols.fevals(),lcmasols.fevals());
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),lcmasols.best_candidate().get_fvalue());
+
+  FitFunc mfunc = [](const double *x, const int N) { return -rosen(x,N); };
+  CMAParameters<> mcmaparams(x0,0.5,-1,1234);
+  mcmaparams.set_quiet(true);
+  mcmaparams.set_maximize(true);
+  CMASolutions mcmasols = cmaes<>(mfunc,mcmaparams);
+  CMASolutions lmcmasols = cmaes<>([](const double *x, const int N) { return -rosen(x,N); },mcmaparams);
+  ASSERT_EQ(mcmasols.best_candidate().get_fvalue(),lmcmasols.best_candidate().get_fvalue());
+}
+
+TEST(inlinefitfunc,parallel_and_ask_tell)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  cmaparams.set_mt_feval(true);
+  cmaparams.set_feval_threads(4);
+  CountingRosen crosen;
+  CMASolutions ccmasols = cmaes<>(crosen,cmaparams);
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),ccmasols.best_candidate().get_fvalue());
+  ASSERT_EQ(ccmasols.fevals(),*crosen._ncalls);
+
+  // ask / tell, through an optimizer.
+  cmaparams.set_mt_feval(false);
+  FitFunc ifunc = inline_fitfunc(crosen);
+  ESOptimizer<CMAStrategy<CovarianceUpdate>,CMAParameters<>> optim(ifunc,cmaparams);
+  *crosen._ncalls = 0;
+  while (!optim.stop())
+    {
+      const dMat &candidates = optim.ask();
+      optim.eval(candidates);
+      optim.tell();
+      optim.inc_iter();
+    }
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),optim.get_solutions().best_candidate().get_fvalue());
+  ASSERT_EQ(optim.get_solutions().fevals(),*crosen._ncalls);
+}
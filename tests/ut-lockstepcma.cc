@@ -0,0 +1,148 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc fsphere = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+FitFunc rosenbrock = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*(x[i+1]-x[i]*x[i])*(x[i+1]-x[i]*x[i]) + (1.0-x[i])*(1.0-x[i]);
+  return val;
+};
+
+// gaussian peak fit, with its own data per instance.
+FitFunc peak_fit(const double &c)
+{
+  return [c](const double *x, const int N)
+    {
+      double val = 0.0;
+      for (int k=0;k<15;k++)
+	{
+	  double t = -1.5 + 0.2*k;
+	  double y = exp(-(t-c)*(t-c)) - x[0]*exp(-(t-x[1])*(t-x[1])/(x[2]*x[2]+1e-12));
+	  val += y*y;
+	}
+      return val + 0.0*N;
+    };
+}
+
+TEST(lockstepcma,optimize_like_cmaes)
+{
+  std::vector<FitFunc> funcs;
+  std::vector<CMAParameters<>> params;
+  for (int dim=2;dim<=10;dim+=2)
+    for (int s=1;s<=3;s++)
+      {
+	std::vector<double> x0(dim,1.0);
+	CMAParameters<> cmaparams(x0,0.5,-1,s);
+	funcs.push_back(dim % 4 == 0 ? rosenbrock : fsphere);
+	params.push_back(cmaparams);
+      }
+  LockstepCMA<> lcma(funcs,params);
+  ASSERT_EQ(OPTI_SUCCESS,lcma.optimize());
+  for (int k=0;k<lcma.size();k++)
+    {
+      ASSERT_TRUE(lcma.lockstep(k));
+      CMASolutions &sols = lcma.get_solutions(k);
+      CMASolutions cmasols = cmaes<>(funcs[k],params[k]);
+      int dim = params[k].dim();
+      ASSERT_LE(0,sols.run_status());
+      ASSERT_EQ(sols.niter()*params[k].lambda(),sols.fevals());
+      ASSERT_NEAR(0.0,sols.best_candidate().get_fvalue(),1e-8);
+      ASSERT_NEAR(0.0,sols.get_best_seen_candidate().get_fvalue(),1e-8);
+      ASSERT_LE(sols.get_best_seen_candidate().get_fvalue(),sols.best_candidate().get_fvalue());
+      ASSERT_EQ(dim,sols.cov().rows());
+      ASSERT_FALSE(sols.status_msg().empty());
+
+      // same kind of run as the regular strategy.
+      ASSERT_LT(sols.niter(),3*cmasols.niter());
+      ASSERT_LT(cmasols.niter(),3*sols.niter());
+    }
+}
+
+TEST(lockstepcma,peak_fits_and_fallback)
+{
+  std::vector<FitFunc> funcs;
+  std::vector<CMAParameters<>> params;
+  for (int k=0;k<40;k++)
+    {
+      std::vector<double> x0 = {0.5,0.0,0.5};
+      CMAParameters<> cmaparams(x0,0.3,-1,k+1);
+      cmaparams.set_ftarget(1e-10);
+      if (k % 10 == 9)
+	cmaparams.set_algo(aCMAES); // not in lockstep.
+      funcs.push_back(peak_fit(-0.5+0.025*k));
+      params.push_back(cmaparams);
+    }
+  LockstepCMA<> lcma(funcs,params);
+  lcma.optimize();
+  for (int k=0;k<lcma.size();k++)
+    {
+      ASSERT_EQ(k % 10 != 9,lcma.lockstep(k));
+      CMASolutions &sols = lcma.get_solutions(k);
+      ASSERT_EQ(FTARGET,sols.run_status());
+      ASSERT_NEAR(-0.5+0.025*k,sols.best_candidate().get_x_dvec()(1),1e-4);
+    }
+}
+
+TEST(lockstepcma,budget_and_maximize)
+{
+  std::vector<FitFunc> funcs;
+  std::vector<CMAParameters<>> params;
+  for (int k=0;k<8;k++)
+    {
+      std::vector<double> x0(4,2.0);
+      CMAParameters<> cmaparams(x0,1.0,-1,100+k);
+      cmaparams.set_max_fevals(80*(k+1));
+      if (k % 2)
+	{
+	  cmaparams.set_maximize(true);
+	  funcs.push_back([](const double *x, const int N) { return -fsphere(x,N); });
+	}
+      else funcs.push_back(fsphere);
+      params.push_back(cmaparams);
+    }
+  LockstepCMA<> lcma(funcs,params);
+  lcma.optimize();
+  for (int k=0;k<lcma.size();k++)
+    {
+      CMASolutions &sols = lcma.get_solutions(k);
+      ASSERT_EQ(MAXFEVALS,sols.run_status());
+      ASSERT_LE(80*(k+1),sols.fevals());
+      ASSERT_GT(80*(k+1)+params[k].lambda(),sols.fevals());
+      ASSERT_LT(fabs(sols.best_candidate().get_fvalue()),fsphere(std::vector<double>(4,2.0).data(),4));
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <iostream>
+
+using namespace libcmaes;
+
+// lorentzian peak fit, one dataset per job.
+FitFunc lorentz_fit(const double &x0, const double &gamma)
+{
+  return [x0,gamma](const double *x, const int N)
+    {
+      double val = 0.0;
+      for (int k=0;k<20;k++)
+	{
+	  double t = -2.0 + 0.2*k;
+	  double y = gamma*gamma / ((t-x0)*(t-x0) + gamma*gamma);
+	  double m = x[2]*x[1]*x[1] / ((t-x[0])*(t-x[0]) + x[1]*x[1]);
+	  val += (y-m)*(y-m);
+	}
+      return val + 0.0*N;
+    };
+}
+
+TEST(optimizergroup,same_as_sequential)
+{
+  int njobs = 24;
+  std::vector<double> x0 = {0.0,1.0,0.5};
+  CMAParameters<> cmaparams(x0,0.5,-1,1);
+  cmaparams.set_quiet(true);
+  cmaparams.set_max_iter(300);
+  std::vector<FitFunc> funcs;
+  for (int j=0;j<njobs;j++)
+    funcs.push_back(lorentz_fit(-1.0+0.1*j,0.3+0.02*j));
+
+  OptimizerGroup<> group(4,1234);
+  OptimizerGroup<> group1(1,1234);
+  for (int j=0;j<njobs;j++)
+    {
+      ASSERT_EQ(j,group.add(funcs[j],cmaparams));
+      group1.add(funcs[j],cmaparams);
+    }
+  group1.set_steps(7);
+  ASSERT_EQ(OPTI_SUCCESS,group.optimize());
+  ASSERT_EQ(OPTI_SUCCESS,group1.optimize());
+  for (int j=0;j<njobs;j++)
+    {
+      // results depend on the job seed only.
+      CMAParameters<> p = cmaparams;
+      p.set_seed(group.job_seed(j));
+      ASSERT_EQ(group.job_seed(j),group.get_parameters(j).get_seed());
+      CMASolutions cmasols = cmaes<>(funcs[j],p);
+      ASSERT_EQ(cmasols.fevals(),group.get_solutions(j).fevals());
+      ASSERT_EQ(cmasols.best_candidate().get_fvalue(),group.get_solutions(j).best_candidate().get_fvalue());
+      ASSERT_EQ(cmasols.fevals(),group1.get_solutions(j).fevals());
+      ASSERT_EQ(cmasols.run_status(),group.get_solutions(j).run_status());
+      ASSERT_EQ(cmasols.status_msg(),group.get_solutions(j).status_msg());
+      if (j > 0)
+	ASSERT_NE(group.job_seed(j-1),group.job_seed(j));
+    }
+}
+
+TEST(optimizergroup,failing_job)
+{
+  std::vector<double> x0 = {0.0,1.0,0.5};
+  CMAParameters<> cmaparams(x0,0.5,-1,1);
+  cmaparams.set_quiet(true);
+  FitFunc fit = lorentz_fit(0.2,0.5);
+  int calls = 0;
+  FitFunc ffail = [&calls](const double*, const int)
+    {
+      if (++calls > 50)
+	throw std::runtime_error("simulation failed");
+      return 1.0;
+    };
+  OptimizerGroup<> group(2,7);
+  group.add(fit,cmaparams);
+  group.add(ffail,cmaparams);
+  ASSERT_EQ(OPTI_ERR_TERMINATION,group.optimize());
+  ASSERT_EQ(OPTI_SUCCESS,group.status(0));
+  ASSERT_TRUE(group.error(0) == nullptr);
+  ASSERT_LT(group.get_solutions(0).best_candidate().get_fvalue(),1e-8);
+  ASSERT_EQ(OPTI_ERR_UNKNOWN,group.status(1));
+  ASSERT_THROW(std::rethrow_exception(group.error(1)),std::runtime_error);
+}
+
+TEST(optimizergroup,concurrent_cmaes)
+{
+  // plain cmaes() calls from user threads.
+  int nthreads = 4;
+  std::vector<double> x0 = {0.0,1.0,0.5};
+  std::vector<FitFunc> funcs;
+  std::vector<CMASolutions> sols(nthreads);
+  for (int t=0;t<nthreads;t++)
+    funcs.push_back(lorentz_fit(0.1*t,0.5));
+  std::vector<std::thread> threads;
+  for (int t=0;t<nthreads;t++)
+    threads.emplace_back([&,t]()
+      {
+	CMAParameters<> cmaparams(x0,0.5,-1,100+t);
+	cmaparams.set_quiet(true);
+	cmaparams.set_noisy();
+	cmaparams.set_max_iter(100);
+	sols[t] = cmaes<>(funcs[t],cmaparams);
+      });
+  for (std::thread &th: threads)
+    th.join();
+  for (int t=0;t<nthreads;t++)
+    {
+      CMAParameters<> cmaparams(x0,0.5,-1,100+t);
+      cmaparams.set_quiet(true);
+      cmaparams.set_noisy();
+      cmaparams.set_max_iter(100);
+      CMASolutions cmasols = cmaes<>(funcs[t],cmaparams);
+      ASSERT_EQ(cmasols.best_candidate().get_fvalue(),sols[t].best_candidate().get_fvalue());
+    }
+}
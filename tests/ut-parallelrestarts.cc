@@ -0,0 +1,133 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <iostream>
+
+using namespace libcmaes;
+
+std::atomic<int> ncalls(0);
+
+FitFunc rastrigin = [](const double *x, const int N)
+{
+  ++ncalls;
+  static double A = 10.0;
+  double val = A*N;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i] - A*cos(2*M_PI*x[i]);
+  return val;
+};
+
+TEST(parallelrestarts,ipop_budget)
+{
+  int dim = 5;
+  std::vector<double> x0(dim,3.0);
+  CMAParameters<> cmaparams(x0,2.0,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_algo(IPOP_CMAES);
+  cmaparams.set_restart_threads(4);
+  cmaparams.set_max_fevals(3000);
+  ncalls = 0;
+  CMASolutions cmasols = cmaes<>(rastrigin,cmaparams);
+  ASSERT_LE(0,cmasols.run_status());
+  ASSERT_GE(cmasols.best_candidate().get_fvalue(),0.0);
+
+  // concurrent runs, of population lambda to 8*lambda, stop within an iteration of the global budget.
+  ASSERT_LE(3000,ncalls.load());
+  ASSERT_LE(ncalls.load(),3000 + 15*cmaparams.lambda());
+}
+
+TEST(parallelrestarts,ftarget_cancels_siblings)
+{
+  int dim = 5;
+  std::vector<double> x0(dim,3.0);
+  CMAParameters<> cmaparams(x0,2.0,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_algo(IPOP_CMAES);
+  cmaparams.set_restart_threads(3);
+  cmaparams.set_ftarget(1e-8);
+  ncalls = 0;
+  CMASolutions cmasols = cmaes<>(rastrigin,cmaparams);
+  ASSERT_EQ(FTARGET,cmasols.run_status());
+  ASSERT_LE(cmasols.best_candidate().get_fvalue(),1e-8);
+}
+
+// runs BIPOP restarts in parallel, with a slow first generation so that all slots
+// are handed a run before any progress is reported, and checks both regimes ran.
+void bipop_regimes(const int &max_fevals)
+{
+  int dim = 5;
+  std::vector<double> x0(dim,3.0);
+  CMAParameters<> cmaparams(x0,2.0,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_algo(BIPOP_CMAES);
+  cmaparams.set_restart_threads(4);
+  cmaparams.set_restarts(4);
+  cmaparams.set_max_fevals(max_fevals);
+  int lambda_def = cmaparams.lambda();
+
+  ncalls = 0;
+  FitFunc slow_start = [](const double *x, const int N)
+    {
+      if (ncalls.load() < 200)
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      return rastrigin(x,N);
+    };
+  std::set<int> lambdas; // progress function calls are serialized.
+  std::set<double> sigmas;
+  std::vector<std::pair<int,double>> runs; // runs in order of first progress.
+  ProgressFunc<CMAParameters<>,CMASolutions> pfunc = [&](const CMAParameters<> &cmaparams, const CMASolutions&)
+    {
+      lambdas.insert(cmaparams.lambda());
+      sigmas.insert(cmaparams.get_sigma_init());
+      std::pair<int,double> run(cmaparams.lambda(),cmaparams.get_sigma_init());
+      if (std::find(runs.begin(),runs.end(),run) == runs.end())
+	runs.push_back(run);
+      return 0;
+    };
+  CMASolutions cmasols = cmaes<>(slow_start,cmaparams,pfunc);
+  ASSERT_LE(0,cmasols.run_status());
+  ASSERT_LT(lambda_def,*lambdas.rbegin()); // large population runs.
+  ASSERT_TRUE(lambdas.count(lambda_def));
+  ASSERT_TRUE(sigmas.count(2.0));
+  ASSERT_LT(*sigmas.begin(),2.0); // small population runs, with their own step-size.
+
+  // the runs handed to the slots at launch already interleave both regimes.
+  ASSERT_LE(4u,runs.size());
+  ASSERT_TRUE(std::any_of(runs.begin(),runs.begin()+4,[](const std::pair<int,double> &r){ return r.second < 2.0; }));
+}
+
+TEST(parallelrestarts,bipop_regimes)
+{
+  bipop_regimes(50000);
+}
+
+TEST(parallelrestarts,bipop_regimes_uncapped)
+{
+  bipop_regimes(-1); // large population runs reserve an estimate of their budget instead of a cap.
+}
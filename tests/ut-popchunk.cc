@@ -0,0 +1,95 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <type_traits>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc rosenbrock = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*(x[i+1]-x[i]*x[i])*(x[i+1]-x[i]*x[i]) + (1.0-x[i])*(1.0-x[i]);
+  return val;
+};
+
+template<class TCovarianceUpdate>
+void check_regenerated(const std::string &algo)
+{
+  int dim = 11;
+  int lambda = 100;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,lambda,1234);
+  cmaparams.set_str_algo(algo);
+  cmaparams.set_pop_chunk(7);
+  cmaparams.set_quiet(true);
+  ESOptimizer<CMAStrategy<TCovarianceUpdate>,CMAParameters<>> optim(rosenbrock,cmaparams);
+  ASSERT_TRUE(optim.compressed_population());
+  for (int g=0;g<5;g++)
+    {
+      optim.ask_eval_chunks();
+      optim.tell();
+      optim.inc_iter();
+
+      // regenerated candidates are exactly those that were evaluated.
+      CMASolutions &sols = optim.get_solutions();
+      int nx = 0;
+      for (int i=0;i<lambda;i++)
+	{
+	  Candidate &c = sols.get_candidate(i);
+	  if (i < cmaparams.mu() || i == lambda-1)
+	    ASSERT_EQ(dim,(int)c.get_x_size());
+	  if (c.get_x_size())
+	    {
+	      ASSERT_EQ(c.get_fvalue(),rosenbrock(c.get_x_ptr(),dim));
+	      ++nx;
+	    }
+	}
+      ASSERT_EQ(nx,sols.population().cols());
+      if (!std::is_same<TCovarianceUpdate,ACovarianceUpdate>::value) // active update uses the mu worst as well.
+	ASSERT_LT(nx,lambda);
+      ASSERT_EQ(lambda*(g+1),sols.fevals());
+    }
+}
+
+TEST(popchunk,regenerate)
+{
+  check_regenerated<CovarianceUpdate>("cmaes");
+  check_regenerated<ACovarianceUpdate>("acmaes");
+  check_regenerated<CovarianceUpdate>("sepcmaes");
+  check_regenerated<LMCMAUpdate>("lmcma");
+  check_regenerated<VkDCMAUpdate>("vkdcma");
+}
+
+TEST(popchunk,optimize)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.5,200,1234);
+  cmaparams.set_pop_chunk(16);
+  cmaparams.set_quiet(true);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  ASSERT_LE(cmasols.best_candidate().get_fvalue(),1e-8);
+  ASSERT_EQ(0,cmasols.fevals() % 200);
+}
@@ -0,0 +1,160 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <libcmaes/processpool.h>
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <cstdlib>
+#include <unistd.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc fsphere = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+// this test program is its own mock worker, when started by a pool.
+static int worker_status = ProcessPool::is_worker() ? (std::exit(ProcessPool::worker_main(fsphere)),0) : 0;
+
+TEST(processpool,same_as_fitfunc)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  CMASolutions cmasols = cmaes<>(fsphere,cmaparams);
+
+  ProcessPool pool(fsphere,3,dim);
+  ASSERT_EQ(3,pool.nworkers());
+  BatchFitFunc bfunc = pool.batch_func();
+  CMASolutions pcmasols = cmaes<>(bfunc,cmaparams);
+  ASSERT_EQ(cmasols.fevals(),pcmasols.fevals());
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),pcmasols.best_candidate().get_fvalue());
+  ASSERT_EQ(0,pool.restarts());
+}
+
+TEST(processpool,exec_worker)
+{
+  int dim = 5;
+  ProcessPool pool({"/proc/self/exe"},2,dim,3);
+  dMat x = dMat::Random(dim,17);
+  dVec fvalues(x.cols());
+  pool.eval(x,fvalues);
+  for (int c=0;c<x.cols();c++)
+    ASSERT_EQ(fsphere(x.col(c).data(),dim),fvalues(c));
+  ASSERT_EQ(0,pool.restarts());
+}
+
+TEST(processpool,crashing_worker)
+{
+  // workers die every few evaluations, candidates are issued again.
+  int dim = 4;
+  FitFunc fcrash = [](const double *x, const int N)
+    {
+      static int calls = 0;
+      if (++calls % 5 == 0)
+	_exit(1);
+      return fsphere(x,N);
+    };
+  ProcessPool pool(fcrash,2,dim);
+  dMat x = dMat::Random(dim,40);
+  dVec fvalues(x.cols());
+  pool.eval(x,fvalues);
+  for (int c=0;c<x.cols();c++)
+    ASSERT_EQ(fsphere(x.col(c).data(),dim),fvalues(c));
+  ASSERT_LT(0,pool.restarts());
+
+  // a candidate that always kills its worker is given up on, and the pool remains usable.
+  FitFunc fpoison = [](const double *x, const int N)
+    {
+      if (x[0] > 10.0)
+	_exit(2);
+      return fsphere(x,N);
+    };
+  ProcessPool ppool(fpoison,2,dim);
+  ppool.set_max_retries(2);
+  x(0,7) = 100.0;
+  ASSERT_THROW(ppool.eval(x,fvalues),std::runtime_error);
+  x(0,7) = 0.0;
+  ppool.eval(x,fvalues);
+  ASSERT_EQ(fsphere(x.col(7).data(),dim),fvalues(7));
+}
+
+TEST(processpool,idle_worker_dies)
+{
+  // workers die a second after their first evaluation, idle or not.
+  int dim = 3;
+  FitFunc falarm = [](const double *x, const int N)
+    {
+      static bool armed = false;
+      if (!armed)
+	{
+	  armed = true;
+	  alarm(1);
+	}
+      return fsphere(x,N);
+    };
+  ProcessPool pool(falarm,2,dim,1);
+  dMat x = dMat::Random(dim,2);
+  dVec fvalues(x.cols());
+  pool.eval(x,fvalues);
+  ASSERT_EQ(0,pool.restarts());
+  sleep(2);
+
+  // the first worker fails its doorbell, the idle second one is found dead and restarted.
+  dMat x1 = x.leftCols(1);
+  dVec fvalue(1);
+  pool.eval(x1,fvalue);
+  ASSERT_EQ(fsphere(x1.col(0).data(),dim),fvalue(0));
+  ASSERT_EQ(2,pool.restarts());
+}
+
+TEST(processpool,fork_needs_single_thread)
+{
+  int dim = 3;
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool done = false;
+  std::thread t([&]()
+		{
+		  std::unique_lock<std::mutex> lock(mtx);
+		  cv.wait(lock,[&]{ return done; });
+		});
+  if (access("/proc/self/task",R_OK) == 0)
+    EXPECT_THROW(ProcessPool(fsphere,2,dim),std::runtime_error);
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    done = true;
+  }
+  cv.notify_one();
+  t.join();
+  ProcessPool pool(fsphere,2,dim);
+  ASSERT_EQ(2,pool.nworkers());
+}
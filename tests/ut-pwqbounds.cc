@@ -0,0 +1,170 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+using namespace libcmaes;
+
+// scalar transforms, as in boundary_transformation.c, for reference.
+struct RefPwq
+{
+  RefPwq(const dVec &lb, const dVec &ub)
+    :_lb(lb),_ub(ub)
+  {
+    int dim = lb.size();
+    dVec tmpdiff1 = _ub - _lb;
+    dVec tmpdiff2 = 0.5*tmpdiff1;
+    _al = tmpdiff2.cwiseMin((1.0/20.0) * (dVec::Constant(dim,1.0) + _lb.cwiseAbs()));
+    _au = tmpdiff2.cwiseMin((1.0/20.0) * (dVec::Constant(dim,1.0) + _ub.cwiseAbs()));
+    _xlow = _lb - 2.0 * _al - tmpdiff2;
+    _xup = _ub + 2.0 * _au + tmpdiff2;
+    _r = 2.0 * (tmpdiff1 + _al + _au);
+  }
+
+  void to_f(const dVec &x, dVec &y) const
+  {
+    y = x;
+    for (int i=0;i<x.rows();i++)
+      {
+	if (y[i] < _xlow[i])
+	  y[i] += _r[i] * (1.0 + static_cast<int>((_xlow[i]-y[i])/_r[i]));
+	if (y[i] > _xup[i])
+	  y[i] -= _r[i] * (1.0 + static_cast<int>((y[i]-_xup[i])/_r[i]));
+	if (y[i] < _lb[i] - _al[i])
+	  y[i] += 2.0 * (_lb[i] - _al[i] - y[i]);
+	if (y[i] > _ub[i] + _au[i])
+	  y[i] -= 2.0 * (y[i] - _ub[i] - _au[i]);
+	if (y[i] < _lb[i] + _al[i])
+	  y[i] = _lb[i] + (y[i] - (_lb[i] - _al[i])) * (y[i] - (_lb[i] - _al[i])) / 4.0 / _al[i];
+	else if (y[i] > _ub[i] - _au[i])
+	  y[i] = _ub[i] - (y[i] - (_ub[i] + _au[i])) * (y[i] - (_ub[i] + _au[i])) / 4.0 / _au[i];
+      }
+  }
+
+  void to_internal(dVec &x, const dVec &y) const
+  {
+    x = y;
+    for (int i=0;i<y.rows();i++)
+      {
+	if (x[i] < _lb[i] + _al[i])
+	  x[i] = (_lb[i] - _al[i]) + 2.0 * sqrt(_al[i] * fabs(_lb[i] - x[i]));
+	else if (x[i] > _ub[i] - _au[i])
+	  x[i] = (_ub[i] + _au[i]) - 2.0 * sqrt(_au[i] * fabs(x[i] - _ub[i]));
+      }
+  }
+
+  dVec _lb, _ub, _al, _au, _xlow, _xup, _r;
+};
+
+static bool same_bits(const dVec &a, const dVec &b)
+{
+  return a.size() == b.size() && std::memcmp(a.data(),b.data(),a.size()*sizeof(double)) == 0;
+}
+
+class pwqbounds : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    // narrow, wide, asymmetric and offset bounds.
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> unif(-100.0,100.0);
+    for (int i=0;i<_dim;i++)
+      {
+	double a = unif(gen), w = std::pow(10.0,unif(gen)/40.0);
+	_lb.push_back(i % 7 == 0 ? -5.0 : a);
+	_ub.push_back(i % 7 == 0 ? 5.0 : a + w);
+      }
+    // inside, near and far outside the bounds.
+    _x.resize(_dim,_lambda);
+    for (int c=0;c<_lambda;c++)
+      for (int i=0;i<_dim;i++)
+	{
+	  double w = _ub[i] - _lb[i];
+	  _x(i,c) = _lb[i] + w * unif(gen) / (c % 3 == 0 ? 100.0 : c % 3 == 1 ? 10.0 : 0.01);
+	}
+  }
+
+  int _dim = 50;
+  int _lambda = 120; // over the threshold of parallel columns.
+  std::vector<double> _lb, _ub;
+  dMat _x;
+};
+
+TEST_F(pwqbounds,to_f_representation)
+{
+  pwqBoundStrategy pwq(&_lb.front(),&_ub.front(),_dim);
+  RefPwq ref(Eigen::Map<dVec>(&_lb.front(),_dim),Eigen::Map<dVec>(&_ub.front(),_dim));
+  dMat y = _x;
+  pwq.to_f_representation(y);
+  for (int c=0;c<_lambda;c++)
+    {
+      dVec yref, ycol;
+      ref.to_f(_x.col(c),yref);
+      pwq.to_f_representation(_x.col(c),ycol);
+      ASSERT_TRUE(same_bits(yref,ycol));
+      ASSERT_TRUE(same_bits(yref,y.col(c)));
+      for (int i=0;i<_dim;i++)
+	{
+	  ASSERT_LE(_lb[i],ycol[i]);
+	  ASSERT_GE(_ub[i],ycol[i]);
+	}
+    }
+}
+
+TEST_F(pwqbounds,to_internal_representation)
+{
+  pwqBoundStrategy pwq(&_lb.front(),&_ub.front(),_dim);
+  RefPwq ref(Eigen::Map<dVec>(&_lb.front(),_dim),Eigen::Map<dVec>(&_ub.front(),_dim));
+  dMat y = _x;
+  pwq.to_f_representation(y);
+  dMat x = y;
+  pwq.to_internal_representation(x);
+  for (int c=0;c<_lambda;c++)
+    {
+      dVec xref, xcol;
+      ref.to_internal(xref,y.col(c));
+      pwq.to_internal_representation(xcol,y.col(c));
+      ASSERT_TRUE(same_bits(xref,xcol));
+      ASSERT_TRUE(same_bits(xref,x.col(c)));
+    }
+}
+
+TEST_F(pwqbounds,genopheno)
+{
+  GenoPheno<pwqBoundStrategy> gp(&_lb.front(),&_ub.front(),_dim);
+  RefPwq ref(Eigen::Map<dVec>(&_lb.front(),_dim),Eigen::Map<dVec>(&_ub.front(),_dim));
+  dMat y = gp.pheno(_x);
+  dMat x = gp.geno(y);
+  for (int c=0;c<_lambda;c++)
+    {
+      dVec yref, xref;
+      ref.to_f(_x.col(c),yref);
+      ref.to_internal(xref,yref);
+      ASSERT_TRUE(same_bits(yref,y.col(c)));
+      ASSERT_TRUE(same_bits(xref,x.col(c)));
+      ASSERT_TRUE(same_bits(yref,gp.pheno(dVec(_x.col(c)))));
+    }
+}
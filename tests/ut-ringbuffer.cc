@@ -0,0 +1,145 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+using namespace libcmaes;
+
+FitFunc fsphere = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+TEST(ringbuffer,push_back)
+{
+  RingBuffer<double> r(3);
+  ASSERT_TRUE(r.empty());
+  for (int i=0;i<5;i++)
+    r.push_back(i);
+  ASSERT_EQ(3,r.size());
+  ASSERT_EQ(2.0,r.front());
+  ASSERT_EQ(4.0,r.back());
+  ASSERT_EQ(3.0,r[1]);
+  r.clear();
+  ASSERT_TRUE(r.empty());
+  ASSERT_EQ(3,r.capacity());
+
+  RingBuffer<double> n;
+  n.push_back(1.0);
+  ASSERT_TRUE(n.empty());
+}
+
+TEST(ringbuffer,set_capacity)
+{
+  RingBuffer<double> r(4);
+  for (int i=0;i<6;i++)
+    r.push_back(i);
+  r.set_capacity(6); // grows, keeps values in order.
+  ASSERT_EQ(4,r.size());
+  for (int i=0;i<4;i++)
+    ASSERT_EQ(i+2.0,r[i]);
+  r.push_back(6);
+  r.push_back(7);
+  r.push_back(8);
+  ASSERT_EQ(6,r.size());
+  ASSERT_EQ(3.0,r.front());
+  r.set_capacity(2); // shrinks, keeps the newest values.
+  ASSERT_EQ(2,r.size());
+  ASSERT_EQ(7.0,r.front());
+  ASSERT_EQ(8.0,r.back());
+}
+
+TEST(ringbuffer,window_extrema)
+{
+  // against a scan of the window, with repeated values.
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> dist(0,9);
+  std::vector<double> series;
+  WindowExtrema we(7);
+  for (int t=0;t<200;t++)
+    {
+      series.push_back(dist(gen));
+      we.push_back(series.back());
+      int w = std::min(7,t+1);
+      ASSERT_EQ(w,we.size());
+      ASSERT_EQ(*std::min_element(series.end()-w,series.end()),we.min());
+      ASSERT_EQ(*std::max_element(series.end()-w,series.end()),we.max());
+    }
+  we.clear();
+  ASSERT_EQ(0,we.size());
+}
+
+TEST(ringbuffer,sorted_window)
+{
+  // median of the last 20 values, against a sort of the window.
+  std::mt19937 gen(1234);
+  std::normal_distribution<double> dist(0.0,1.0);
+  RingBuffer<double> r(20);
+  SortedWindow sw(20);
+  for (int t=0;t<200;t++)
+    {
+      double v = t % 10 == 0 ? 0.5 : dist(gen);
+      if (r.size() == r.capacity())
+	sw.erase(r.front());
+      r.push_back(v);
+      sw.insert(v);
+      std::vector<double> sorted;
+      for (int i=0;i<r.size();i++)
+	sorted.push_back(r[i]);
+      std::sort(sorted.begin(),sorted.end());
+      size_t size = sorted.size();
+      double median = size % 2 == 0 ? (sorted[size/2-1] + sorted[size/2]) / 2 : sorted[size/2];
+      ASSERT_EQ(r.size(),sw.size());
+      ASSERT_EQ(median,sw.median());
+    }
+}
+
+TEST(ringbuffer,history)
+{
+  int dim = 20;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_max_iter(200);
+  cmaparams.set_max_hist(40);
+  CMASolutions cmasols = cmaes<>(fsphere,cmaparams);
+  ASSERT_TRUE(cmasols.best_candidates_hist().empty());
+  ASSERT_EQ(dim,static_cast<int>(cmasols.best_candidate().get_x_size()));
+  ASSERT_EQ(fsphere(cmasols.best_candidate().get_x_ptr(),dim),cmasols.best_candidate().get_fvalue());
+
+  // full history, same run.
+  cmaparams.set_full_hist(true);
+  CMASolutions fcmasols = cmaes<>(fsphere,cmaparams);
+  const RingBuffer<Candidate> &hist = fcmasols.best_candidates_hist();
+  ASSERT_EQ(40,hist.size());
+  ASSERT_EQ(cmasols.niter(),fcmasols.niter());
+  ASSERT_EQ(cmasols.best_candidate().get_fvalue(),hist.back().get_fvalue());
+  ASSERT_TRUE(cmasols.best_candidate().get_x_dvec() == hist.back().get_x_dvec());
+  for (int i=0;i<hist.size();i++)
+    ASSERT_EQ(dim,static_cast<int>(hist[i].get_x_size()));
+}
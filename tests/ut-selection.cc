@@ -0,0 +1,103 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <iostream>
+
+using namespace libcmaes;
+
+// fills the candidates with shuffled f-values, including ties and NaNs, and returns them sorted.
+std::vector<double> fill_candidates(CMASolutions &cmasols, const int &lambda)
+{
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> dist(0,lambda/2);
+  std::vector<double> fvalues;
+  for (int i=0;i<lambda;i++)
+    {
+      double f = (i % 17 == 3) ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(dist(gen));
+      cmasols.get_candidate(i).set_fvalue(f);
+      cmasols.get_candidate(i).set_id(i);
+      if (!std::isnan(f))
+	fvalues.push_back(f);
+    }
+  std::sort(fvalues.begin(),fvalues.end());
+  while ((int)fvalues.size() < lambda)
+    fvalues.push_back(std::numeric_limits<double>::quiet_NaN());
+  return fvalues;
+}
+
+bool same_fvalue(const double &f1, const double &f2)
+{
+  return f1 == f2 || (std::isnan(f1) && std::isnan(f2));
+}
+
+TEST(selection,sort_nan_worst)
+{
+  int dim = 3;
+  int lambda = 100;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,1.0,lambda);
+  CMASolutions cmasols(cmaparams);
+  std::vector<double> fvalues = fill_candidates(cmasols,lambda);
+  cmasols.sort_candidates();
+  for (int i=0;i<lambda;i++)
+    {
+      ASSERT_TRUE(same_fvalue(fvalues.at(i),cmasols.get_candidate(i).get_fvalue()));
+      if (i > 0 && same_fvalue(fvalues.at(i-1),fvalues.at(i))) // ties keep their order.
+	ASSERT_LT(cmasols.get_candidate(i-1).get_id(),cmasols.get_candidate(i).get_id());
+    }
+}
+
+TEST(selection,partial_selection)
+{
+  int dim = 3;
+  int lambda = 1000;
+  int ntop = 20;
+  int nbottom = 30;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,1.0,lambda);
+  CMASolutions cmasols(cmaparams);
+  std::vector<double> fvalues = fill_candidates(cmasols,lambda);
+  CMASolutions sorted = cmasols;
+  sorted.sort_candidates();
+  std::vector<int> ranks = {700,100,101,450};
+  cmasols.select_candidates(ntop,nbottom,ranks);
+
+  // selected ranks match the full sort, including its tie-breaking.
+  for (int i=0;i<lambda;i++)
+    {
+      bool placed = i < ntop || i >= lambda-nbottom || i == lambda/2 || i == lambda/2-1
+	|| std::find(ranks.begin(),ranks.end(),i) != ranks.end();
+      if (placed)
+	{
+	  ASSERT_TRUE(same_fvalue(fvalues.at(i),cmasols.get_candidate(i).get_fvalue()));
+	  ASSERT_EQ(sorted.get_candidate(i).get_id(),cmasols.get_candidate(i).get_id());
+	}
+    }
+
+  // others are partitioned around the selected ranks.
+  for (int i=ntop;i<100;i++)
+    ASSERT_LE(cmasols.get_candidate(i).get_fvalue(),fvalues.at(100));
+}
@@ -0,0 +1,72 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+typedef GenoPheno<NoBoundStrategy> GP;
+
+TEST(stopcriteria,criterion_active)
+{
+  StopCriteria<GP> sc([](const CMAParameters<GP>&, const CMASolutions&){ return MAXITER; });
+  ASSERT_TRUE(sc.active());
+  sc.set_active(false);
+  ASSERT_FALSE(sc.active());
+
+  // a criterion of a set reads and writes its bit of the set's mask.
+  StopCriteriaMask mask;
+  sc._mask = &mask;
+  sc._bit = 3;
+  ASSERT_FALSE(sc.active());
+  sc.set_active(true);
+  ASSERT_TRUE(mask[3]);
+  ASSERT_EQ(1u,mask.count());
+}
+
+TEST(stopcriteria,set_criteria_active)
+{
+  std::vector<double> x0(5,1.0);
+  CMAParameters<GP> cmaparams(x0,0.5);
+  cmaparams.set_quiet(true);
+  cmaparams.set_max_iter(0);
+  CMASolutions cmasols(cmaparams);
+
+  // only the iteration budget is tested, the solutions are not initialized.
+  CMAStopCriteria<GP> scriteria;
+  for (int c: {AUTOMAXITER,TOLHISTFUN,EQUALFUNVALS,TOLX,TOLUPSIGMA,STAGNATION,CONDITIONCOV,NOEFFECTAXIS,NOEFFECTCOOR,MAXFEVALS,FTARGET})
+    ASSERT_EQ(0,scriteria.set_criteria_active(c,false));
+  ASSERT_EQ(MAXITER,scriteria.stop(cmaparams,cmasols));
+  ASSERT_EQ(1,scriteria.set_criteria_active(CONT,false));
+
+  // copies hold their own set of active criteria.
+  CMAStopCriteria<GP> cscriteria(scriteria);
+  ASSERT_EQ(0,cscriteria.set_criteria_active(MAXITER,false));
+  ASSERT_EQ(CONT,cscriteria.stop(cmaparams,cmasols));
+  ASSERT_EQ(MAXITER,scriteria.stop(cmaparams,cmasols));
+  scriteria = cscriteria;
+  ASSERT_EQ(CONT,scriteria.stop(cmaparams,cmasols));
+  scriteria.set_criteria_active(MAXITER,true);
+  ASSERT_EQ(MAXITER,scriteria.stop(cmaparams,cmasols));
+  ASSERT_EQ(CONT,cscriteria.stop(cmaparams,cmasols));
+}
@@ -0,0 +1,109 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace libcmaes;
+
+FitFunc fsphere = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N;i++)
+    val += x[i]*x[i];
+  return val;
+};
+
+FitFunc rosenbrock = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*pow((x[i+1]-x[i]*x[i]),2) + pow((x[i]-1.0),2);
+  return val;
+};
+
+// runs a few generations so that the low-rank factors are non trivial.
+CMASolutions vkd_solutions(const int &dim, const int &niter)
+{
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.5,-1,1234);
+  cmaparams.set_str_algo("vkdcma");
+  cmaparams.set_quiet(true);
+  ESOptimizer<CMAStrategy<VkDCMAUpdate>,CMAParameters<>> optim(rosenbrock,cmaparams);
+  for (int i=0;i<niter;i++)
+    {
+      dMat candidates = optim.ask();
+      optim.eval(candidates);
+      optim.tell();
+      optim.inc_iter();
+    }
+  return optim.get_solutions();
+}
+
+TEST(vkdcmaupdate,transforms)
+{
+  int dim = 30;
+  CMASolutions cmasols = vkd_solutions(dim,50);
+  dMat T = dMat::Identity(dim,dim);
+  VkDCMAUpdate::sqrt_transform(cmasols,T);
+  ASSERT_TRUE(T.isApprox(T.transpose(),1e-12));
+  dMat Tinv = T;
+  VkDCMAUpdate::sqrt_transform(cmasols,Tinv,true);
+  ASSERT_TRUE(Tinv.isApprox(dMat::Identity(dim,dim),1e-10));
+  dMat C = VkDCMAUpdate::full_cov(cmasols);
+  dVec d = C.diagonal().cwiseQuotient((T*T).diagonal()).cwiseSqrt();
+  ASSERT_TRUE(C.isApprox(d.asDiagonal()*T*T*d.asDiagonal(),1e-10));
+  ASSERT_TRUE(VkDCMAUpdate::cov_diagonal(cmasols).isApprox(C.diagonal(),1e-10));
+  ASSERT_NEAR(C(2,7)/std::sqrt(C(2,2)*C(7,7)),cmasols.corr(2,7),1e-10);
+}
+
+TEST(vkdcmaupdate,linear_memory)
+{
+  int dim = 5000;
+  CMASolutions cmasols = vkd_solutions(dim,5);
+  ASSERT_EQ(0,cmasols.cov().size());
+  ASSERT_EQ(dim,cmasols.sepcov().rows());
+}
+
+TEST(vkdcmaupdate,optimize_sphere)
+{
+  int dim = 200;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_algo(VKD_CMAES);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-8);
+  CMASolutions cmasols = cmaes<>(fsphere,cmaparams);
+  ASSERT_EQ(FTARGET,cmasols.run_status());
+}
+
+TEST(vkdcmaupdate,optimize_rosenbrock)
+{
+  int dim = 30;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_algo(VKD_CMAES);
+  cmaparams.set_quiet(true);
+  cmaparams.set_ftarget(1e-8);
+  CMASolutions cmasols = cmaes<>(rosenbrock,cmaparams);
+  ASSERT_EQ(FTARGET,cmasols.run_status());
+}
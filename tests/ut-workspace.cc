@@ -0,0 +1,311 @@
+/**
+ * CMA-ES, Covariance Matrix Adaptation Evolution Strategy
+ * Copyright (c) 2014 Inria
+ * Author: Emmanuel Benazera <emmanuel.benazera@lri.fr>
+ *
+ * This file is part of libcmaes.
+ *
+ * libcmaes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libcmaes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcmaes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libcmaes/cmaes.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <iostream>
+
+using namespace libcmaes;
+
+// counting allocator hook: every allocation is counted while enabled. Eigen
+// matrices are allocated through malloc, so that is what is replaced when
+// possible, operator new otherwise.
+static std::atomic<bool> count_allocs(false);
+static std::atomic<long> nallocs(0);
+
+#if defined(__GLIBC__)
+extern "C"
+{
+  void* __libc_malloc(std::size_t size);
+  void* __libc_calloc(std::size_t n, std::size_t size);
+  void* __libc_realloc(void *p, std::size_t size);
+
+  void* malloc(std::size_t size)
+  {
+    if (count_allocs)
+      ++nallocs;
+    return __libc_malloc(size);
+  }
+
+  void* calloc(std::size_t n, std::size_t size)
+  {
+    if (count_allocs)
+      ++nallocs;
+    return __libc_calloc(n,size);
+  }
+
+  void* realloc(void *p, std::size_t size)
+  {
+    if (count_allocs)
+      ++nallocs;
+    return __libc_realloc(p,size);
+  }
+}
+#else
+void* operator new(std::size_t size)
+{
+  if (count_allocs)
+    ++nallocs;
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete[](void *p) noexcept
+{
+  operator delete(p);
+}
+#endif
+
+FitFunc rosenbrock = [](const double *x, const int N)
+{
+  double val = 0.0;
+  for (int i=0;i<N-1;i++)
+    val += 100.0*(x[i+1]-x[i]*x[i])*(x[i+1]-x[i]*x[i]) + (1.0-x[i])*(1.0-x[i]);
+  return val;
+};
+
+// allocations of 100 steady state generations of the ask / eval / tell loop.
+template <class TCovarianceUpdate>
+long steady_state_allocs()
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_quiet(true);
+  ESOptimizer<CMAStrategy<TCovarianceUpdate>,CMAParameters<>> optim(rosenbrock,cmaparams);
+
+  // the first generations fill the history windows, that have a fixed size.
+  for (int i=0;i<300;i++)
+    {
+      const dMat &candidates = optim.ask();
+      optim.eval(candidates);
+      optim.tell();
+      optim.inc_iter();
+    }
+
+  nallocs = 0;
+  count_allocs = true;
+  for (int i=0;i<100;i++)
+    {
+      const dMat &candidates = optim.ask();
+      optim.eval(candidates);
+      optim.tell();
+      optim.inc_iter();
+    }
+  count_allocs = false;
+  EXPECT_EQ(400,optim.get_solutions().niter());
+  return nallocs;
+}
+
+TEST(workspace,zero_alloc_ask_tell)
+{
+  // steady state: the ask / eval / tell loop performs no heap allocation.
+  ASSERT_EQ(0,steady_state_allocs<CovarianceUpdate>());
+}
+
+TEST(workspace,zero_alloc_ask_tell_acma)
+{
+  ASSERT_EQ(0,steady_state_allocs<ACovarianceUpdate>());
+}
+
+TEST(workspace,optimize_population)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_max_iter(100);
+  ESOptimizer<CMAStrategy<CovarianceUpdate>,CMAParameters<>> optim(rosenbrock,cmaparams);
+
+  // the optimize() loop hands the population of the workspace to the evaluation, not a copy.
+  const dMat *pop = nullptr;
+  int ngens = 0, nviews = 0;
+  optim.CMAStrategy<CovarianceUpdate>::optimize([&](const dMat &candidates, const dMat &phenocandidates)
+						 {
+						   ++ngens;
+						   if (&candidates == pop && &phenocandidates == pop)
+						     ++nviews;
+						   optim.eval(candidates,phenocandidates);
+						 },
+						 population_askfunc([&]() -> const dMat&
+								    {
+								      pop = &optim.ask();
+								      return *pop;
+								    }),
+						 std::bind(&CMAStrategy<CovarianceUpdate>::tell,&optim));
+  ASSERT_EQ(100,ngens);
+  ASSERT_EQ(ngens,nviews);
+  ASSERT_EQ(MAXITER,optim.get_solutions().run_status());
+}
+
+TEST(workspace,optimize_custom_ask)
+{
+  int dim = 10;
+  std::vector<double> x0(dim,0.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_quiet(true);
+  cmaparams.set_max_iter(100);
+  ESOptimizer<CMAStrategy<CovarianceUpdate>,CMAParameters<>> optim(rosenbrock,cmaparams);
+
+  // a custom ask function returns its candidates by value, that outlive their evaluation.
+  const dMat *pop = nullptr;
+  int ngens = 0, ncopies = 0;
+  optim.CMAStrategy<CovarianceUpdate>::optimize([&](const dMat &candidates, const dMat &phenocandidates)
+						 {
+						   ++ngens;
+						   if (&candidates != pop && candidates == *pop)
+						     ++ncopies;
+						   optim.eval(candidates,phenocandidates);
+						 },
+						 [&]() -> dMat
+						 {
+						   pop = &optim.ask();
+						   dMat candidates = *pop;
+						   return candidates;
+						 },
+						 std::bind(&CMAStrategy<CovarianceUpdate>::tell,&optim));
+  ASSERT_EQ(100,ngens);
+  ASSERT_EQ(ngens,ncopies);
+  ASSERT_EQ(MAXITER,optim.get_solutions().run_status());
+}
+
+TEST(workspace,population_views)
+{
+  int dim = 5;
+  std::vector<double> x0(dim,1.0);
+  CMAParameters<> cmaparams(x0,0.1,-1,1234);
+  cmaparams.set_quiet(true);
+  ESOptimizer<CMAStrategy<CovarianceUpdate>,CMAParameters<>> optim(rosenbrock,cmaparams);
+  const dMat &candidates = optim.ask();
+  optim.eval(candidates);
+  optim.tell();
+
+  // ranked candidates are views onto the columns they were evaluated from.
+  CMASolutions &sols = optim.get_solutions();
+  for (int i=0;i<sols.size();i++)
+    {
+      Candidate &c = sols.get_candidate(i);
+      ASSERT_TRUE(c.is_view());
+      ASSERT_EQ(sols.population().col(c.get_id()).data(),c.get_x_ptr());
+      ASSERT_EQ(candidates.col(c.get_id()),c.get_x_dvec());
+      if (i > 0)
+	ASSERT_LE(sols.get_candidate(i-1).get_fvalue(),c.get_fvalue());
+    }
+
+  // copies own their vector, and survive the next generation.
+  Candidate best = sols.get_candidate(0);
+  dVec bx = best.get_x_dvec();
+  ASSERT_FALSE(best.is_view());
+  optim.inc_iter();
+  const dMat &ncandidates = optim.ask();
+  optim.eval(ncandidates);
+  ASSERT_EQ(bx,best.get_x_dvec());
+  ASSERT_EQ(bx,sols.get_best_seen_candidate().get_x_dvec());
+}
+
+TEST(workspace,candidate_dvec_ref)
+{
+  dMat pop = dMat::Random(5,3);
+  Candidate c;
+  c.bind_x(pop.col(1).data(),5);
+  ASSERT_EQ(pop.col(1).data(),c.get_x_map().data());
+
+  // the reference API detaches the view, that keeps its values.
+  dVec &x = c.get_x_dvec_ref();
+  ASSERT_FALSE(c.is_view());
+  ASSERT_TRUE(x == pop.col(1));
+  x[0] = 42.0;
+  ASSERT_EQ(42.0,c.get_x_dvec()[0]);
+  ASSERT_NE(42.0,pop(0,1));
+
+  // and the vector can be resized through it.
+  c.get_x_dvec_ref() = dVec::Constant(8,2.0);
+  ASSERT_EQ(8,c.get_x_size());
+  ASSERT_EQ(2.0,c.get_x_ptr()[7]);
+  Candidate cc = c;
+  ASSERT_TRUE(cc.get_x_dvec() == dVec::Constant(8,2.0));
+}
+
+TEST(workspace,pheno_buffer)
+{
+  int dim = 10, lambda = 20;
+  dMat candidates = 3.0 * dMat::Random(dim,lambda);
+  dMat ncandidates;
+
+  // identity: the candidates stand for their pheno transform, without a copy.
+  GenoPheno<> gp;
+  nallocs = 0;
+  count_allocs = true;
+  const dMat &idcandidates = gp.pheno(candidates,ncandidates);
+  count_allocs = false;
+  ASSERT_EQ(0,nallocs);
+  ASSERT_EQ(&candidates,&idcandidates);
+  ASSERT_EQ(0,ncandidates.size());
+
+  // custom transform, bounds and scaling, fused into the buffer.
+  TransFunc genof = [](const double *in, double *ext, const int &dim)
+    {
+      for (int i=0;i<dim;i++)
+	ext[i] = in[i] / 2.0;
+    };
+  TransFunc phenof = [](const double *in, double *ext, const int &dim)
+    {
+      for (int i=0;i<dim;i++)
+	ext[i] = 2.0 * in[i];
+    };
+  std::vector<double> lbounds(dim,-2.0), ubounds(dim,1.5);
+  GenoPheno<pwqBoundStrategy,linScalingStrategy> bgp(genof,phenof,&lbounds.front(),&ubounds.front(),dim);
+  const dMat &pcandidates = bgp.pheno(candidates,ncandidates);
+  ASSERT_EQ(&ncandidates,&pcandidates);
+  for (int r=0;r<lambda;r++)
+    {
+      dVec x(dim), y, z;
+      phenof(candidates.col(r).data(),x.data(),dim);
+      bgp.get_boundstrategy().to_f_representation(x,y);
+      bgp.get_scalingstrategy().scale_to_f(y,z);
+      ASSERT_TRUE(z == ncandidates.col(r));
+      ASSERT_TRUE(z == bgp.pheno(dVec(candidates.col(r))));
+    }
+  ASSERT_TRUE(ncandidates == bgp.pheno(candidates));
+
+  // the buffer is reused.
+  const double *data = ncandidates.data();
+  nallocs = 0;
+  count_allocs = true;
+  bgp.pheno(candidates,ncandidates);
+  count_allocs = false;
+  ASSERT_EQ(0,nallocs);
+  ASSERT_EQ(data,ncandidates.data());
+}